@@ -11,6 +11,7 @@ import re
 import subprocess
 import sys
 import tempfile
+import time
 import zipfile
 from pathlib import Path
 
@@ -59,8 +60,8 @@ def extract_image_number(filename: str) -> int | None:
     return int(match.group(1)) if match else None
 
 
-def run_speedreader(image_paths: list[Path], output_file: Path) -> None:
-    """Run SpeedReader on images and write JSON Lines output to file."""
+def run_speedreader(image_paths: list[Path], output_file: Path) -> float:
+    """Run SpeedReader on images and write JSON Lines output to file. Returns images per second."""
     cmd = ["dotnet", "run", "--project", str(REPO_ROOT / "src" / "Frontend"), "--"]
     cmd.extend(str(p) for p in image_paths)
 
@@ -76,6 +77,9 @@ def run_speedreader(image_paths: list[Path], output_file: Path) -> None:
         # Read stdout line by line, write JSON Lines
         buffer = ""
         results_written = 0
+        # Timed from the first result to the last so build and model load time don't count
+        first_result_time = None
+        last_result_time = None
         pbar = tqdm(total=len(image_paths), desc="Running OCR", unit="img",
                     dynamic_ncols=False, ncols=80, mininterval=1.0)
 
@@ -100,6 +104,9 @@ def run_speedreader(image_paths: list[Path], output_file: Path) -> None:
                 f.flush()
                 buffer = ""
                 results_written += 1
+                last_result_time = time.perf_counter()
+                if first_result_time is None:
+                    first_result_time = last_result_time
                 pbar.update(1)
             except json.JSONDecodeError:
                 # Incomplete JSON, keep buffering
@@ -112,6 +119,10 @@ def run_speedreader(image_paths: list[Path], output_file: Path) -> None:
             stderr = process.stderr.read()
             raise RuntimeError(f"SpeedReader failed: {stderr}")
 
+    if results_written < 2 or last_result_time == first_result_time:
+        return 0.0
+    return (results_written - 1) / (last_result_time - first_result_time)
+
 
 def parse_results(jsonl_file: Path) -> dict[int, list[dict]]:
     """Parse JSON Lines file and return dict mapping image number to detections."""
@@ -136,6 +147,7 @@ def parse_results(jsonl_file: Path) -> dict[int, list[dict]]:
                     corners = rotated_rect_to_corners(rotated_rect)
                     detections.append({
                         "corners": corners,
+                        "text": result.get("text", ""),
                         "confidence": result.get("confidence", 0.0)
                     })
 
@@ -187,6 +199,34 @@ def run_evaluation(gt_path: Path, submission_path: Path) -> dict:
     return results
 
 
+def word_accuracy(gt_path: Path, eval_results: dict, results: dict[int, list[dict]]) -> float:
+    """Fraction of matched detections whose text equals the GT transcription, ignoring case."""
+    sys.path.insert(0, str(SCRIPT_DIR))
+    import evaluation
+    import rrc_evaluation_funcs
+
+    eval_params = evaluation.default_evaluation_params()
+    gt = rrc_evaluation_funcs.load_zip_file(str(gt_path), eval_params["GT_SAMPLE_NAME_2_ID"])
+
+    matched = 0
+    correct = 0
+    for sample_id, sample in eval_results.get("per_sample", {}).items():
+        # Same parse as the evaluation, so GT indices in the pairs line up
+        gt_contents = rrc_evaluation_funcs.decode_utf8(gt[sample_id])
+        _, _, transcriptions = rrc_evaluation_funcs.get_tl_line_values_from_file_contents(
+            gt_contents, eval_params["CRLF"], eval_params["LTRB"], True, False)
+        detections = results.get(int(sample_id), [])
+        for pair in sample["pairs"]:
+            expected = transcriptions[pair["gt"]]
+            if expected == "###":
+                continue
+            matched += 1
+            if detections[pair["det"]]["text"].lower() == expected.lower():
+                correct += 1
+
+    return correct / matched if matched else 0.0
+
+
 @click.command()
 @click.option("--test-dir", type=click.Path(exists=True, path_type=Path), default=TEST_DIR,
               help="Directory containing test images")
@@ -196,7 +236,10 @@ def run_evaluation(gt_path: Path, submission_path: Path) -> dict:
               help="Output directory for results (default: temp dir)")
 @click.option("--keep-output", is_flag=True, help="Keep output files after evaluation")
 @click.option("--limit", type=int, default=None, help="Limit to first N images (for testing)")
-def main(test_dir: Path, gt: Path, output: Path | None, keep_output: bool, limit: int | None):
+@click.option("--json", "json_output", type=click.Path(path_type=Path), default=None,
+              help="Also write the results as JSON")
+def main(test_dir: Path, gt: Path, output: Path | None, keep_output: bool, limit: int | None,
+         json_output: Path | None):
     """Run ICDAR 2015 text detection benchmark on SpeedReader."""
 
     # Find test images
@@ -215,13 +258,21 @@ def main(test_dir: Path, gt: Path, output: Path | None, keep_output: bool, limit
         output = Path(tempfile.mkdtemp(prefix="icdar2015_"))
     output.mkdir(parents=True, exist_ok=True)
 
+    image_numbers = [extract_image_number(p.name) for p in image_paths]
+    if limit is not None:
+        # Create filtered GT for partial evaluation
+        gt_path = output / "gt_filtered.zip"
+        create_filtered_gt_zip(gt, gt_path, image_numbers)
+    else:
+        gt_path = gt
+
     jsonl_file = output / "results.jsonl"
     submission_zip = output / "submit.zip"
 
     try:
         # Run SpeedReader
         click.echo("Running SpeedReader...")
-        run_speedreader(image_paths, jsonl_file)
+        images_per_second = run_speedreader(image_paths, jsonl_file)
 
         # Parse results
         click.echo("Parsing results...")
@@ -230,28 +281,31 @@ def main(test_dir: Path, gt: Path, output: Path | None, keep_output: bool, limit
 
         # Create submission
         click.echo("Creating submission zip...")
-        image_numbers = [extract_image_number(p.name) for p in image_paths]
         create_submission_zip(results, submission_zip, image_numbers)
 
         # Run evaluation
         click.echo("Running evaluation...")
-        if limit is not None:
-            # Create filtered GT for partial evaluation
-            filtered_gt = output / "gt_filtered.zip"
-            create_filtered_gt_zip(gt, filtered_gt, image_numbers)
-            eval_results = run_evaluation(filtered_gt, submission_zip)
-        else:
-            eval_results = run_evaluation(gt, submission_zip)
-
-        # Print results
+        eval_results = run_evaluation(gt_path, submission_zip)
+
         method = eval_results.get("method", {})
-        click.echo("\n" + "=" * 50)
-        click.echo("ICDAR 2015 Text Detection Results")
-        click.echo("=" * 50)
-        click.echo(f"Precision: {method.get('precision', 0):.4f}")
-        click.echo(f"Recall:    {method.get('recall', 0):.4f}")
-        click.echo(f"H-mean:    {method.get('hmean', 0):.4f}")
-        click.echo("=" * 50)
+        row = {
+            "precision": method.get("precision", 0),
+            "recall": method.get("recall", 0),
+            "hmean": method.get("hmean", 0),
+            "word_accuracy": word_accuracy(gt_path, eval_results, results),
+            "images_per_second": images_per_second,
+        }
+
+        # Print results as a markdown table
+        click.echo("\nICDAR 2015 Results\n")
+        click.echo("| Precision | Recall | H-mean | Word accuracy | Images/s |")
+        click.echo("|-----------|--------|--------|---------------|----------|")
+        click.echo(f"| {row['precision']:.4f} | {row['recall']:.4f} | {row['hmean']:.4f} "
+                   f"| {row['word_accuracy']:.4f} | {row['images_per_second']:.1f} |")
+
+        if json_output is not None:
+            json_output.write_text(json.dumps(row, indent=2) + "\n")
+            click.echo(f"\nResults written to: {json_output}")
 
         if keep_output:
             click.echo(f"\nOutput files saved to: {output}")
@@ -204,6 +204,37 @@ public class ApiE2ETests : IClassFixture<ServerFixture>
         Assert.Contains("bar", thirdAllText.ToLower());
     }
 
+    [Fact]
+    public async Task MultipleImageUpload_AcceptNdjson_StreamsOneLinePerImage()
+    {
+        using var helloImage = CreateImageWithText("hello");
+        using var worldImage = CreateImageWithText("world");
+
+        using var content = new MultipartFormDataContent
+        {
+            { new ByteArrayContent(await SaveImageToBytes(helloImage)), "images", "hello.png" },
+            { new ByteArrayContent(await SaveImageToBytes(worldImage)), "images", "world.png" }
+        };
+        using var request = new HttpRequestMessage(HttpMethod.Post, "/api/ocr") { Content = content };
+        request.Headers.Accept.ParseAdd("application/x-ndjson");
+
+        var response = await _httpClient.SendAsync(request, HttpCompletionOption.ResponseHeadersRead);
+
+        response.EnsureSuccessStatusCode();
+        Assert.Equal("application/x-ndjson", response.Content.Headers.ContentType?.MediaType);
+
+        // Results arrive in upload order, one JSON object per line
+        var responseBody = await response.Content.ReadAsStringAsync();
+        var lines = responseBody.Split('\n', StringSplitOptions.RemoveEmptyEntries);
+        Assert.Equal(2, lines.Length);
+
+        var texts = lines.Select(line => string.Join(" ", JsonDocument.Parse(line).RootElement
+            .GetProperty("results").EnumerateArray()
+            .Select(tr => tr.GetProperty("text").GetString() ?? "")).ToLower()).ToList();
+        Assert.Contains("hello", texts[0]);
+        Assert.Contains("world", texts[1]);
+    }
+
     [Fact]
     public async Task InvalidImageFormat_Returns400()
     {
@@ -31,11 +31,40 @@ public class Commands
             name: "--viz",
             description: "Generate visualization files");
 
+        var modelCacheOption = new Option<DirectoryInfo?>(
+            name: "--model-cache",
+            description: "Directory to cache optimized models in, makes later startups faster");
+
+        var resultCacheOption = new Option<int>(
+            name: "--result-cache",
+            getDefaultValue: () => 0,
+            description: "Server only: remember results for this many images, so repeat uploads skip OCR. 0 disables");
+
+        var resultCacheDirOption = new Option<DirectoryInfo?>(
+            name: "--result-cache-dir",
+            description: "Server only: also keep cached results on disk in this directory, so they survive restarts");
+
+        var workerOption = new Option<Uri[]>(
+            name: "--worker",
+            getDefaultValue: () => [],
+            description: "Run inference on this SpeedReader server instead of locally, e.g. http://worker-1:5000. " +
+                "Repeat to shard across several");
+
+        var workerModeOption = new Option<bool>(
+            name: "--worker-mode",
+            description: "Server only: also run inference for coordinators started with --worker. Don't expose to " +
+                "untrusted clients");
+
         rootCommand.AddArgument(inputArgument);
         rootCommand.AddOption(serveOption);
         rootCommand.AddOption(vizOption);
+        rootCommand.AddOption(modelCacheOption);
+        rootCommand.AddOption(resultCacheOption);
+        rootCommand.AddOption(resultCacheDirOption);
+        rootCommand.AddOption(workerOption);
+        rootCommand.AddOption(workerModeOption);
 
-        rootCommand.SetHandler(async (inputs, serve, viz) =>
+        rootCommand.SetHandler(async (inputs, serve, viz, modelCache, resultCache, resultCacheDir, workers, workerMode) =>
         {
             // Validate arguments
             if (serve && (inputs.Length > 0 || viz))
@@ -44,9 +73,32 @@ public class Commands
                 Environment.Exit(1);
             }
 
+            if (!serve && (resultCache != 0 || resultCacheDir != null))
+            {
+                Console.Error.WriteLine("Error: --result-cache and --result-cache-dir require --serve.");
+                Environment.Exit(1);
+            }
+
+            if (resultCache < 0 || (resultCacheDir != null && resultCache == 0))
+            {
+                Console.Error.WriteLine("Error: --result-cache must be positive, and is required by --result-cache-dir.");
+                Environment.Exit(1);
+            }
+
+            if (workerMode && (!serve || workers.Length > 0))
+            {
+                Console.Error.WriteLine("Error: --worker-mode requires --serve and cannot be used with --worker.");
+                Environment.Exit(1);
+            }
+
+            var remoteEngine = workers.Length > 0 ? new RemoteEngineConfig { Workers = workers } : null;
+
             if (serve)
             {
-                await Serve.RunServer();
+                var resultCacheOptions = resultCache > 0
+                    ? new ResultCacheOptions { MaxEntries = resultCache, DiskDirectory = resultCacheDir?.FullName }
+                    : null;
+                await Serve.RunServer(modelCache?.FullName, resultCacheOptions, remoteEngine, workerMode);
             }
             else
             {
@@ -56,14 +108,16 @@ public class Commands
                     Environment.Exit(1);
                 }
 
-                await ProcessFiles(inputs, viz);
+                await ProcessFiles(inputs, viz, modelCache?.FullName, remoteEngine);
             }
-        }, inputArgument, serveOption, vizOption);
+        }, inputArgument, serveOption, vizOption, modelCacheOption, resultCacheOption, resultCacheDirOption,
+            workerOption, workerModeOption);
 
         return rootCommand;
     }
 
-    private static async Task ProcessFiles(FileInfo[] inputs, bool viz)
+    private static async Task ProcessFiles(FileInfo[] inputs, bool viz, string? modelCacheDirectory,
+        RemoteEngineConfig? remoteEngine)
     {
         if (inputs.Length == 0)
             return;
@@ -77,19 +131,19 @@ public class Commands
                 Kernel = new OnnxInferenceKernelOptions(
                     model: Model.DbNet,
                     quantization: Quantization.Int8,
-                    numIntraOpThreads: 4),
-                MaxParallelism = 4,
-                ReservedPCores = [0, 2, 4, 6]
+                    numIntraOpThreads: 4) { ModelCacheDirectory = modelCacheDirectory },
+                MaxParallelism = 4
             },
             RecognitionEngine = new CpuEngineConfig
             {
                 Kernel = new OnnxInferenceKernelOptions(
                     model: Model.Svtr,
                     quantization: Quantization.Fp32,
-                    numIntraOpThreads: 4),
-                MaxParallelism = 4,
-                ReservedPCores = [0, 2, 4, 6]
-            }
+                    numIntraOpThreads: 4) { ModelCacheDirectory = modelCacheDirectory },
+                MaxParallelism = 4
+            },
+            RemoteEngine = remoteEngine,
+            Visualize = viz
         };
 
         var services = new ServiceCollection();
@@ -139,7 +193,7 @@ public class Commands
             }
             finally
             {
-                result.Image.Dispose();
+                result.Image?.Dispose();
                 idx++;
             }
         }
@@ -22,6 +22,7 @@ internal partial class JsonContext : JsonSerializerContext
 }
 
 [JsonSerializable(typeof(OcrJsonResult))]
+[JsonSerializable(typeof(ErrorResponse))]
 [JsonSourceGenerationOptions(
     WriteIndented = false,
     PropertyNamingPolicy = JsonKnownNamingPolicy.CamelCase)]
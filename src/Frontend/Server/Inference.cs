@@ -0,0 +1,166 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using Microsoft.AspNetCore.Http;
+using Microsoft.AspNetCore.Http.Features;
+using Microsoft.Extensions.DependencyInjection;
+using SpeedReader.Ocr;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+using Model = SpeedReader.Ocr.InferenceEngine.Model;
+
+namespace SpeedReader.Frontend.Server;
+
+// What a worker accepts: batches of up to MaxBatchSize items, each item one of the input shapes its pipeline runs the
+// model at
+public record InferenceLimits(int MaxBatchSize, IReadOnlyDictionary<Model, int[][]> ItemShapes)
+{
+    // Version, model and rank bytes plus the largest shape InferenceWire writes
+    private const int MaxHeaderBytes = 3 + 8 * sizeof(int);
+
+    // RemoteEngineConfig caps coordinators' batches at MaxWorkerBatchSize
+    public static InferenceLimits For(OcrPipelineOptions options)
+    {
+        var detection = options.DetectionOptions;
+        var recognition = options.RecognitionOptions;
+        return new InferenceLimits(RemoteEngineConfig.MaxWorkerBatchSize, new Dictionary<Model, int[][]>
+        {
+            [Model.DbNet] = [[3, detection.TileHeight, detection.TileWidth]],
+            [Model.Svtr] = recognition.RecognitionInputWidths
+                .Select(width => new[] { 3, recognition.RecognitionInputHeight, width })
+                .ToArray()
+        });
+    }
+
+    public long MaxRequestBytes => MaxHeaderBytes + (long)MaxBatchSize * ItemShapes.Values
+        .SelectMany(shapes => shapes)
+        .Max(shape => shape.Aggregate(1L, (length, dim) => length * dim) * sizeof(float));
+
+    public bool Accepts(Model model, ReadOnlySpan<int> itemShape)
+    {
+        if (!ItemShapes.TryGetValue(model, out var shapes))
+            return false;
+        foreach (var shape in shapes)
+        {
+            if (itemShape.SequenceEqual(shape))
+                return true;
+        }
+        return false;
+    }
+}
+
+// The worker side of RemoteEngine, only mapped with --worker-mode. Batches are split back into items, so the local
+// engine batches them together with everything else it's running, and the answer carries this server's load for the
+// coordinator to route by
+public static class Inference
+{
+    public static async Task PostInfer(HttpContext context, TensorPool tensorPool, OcrThreadPool threadPool,
+        InferenceLimits limits)
+    {
+        // A full batch of DBNet tiles is past the default 30 MB cap on request bodies, so size the cap to the largest
+        // valid frame instead
+        var maxRequestBytes = limits.MaxRequestBytes;
+        if (context.Features.Get<IHttpMaxRequestBodySizeFeature>() is { IsReadOnly: false } maxBodySize)
+            maxBodySize.MaxRequestBodySize = maxRequestBytes;
+
+        context.Response.ContentType = InferenceWire.MediaType;
+        var frame = await ReadBody(context.Request, maxRequestBytes);
+        if (frame == null)
+        {
+            await WriteError(context.Response, StatusCodes.Status413PayloadTooLarge,
+                $"Request is over the max of {maxRequestBytes} bytes");
+            return;
+        }
+
+        Model model;
+        float[] input;
+        int[] shape;
+        try
+        {
+            (model, input, shape) = InferenceWire.DecodeRequest(frame, tensorPool);
+        }
+        catch (InvalidDataException ex)
+        {
+            await WriteError(context.Response, StatusCodes.Status400BadRequest, ex.Message);
+            return;
+        }
+
+        var engine = context.RequestServices.GetKeyedService<IInferenceEngine>(model);
+        var message = engine == null ? $"{model} is not served here"
+            : shape.Length == 0 || shape[0] < 1 || shape[0] > limits.MaxBatchSize
+                ? $"Expected a batch of 1 to {limits.MaxBatchSize} items"
+            : !limits.Accepts(model, shape.AsSpan(1)) ? $"{model} does not run at [{string.Join(", ", shape[1..])}]"
+            : null;
+        if (message != null)
+        {
+            tensorPool.Return(input);
+            await WriteError(context.Response, StatusCodes.Status400BadRequest, message);
+            return;
+        }
+
+        int[] itemShape = shape[1..];
+        var itemLength = input.Length / shape[0];
+        var items = new float[shape[0]][];
+        for (var i = 0; i < items.Length; i++)
+        {
+            items[i] = tensorPool.Rent(itemLength);
+            input.AsSpan(i * itemLength, itemLength).CopyTo(items[i]);
+        }
+        tensorPool.Return(input);
+
+        var runs = items.Select(item => engine.Run(item, itemShape)).ToArray();
+        try
+        {
+            await Task.WhenAll(runs);
+        }
+        catch (Exception ex)
+        {
+            tensorPool.Return(runs.Where(run => run.IsCompletedSuccessfully).Select(run => run.Result.OutputData));
+            tensorPool.Return(items);
+            await WriteError(context.Response, StatusCodes.Status500InternalServerError, ex.Message);
+            return;
+        }
+        tensorPool.Return(items);
+
+        var outputs = runs.Select(run => run.Result.OutputData).ToArray();
+        var load = new WorkerLoad(threadPool.QueueDepth(model), engine.CurrentMaxCapacity());
+        var response = InferenceWire.EncodeResponse(outputs, runs.Length > 0 ? runs[0].Result.OutputShape : [], load);
+        tensorPool.Return(outputs);
+
+        context.Response.ContentLength = response.Length;
+        await context.Response.Body.WriteAsync(response);
+    }
+
+    private static async Task WriteError(HttpResponse response, int statusCode, string message)
+    {
+        var frame = InferenceWire.EncodeError(message);
+        response.StatusCode = statusCode;
+        response.ContentLength = frame.Length;
+        await response.Body.WriteAsync(frame);
+    }
+
+    // Null if the body is over maxBytes. Content-Length is only a hint, the cap holds for chunked bodies too
+    private static async Task<byte[]?> ReadBody(HttpRequest request, long maxBytes)
+    {
+        if (request.ContentLength > maxBytes)
+            return null;
+
+        using var buffer = new MemoryStream((int)(request.ContentLength ?? 0));
+        var chunk = new byte[81920];
+        try
+        {
+            int read;
+            while ((read = await request.Body.ReadAsync(chunk)) > 0)
+            {
+                if (buffer.Length + read > maxBytes)
+                    return null;
+                buffer.Write(chunk, 0, read);
+            }
+        }
+        catch (BadHttpRequestException ex) when (ex.StatusCode == StatusCodes.Status413PayloadTooLarge)
+        {
+            return null;  // Kestrel enforcing MaxRequestBodySize
+        }
+        return buffer.Length == buffer.Capacity ? buffer.GetBuffer() : buffer.ToArray();
+    }
+}
@@ -1,6 +1,7 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
+using System.Diagnostics;
 using System.Text.Json;
 using Microsoft.AspNetCore.Http;
 using Microsoft.AspNetCore.WebUtilities;
@@ -8,35 +9,46 @@ using SixLabors.ImageSharp;
 using SixLabors.ImageSharp.Formats;
 using SixLabors.ImageSharp.PixelFormats;
 using SpeedReader.Ocr;
+using SpeedReader.Ocr.SmartMetrics;
 
 namespace SpeedReader.Frontend.Server;
 
 public static class Rest
 {
-    public static async Task PostOcr(HttpContext context, OcrPipeline speedReader)
+    private const string JsonLinesMediaType = "application/x-ndjson";
+    private static readonly byte[] NewLine = "\n"u8.ToArray();
+    private static readonly DecoderOptions DecoderOptions = CreateDecoderOptions();
+
+    public static async Task PostOcr(HttpContext context, OcrPipeline speedReader, StageTimings stageTimings)
     {
-        var images = ParseImagesFromRequest(context.Request);
-        var results = speedReader.ReadMany(images);
+        // Only a result cache needs the encoded bytes, to hash them. Without one, uploads are decoded straight off the
+        // request pipe instead of being buffered whole first
+        var results = speedReader.ResultCache != null
+            ? speedReader.ReadMany(ParseImagesFromRequest(context.Request, ReadEncoded))
+            : speedReader.ReadMany(ParseImagesFromRequest(context.Request, Decode));
+
+        // Clients that accept NDJSON get each result as soon as it's ready instead of one array at the end
+        if (context.Request.Headers.Accept.Any(accept => accept?.Contains(JsonLinesMediaType) == true))
+        {
+            await StreamJsonLines(context.Response, results, stageTimings);
+            return;
+        }
 
         var ocrResults = new List<OcrJsonResult>();
+        var serializing = TimeSpan.Zero;
         await foreach (var resultWrapper in results)
         {
-            var result = resultWrapper.Value();
+            var result = Value(resultWrapper);
             try
             {
-                var jsonResult = new OcrJsonResult(
-                    Filename: null,
-                    Results: result.Results.Select(r => new OcrTextResult(
-                        BoundingBox: r.BBox,
-                        Text: r.Text,
-                        Confidence: r.Confidence
-                    )).ToList()
-                );
-                ocrResults.Add(jsonResult);
+                var start = stageTimings.Start();
+                ocrResults.Add(ToJsonResult(result));
+                if (start != 0)
+                    serializing += Stopwatch.GetElapsedTime(start);
             }
             finally
             {
-                result.Image.Dispose();
+                result.Image?.Dispose();
             }
         }
 
@@ -47,18 +59,81 @@ public static class Rest
 
         // Return JSON response
         context.Response.ContentType = "application/json";
+        var serializeStart = stageTimings.Start();
         var json = JsonSerializer.Serialize(ocrResults, JsonContext.Default.ListOcrJsonResult);
+        if (serializeStart != 0)
+            stageTimings.Record(PipelineStage.Serialize, serializing + Stopwatch.GetElapsedTime(serializeStart));
         await context.Response.WriteAsync(json);
     }
 
-    private static async IAsyncEnumerable<Image<Rgb24>> ParseImagesFromRequest(HttpRequest request)
+    // One line per image, in upload order, flushed as it's written. Nothing is held once its line is out. Each line is
+    // timed on its own, up to the flush
+    private static async Task StreamJsonLines(HttpResponse response,
+        IAsyncEnumerable<Result<OcrPipelineResult>> results, StageTimings stageTimings)
     {
-        var contentType = request.ContentType ?? "";
+        var count = 0;
+        try
+        {
+            await foreach (var resultWrapper in results)
+            {
+                var result = Value(resultWrapper);
+                try
+                {
+                    if (count++ == 0)
+                        response.ContentType = JsonLinesMediaType;
+                    var start = stageTimings.Start();
+                    await JsonSerializer.SerializeAsync(response.Body, ToJsonResult(result), JsonLinesContext.Default.OcrJsonResult);
+                    await response.Body.WriteAsync(NewLine);
+                    stageTimings.Record(PipelineStage.Serialize, start);
+                    await response.Body.FlushAsync();
+                }
+                finally
+                {
+                    result.Image?.Dispose();
+                }
+            }
+        }
+        catch (BadHttpRequestException ex) when (response.HasStarted)
+        {
+            // Too late for a 400, so report the bad image in-band and stop
+            await JsonSerializer.SerializeAsync(response.Body, new ErrorResponse(ex.Message), JsonLinesContext.Default.ErrorResponse);
+            await response.Body.WriteAsync(NewLine);
+            return;
+        }
 
-        // ImageSharp decoder options; used in multipart and single image flows
-        var config = Configuration.Default.Clone();
-        config.PreferContiguousImageBuffers = true;
-        var decoderOptions = new DecoderOptions { Configuration = config };
+        if (count == 0)
+        {
+            throw new BadHttpRequestException("No images found in request");
+        }
+    }
+
+    // Uploads are only sniffed for a known format up front, so a corrupt image fails in the pipeline's decode stage.
+    // It's still the client's fault
+    private static OcrPipelineResult Value(Result<OcrPipelineResult> result)
+    {
+        try
+        {
+            return result.Value();
+        }
+        catch (ImageFormatException ex)
+        {
+            throw new BadHttpRequestException($"Invalid image: {ex.Message}");
+        }
+    }
+
+    private static OcrJsonResult ToJsonResult(OcrPipelineResult result) => new(
+        Filename: null,
+        Results: result.Results.Select(r => new OcrTextResult(
+            BoundingBox: r.BBox,
+            Text: r.Text,
+            Confidence: r.Confidence
+        )).ToList()
+    );
+
+    // Yields each uploaded image as read by read, which throws UnknownImageFormatException for anything but an image
+    private static async IAsyncEnumerable<T> ParseImagesFromRequest<T>(HttpRequest request, Func<Stream, Task<T>> read)
+    {
+        var contentType = request.ContentType ?? "";
 
         if (contentType.StartsWith("multipart/"))
         {
@@ -68,10 +143,10 @@ public static class Rest
 
                 if (contentDisposition?.FileName != null)
                 {
-                    Image<Rgb24> image;
+                    T image;
                     try
                     {
-                        image = await Image.LoadAsync<Rgb24>(decoderOptions, section.Body);
+                        image = await read(section.Body);
                     }
                     catch (UnknownImageFormatException ex)
                     {
@@ -85,14 +160,10 @@ public static class Rest
         }
         else if (contentType.StartsWith("application/") || contentType.StartsWith("image/") || string.IsNullOrEmpty(contentType))
         {
-            using var memoryStream = new MemoryStream();
-            await request.Body.CopyToAsync(memoryStream);
-            memoryStream.Position = 0;
-
-            Image<Rgb24> image;
+            T image;
             try
             {
-                image = await Image.LoadAsync<Rgb24>(decoderOptions, memoryStream);
+                image = await read(request.BodyReader.AsStream());
             }
             catch (UnknownImageFormatException ex)
             {
@@ -106,6 +177,36 @@ public static class Rest
         }
     }
 
+    private static DecoderOptions CreateDecoderOptions()
+    {
+        var config = Configuration.Default.Clone();
+        config.PreferContiguousImageBuffers = true;
+        return new DecoderOptions { Configuration = config };
+    }
+
+    // A corrupt image of a known format fails here rather than in the pipeline, and is still the client's fault
+    private static async Task<Image<Rgb24>> Decode(Stream body)
+    {
+        try
+        {
+            return await Image.LoadAsync<Rgb24>(DecoderOptions, body);
+        }
+        catch (ImageFormatException ex) when (ex is not UnknownImageFormatException)
+        {
+            throw new BadHttpRequestException($"Invalid image: {ex.Message}");
+        }
+    }
+
+    // Kept encoded for the cache to hash, and only sniffed for a known format here. The pipeline decodes it
+    private static async Task<ReadOnlyMemory<byte>> ReadEncoded(Stream body)
+    {
+        using var buffer = new MemoryStream();
+        await body.CopyToAsync(buffer);
+        var image = buffer.GetBuffer().AsMemory(0, (int)buffer.Length);
+        Image.DetectFormat(image.Span);
+        return image;
+    }
+
     private static async IAsyncEnumerable<MultipartSection> ExtractSectionsAsync(HttpRequest request)
     {
         var contentType = request.ContentType ?? throw new BadHttpRequestException("No Content-Type header");
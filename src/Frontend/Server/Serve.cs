@@ -8,6 +8,8 @@ using OpenTelemetry.Metrics;
 using OpenTelemetry.Resources;
 using SpeedReader.Ocr;
 using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+using SpeedReader.Ocr.SmartMetrics;
 using SpeedReader.Resources.Web;
 using Model = SpeedReader.Ocr.InferenceEngine.Model;
 
@@ -15,8 +17,12 @@ namespace SpeedReader.Frontend.Server;
 
 public static class Serve
 {
-    public static async Task RunServer()
+    // With a remote engine this server is a coordinator: it takes OCR requests as usual and shards their inference
+    // across the workers. Otherwise it runs the models itself, and in worker mode also runs them for coordinators
+    public static async Task RunServer(string? modelCacheDirectory, ResultCacheOptions? resultCache,
+        RemoteEngineConfig? remoteEngine, bool workerMode)
     {
+
         // Create minimal web app
         var builder = WebApplication.CreateSlimBuilder();
 
@@ -30,28 +36,34 @@ public static class Serve
                 Kernel = new OnnxInferenceKernelOptions(
                     model: Model.DbNet,
                     quantization: Quantization.Int8,
-                    numIntraOpThreads: 1),
-                MaxParallelism = 1,
-                ReservedPCores = [0, 2, 4, 6]
+                    numIntraOpThreads: 1) { ModelCacheDirectory = modelCacheDirectory },
+                MaxParallelism = 1
             },
             RecognitionEngine = new CpuEngineConfig
             {
                 Kernel = new OnnxInferenceKernelOptions(
                     model: Model.Svtr,
                     quantization: Quantization.Fp32,
-                    numIntraOpThreads: 1),
+                    numIntraOpThreads: 1) { ModelCacheDirectory = modelCacheDirectory },
                 MaxParallelism = 1,
-                ReservedPCores = [0, 2, 4, 6]
-            }
+                MaxBatchSize = 8  // Batched per width bucket, concurrent text lines of similar width batch well
+            },
+            RemoteEngine = remoteEngine,
+            Visualize = false,  // Nothing renders SVGs here
+            ResultCache = resultCache
         };
         builder.Services.AddOcrPipeline(ocrPipelineOptions);
+        if (workerMode)
+            builder.Services.AddSingleton(InferenceLimits.For(ocrPipelineOptions));
 
         // Configure OpenTelemetry
         builder.Services
             .AddOpenTelemetry()
             .ConfigureResource(resource => resource.AddService(serviceName: "SpeedReader"))
             .WithMetrics(metrics => metrics
-                .AddMeter("speedreader.inference.cpu")
+                .AddMeter(WorkerRebalancer.MeterName)
+                .AddMeter(ResultCache.MeterName)
+                .AddMeter(StageTimings.MeterName)
                 .AddAspNetCoreInstrumentation()
                 .AddRuntimeInstrumentation()
                 .AddProcessInstrumentation()
@@ -69,6 +81,8 @@ public static class Serve
         app.MapGet("/api/health", () => "Healthy");
         app.MapPost("/api/ocr", Rest.PostOcr);
         app.Map("/api/ws/ocr", Websockets.HandleOcrWebSocket);
+        if (workerMode)
+            app.MapPost(InferenceWire.Path, Inference.PostInfer);
 
         // Serve embedded demo page
         var embeddedWeb = new EmbeddedWeb();
@@ -6,16 +6,14 @@ using System.Text;
 using System.Text.Json;
 using System.Threading.Channels;
 using Microsoft.AspNetCore.Http;
-using SixLabors.ImageSharp;
-using SixLabors.ImageSharp.Formats;
-using SixLabors.ImageSharp.PixelFormats;
 using SpeedReader.Ocr;
+using SpeedReader.Ocr.SmartMetrics;
 
 namespace SpeedReader.Frontend.Server;
 
 public static class Websockets
 {
-    public static async Task HandleOcrWebSocket(HttpContext context, OcrPipeline speedReader)
+    public static async Task HandleOcrWebSocket(HttpContext context, OcrPipeline speedReader, StageTimings stageTimings)
     {
         if (!context.WebSockets.IsWebSocketRequest)
         {
@@ -24,15 +22,13 @@ public static class Websockets
         }
 
         using var webSocket = await context.WebSockets.AcceptWebSocketAsync();
-        await ProcessWebSocket(webSocket, speedReader);
+        await ProcessWebSocket(webSocket, speedReader, stageTimings);
     }
 
-    private static async Task ProcessWebSocket(WebSocket webSocket, OcrPipeline speedReader)
+    private static async Task ProcessWebSocket(WebSocket webSocket, OcrPipeline speedReader, StageTimings stageTimings)
     {
-        var inputBuffer = Channel.CreateBounded<Image<Rgb24>>(1);
-        var config = Configuration.Default.Clone();
-        config.PreferContiguousImageBuffers = true;
-        var decoderOptions = new DecoderOptions { Configuration = config };
+        // Messages are decoded by the pipeline's decode stage, so the receive loop only ever copies bytes
+        var inputBuffer = Channel.CreateBounded<ReadOnlyMemory<byte>>(1);
 
         var receiveTask = Task.Run(async () =>
         {
@@ -44,9 +40,7 @@ public static class Websockets
                     if (messageBytes == null)
                         break;
 
-                    using var memoryStream = new MemoryStream(messageBytes);
-                    var image = await Image.LoadAsync<Rgb24>(decoderOptions, memoryStream);
-                    await inputBuffer.Writer.WriteAsync(image);
+                    await inputBuffer.Writer.WriteAsync(messageBytes);
                 }
             }
             finally
@@ -62,6 +56,7 @@ public static class Websockets
                 var result = resultWrapper.Value();
                 try
                 {
+                    var start = stageTimings.Start();
                     var jsonResult = new OcrJsonResult(
                         Filename: null,
                         Results: result.Results.Select(r => new OcrTextResult(
@@ -73,6 +68,7 @@ public static class Websockets
 
                     var json = JsonSerializer.Serialize(jsonResult, JsonContext.Default.OcrJsonResult);
                     var jsonBytes = Encoding.UTF8.GetBytes(json);
+                    stageTimings.Record(PipelineStage.Serialize, start);
                     await webSocket.SendAsync(
                         new ArraySegment<byte>(jsonBytes),
                         WebSocketMessageType.Text,
@@ -92,7 +88,7 @@ public static class Websockets
                 }
                 finally
                 {
-                    result.Image.Dispose();
+                    result.Image?.Dispose();
                 }
             }
 
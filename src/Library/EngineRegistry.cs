@@ -0,0 +1,87 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using Microsoft.Extensions.DependencyInjection;
+using SpeedReader.Ocr;
+using SpeedReader.Ocr.InferenceEngine;
+
+namespace SpeedReader.Library;
+
+// Engines shared by every instance in the process: one DBNet and one SVTR session, one affinitized thread pool, and
+// one admission pool that instances draw from in proportion to their priority. Created with the first instance and
+// torn down with the last, so a host that opens an instance per tenant pays for the weights and cores once
+internal sealed class EngineRegistry : IDisposable
+{
+    private static readonly Lock _lock = new();
+    private static EngineRegistry? _shared;
+    private static int _refCount;
+
+    private readonly ServiceProvider _serviceProvider;
+    private readonly OcrPipelineOptions _options;
+
+    public TextDetector Detector { get; }
+    public TextRecognizer Recognizer { get; }
+    public ImageDecoder Decoder { get; }
+    public FairSharePool<OcrPipelineResult> Admission { get; }
+
+    // Hashes the weights, so only computed once an instance turns on its result cache
+    public string ResultCacheFingerprint => field ??= ResultCache.Fingerprint(_options);
+
+    private EngineRegistry()
+    {
+        var options = _options = new OcrPipelineOptions
+        {
+            DetectionOptions = new DetectionOptions(),
+            RecognitionOptions = new RecognitionOptions(),
+            DetectionEngine = new CpuEngineConfig
+            {
+                Kernel = new OnnxInferenceKernelOptions(
+                    model: Model.DbNet,
+                    quantization: Quantization.Int8,
+                    numIntraOpThreads: 4),
+                MaxParallelism = 4
+            },
+            RecognitionEngine = new CpuEngineConfig
+            {
+                Kernel = new OnnxInferenceKernelOptions(
+                    model: Model.Svtr,
+                    quantization: Quantization.Fp32,
+                    numIntraOpThreads: 4),
+                MaxParallelism = 4
+            },
+            Visualize = false  // Nothing renders SVGs here
+        };
+
+        var services = new ServiceCollection();
+        services.AddOcrPipeline(options);
+        _serviceProvider = services.BuildServiceProvider();
+
+        Detector = _serviceProvider.GetRequiredService<TextDetector>();
+        Recognizer = _serviceProvider.GetRequiredService<TextRecognizer>();
+        Decoder = _serviceProvider.GetRequiredService<ImageDecoder>();
+        Admission = new FairSharePool<OcrPipelineResult>(OcrPipeline.DefaultPoolSize(Detector, Recognizer));
+    }
+
+    public static EngineRegistry Acquire()
+    {
+        lock (_lock)
+        {
+            _shared ??= new EngineRegistry();
+            _refCount++;
+            return _shared;
+        }
+    }
+
+    public static void Release()
+    {
+        EngineRegistry? last = null;
+        lock (_lock)
+        {
+            if (--_refCount == 0)
+                (last, _shared) = (_shared, null);
+        }
+        last?.Dispose();
+    }
+
+    public void Dispose() => _serviceProvider.Dispose();
+}
@@ -0,0 +1,42 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Runtime.InteropServices;
+using System.Runtime.Versioning;
+
+namespace SpeedReader.Library;
+
+// Counter fd that becomes readable after Signal, for callers that wait in epoll/io_uring instead of in the library
+[SupportedOSPlatform("linux")]
+internal sealed partial class EventFd : IDisposable
+{
+    private const int EfdCloexec = 0x80000;
+    private const int EfdNonblock = 0x800;
+
+    [LibraryImport("libc", SetLastError = true)]
+    private static partial int eventfd(uint initval, int flags);
+
+    [LibraryImport("libc", SetLastError = true)]
+    private static partial nint write(int fd, ref ulong buf, nuint count);
+
+    [LibraryImport("libc", SetLastError = true)]
+    private static partial int close(int fd);
+
+    public int Fd { get; }
+
+    public EventFd()
+    {
+        Fd = eventfd(0, EfdCloexec | EfdNonblock);
+        if (Fd < 0)
+            throw new InvalidOperationException($"{nameof(eventfd)} failed, errno: {Marshal.GetLastWin32Error()}");
+    }
+
+    // Only fails if the counter would overflow, in which case the fd is already readable
+    public void Signal()
+    {
+        var one = 1UL;
+        write(Fd, ref one, sizeof(ulong));
+    }
+
+    public void Dispose() => close(Fd);
+}
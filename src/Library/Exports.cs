@@ -2,11 +2,10 @@
 // Licensed under the Apache License, Version 2.0
 
 using System.Collections.Concurrent;
+using System.Diagnostics.CodeAnalysis;
 using System.Runtime.InteropServices;
 using System.Text;
 using System.Text.Json;
-using SixLabors.ImageSharp;
-using SixLabors.ImageSharp.PixelFormats;
 using SpeedReader.Ocr;
 
 namespace SpeedReader.Library;
@@ -16,6 +15,7 @@ public static unsafe class Exports
     private const int Ok = 0;
     private const int Error = 1;
     private const int Timeout = 2;
+    private const int WouldBlock = 3;
 
     private const int ErrorBufSize = 256;
 
@@ -57,19 +57,215 @@ public static unsafe class Exports
         }
     }
 
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_set_priority")]
+    public static int SetPriority(long instance, int priority, byte* error)
+    {
+        try
+        {
+            if (priority < 1)
+                throw new ArgumentOutOfRangeException(nameof(priority), priority, "Priority must be at least 1");
+            GetInstance(instance).Priority = priority;
+            return Ok;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_set_result_cache")]
+    public static int SetResultCache(long instance, int maxEntries, byte* diskDirectory, int maxDiskEntries,
+        byte* error)
+    {
+        try
+        {
+            if (maxEntries < 0)
+                throw new ArgumentOutOfRangeException(nameof(maxEntries), maxEntries, "Max entries can't be negative");
+            if (maxDiskEntries < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(maxDiskEntries), maxDiskEntries,
+                    "Max disk entries can't be negative");
+            }
+            var directory = Marshal.PtrToStringUTF8((nint)diskDirectory);
+            if (maxEntries == 0 && directory != null)
+                throw new ArgumentException("A disk directory needs a positive max entries", nameof(diskDirectory));
+
+            var inst = GetInstance(instance);
+            if (maxEntries == 0)
+            {
+                inst.Pipeline.ResultCache = null;
+                return Ok;
+            }
+
+            var options = new ResultCacheOptions { MaxEntries = maxEntries, DiskDirectory = directory };
+            if (maxDiskEntries > 0)
+                options = options with { MaxDiskEntries = maxDiskEntries };
+            inst.Pipeline.ResultCache = new ResultCache(options, inst.ResultCacheFingerprint);
+            return Ok;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
     [UnmanagedCallersOnly(EntryPoint = "speedreader_submit")]
     public static int Submit(long instance, byte* imageData, nuint imageLen, long* handle, byte* error)
     {
         try
         {
             var inst = GetInstance(instance);
-            var imageSpan = new ReadOnlySpan<byte>(imageData, (int)imageLen);
-            var image = Image.Load<Rgb24>(imageSpan);
-            var resultTask = inst.Pipeline.ReadOne(image).GetAwaiter().GetResult();
+            var resultTask = inst.Pipeline.ReadOne(CopyImage(imageData, imageLen)).GetAwaiter().GetResult();
+            *handle = AddHandle(inst, resultTask);
+            return Ok;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
 
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_submit_with_callback")]
+    public static int SubmitWithCallback(long instance, byte* imageData, nuint imageLen,
+        delegate* unmanaged<long, void*, void> callback, void* userData, long* handle, byte* error)
+    {
+        try
+        {
+            ArgumentNullException.ThrowIfNull(callback);
+            var inst = GetInstance(instance);
+            var resultTask = inst.Pipeline.ReadOne(CopyImage(imageData, imageLen)).GetAwaiter().GetResult();
             var id = Interlocked.Increment(ref _nextHandleId);
             Handles[id] = resultTask;
             *handle = id;
+            _ = CallbackWhenComplete(id, resultTask, (nint)callback, (nint)userData);
+            return Ok;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_submit_pixels")]
+    public static int SubmitPixels(long instance, byte* data, int width, int height, int stride, int format,
+        long* handle, byte* error)
+    {
+        try
+        {
+            var inst = GetInstance(instance);
+            var image = PixelBuffer.ToImage(data, width, height, stride, (PixelFormat)format);
+            var resultTask = inst.Pipeline.ReadOne(image).GetAwaiter().GetResult();
+            *handle = AddHandle(inst, resultTask);
+            return Ok;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_submit_batch")]
+    public static int SubmitBatch(long instance, byte** images, nuint* imageLens, nuint count, long* handles, byte* error)
+    {
+        try
+        {
+            var inst = GetInstance(instance);
+
+            var copies = new byte[checked((int)count)][];
+            for (var i = 0; i < copies.Length; i++)
+                copies[i] = CopyImage(images[i], imageLens[i]);
+
+            // Enter the pool for every image before blocking on any of them, so they queue up together
+            var entries = new Task<Task<OcrPipelineResult>>[copies.Length];
+            for (var i = 0; i < entries.Length; i++)
+                entries[i] = inst.Pipeline.ReadOne(copies[i]);
+
+            // Publish handles only once every image is in, so a failure leaves the caller with none to track. Images
+            // admitted before the failure still run, their results are dropped
+            var resultTasks = new Task<OcrPipelineResult>[entries.Length];
+            for (var i = 0; i < entries.Length; i++)
+                resultTasks[i] = entries[i].GetAwaiter().GetResult();
+            for (var i = 0; i < resultTasks.Length; i++)
+                handles[i] = AddHandle(inst, resultTasks[i]);
+            return Ok;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_try_submit")]
+    public static int TrySubmit(long instance, byte** images, nuint* imageLens, nuint count, long* handles,
+        nuint* submitted, byte* error)
+    {
+        *submitted = 0;
+        try
+        {
+            var inst = GetInstance(instance);
+            for (nuint i = 0; i < count; i++)
+            {
+                if (!inst.Pipeline.TryReadOne(CopyImage(images[i], imageLens[i]), out var resultTask))
+                    return WouldBlock;
+                handles[i] = AddHandle(inst, resultTask);
+                *submitted = i + 1;
+            }
+            return Ok;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_poll")]
+    public static int Poll(long instance, int timeoutMs, long* handles, nuint maxHandles, nuint* count, byte* error)
+    {
+        *count = 0;
+        try
+        {
+            var inst = GetInstance(instance);
+            var into = new Span<long>(handles, (int)Math.Min(maxHandles, int.MaxValue));
+            var deadline = timeoutMs < 0 ? long.MaxValue : Environment.TickCount64 + timeoutMs;
+
+            // Return whatever is ready; only wait while there's nothing to return
+            var n = inst.TakeCompletions(into);
+            while (n == 0 && !into.IsEmpty)
+            {
+                var remaining = deadline - Environment.TickCount64;
+                if (remaining <= 0)
+                    break;
+                var wait = timeoutMs < 0 ? System.Threading.Timeout.Infinite : (int)Math.Min(remaining, int.MaxValue);
+                if (!inst.WaitForCompletions(wait))
+                    break;
+                n = inst.TakeCompletions(into);
+            }
+
+            *count = (nuint)n;
+            return n > 0 ? Ok : Timeout;
+        }
+        catch (Exception ex)
+        {
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_completion_fd")]
+    public static int CompletionFd(long instance, int* fd, byte* error)
+    {
+        try
+        {
+            if (!OperatingSystem.IsLinux())
+                throw new PlatformNotSupportedException("Completion fds require Linux");
+            *fd = GetInstance(instance).GetOrCreateCompletionFd().Fd;
             return Ok;
         }
         catch (Exception ex)
@@ -84,16 +280,9 @@ public static unsafe class Exports
     {
         try
         {
-            if (!Handles.TryGetValue(handle, out var task))
-                throw new ArgumentException($"Invalid handle: {handle}");
-
-            var completed = task.Wait(timeoutMs < 0 ? System.Threading.Timeout.Infinite : timeoutMs);
-            if (!completed)
+            if (!TryTakeResult(instance, handle, timeoutMs, out var pipelineResult))
                 return Timeout;
 
-            Handles.TryRemove(handle, out _);
-
-            var pipelineResult = task.GetAwaiter().GetResult();
             try
             {
                 var jsonResult = new OcrJsonResult(
@@ -117,12 +306,38 @@ public static unsafe class Exports
             }
             finally
             {
-                pipelineResult.Image.Dispose();
+                pipelineResult.Image?.Dispose();
             }
         }
         catch (Exception ex)
         {
-            Handles.TryRemove(handle, out _);
+            RemoveHandle(instance, handle);
+            WriteError(error, ex.Message);
+            return Error;
+        }
+    }
+
+    [UnmanagedCallersOnly(EntryPoint = "speedreader_await_binary")]
+    public static int AwaitBinary(long instance, long handle, int timeoutMs, void** result, byte* error)
+    {
+        try
+        {
+            if (!TryTakeResult(instance, handle, timeoutMs, out var pipelineResult))
+                return Timeout;
+
+            try
+            {
+                *result = ResultArena.Write(pipelineResult);
+                return Ok;
+            }
+            finally
+            {
+                pipelineResult.Image?.Dispose();
+            }
+        }
+        catch (Exception ex)
+        {
+            RemoveHandle(instance, handle);
             WriteError(error, ex.Message);
             return Error;
         }
@@ -133,7 +348,7 @@ public static unsafe class Exports
     {
         try
         {
-            Handles.TryRemove(handle, out _);
+            RemoveHandle(instance, handle);
             return Ok;
         }
         catch
@@ -156,6 +371,59 @@ public static unsafe class Exports
         }
     }
 
+    // The caller may free its buffer as soon as submit returns, decoding happens later on the pipeline
+    private static byte[] CopyImage(byte* imageData, nuint imageLen) =>
+        new ReadOnlySpan<byte>(imageData, checked((int)imageLen)).ToArray();
+
+    private static long AddHandle(Instance inst, Task<OcrPipelineResult> resultTask)
+    {
+        var id = Interlocked.Increment(ref _nextHandleId);
+        Handles[id] = resultTask;
+        _ = NotifyWhenComplete(inst, id, resultTask);
+        return id;
+    }
+
+    private static async Task NotifyWhenComplete(Instance inst, long id, Task resultTask)
+    {
+        await resultTask.ConfigureAwait(ConfigureAwaitOptions.SuppressThrowing);
+        if (inst.TryAddCompletion(id, () => Handles.ContainsKey(id)) && OperatingSystem.IsLinux())
+            inst.SignalCompletion();
+    }
+
+    // Always yields, so the callback runs on a library thread even if the request failed before submit returned
+    private static async Task CallbackWhenComplete(long id, Task resultTask, nint callback, nint userData)
+    {
+        await resultTask.ConfigureAwait(ConfigureAwaitOptions.SuppressThrowing | ConfigureAwaitOptions.ForceYielding);
+        unsafe
+        {
+            ((delegate* unmanaged<long, void*, void>)callback)(id, (void*)userData);
+        }
+    }
+
+    // Returns false on timeout. Otherwise consumes the handle, throwing if the request failed
+    private static bool TryTakeResult(long instance, long handle, int timeoutMs,
+        [NotNullWhen(true)] out OcrPipelineResult? result)
+    {
+        result = null;
+        if (!Handles.TryGetValue(handle, out var task))
+            throw new ArgumentException($"Invalid handle: {handle}");
+
+        var completed = task.Wait(timeoutMs < 0 ? System.Threading.Timeout.Infinite : timeoutMs);
+        if (!completed)
+            return false;
+
+        RemoveHandle(instance, handle);
+        result = task.GetAwaiter().GetResult();
+        return true;
+    }
+
+    // Also drops the handle from its instance's completions, so poll doesn't hold on to consumed handles
+    private static void RemoveHandle(long instance, long handle)
+    {
+        if (Handles.TryRemove(handle, out _) && Instances.TryGetValue(instance, out var inst))
+            inst.RemoveCompletion(handle);
+    }
+
     private static Instance GetInstance(long instance) =>
         Instances.TryGetValue(instance, out var inst)
             ? inst
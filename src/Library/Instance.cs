@@ -1,48 +1,119 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
-using Microsoft.Extensions.DependencyInjection;
+using System.Runtime.Versioning;
 using SpeedReader.Ocr;
-using SpeedReader.Ocr.InferenceEngine;
 
 namespace SpeedReader.Library;
 
 internal class Instance : IDisposable
 {
     public readonly OcrPipeline Pipeline;
-    private readonly ServiceProvider _serviceProvider;
+    private readonly EngineRegistry _engines;
+    private readonly FairSharePool<OcrPipelineResult>.Tenant _tenant;
+    private readonly Lock _completionFdLock = new();
+    private EventFd? _completionFd;
 
+    // Handles whose result is ready, oldest first. Consumed handles are dropped, so this never outgrows the open
+    // handles even if the caller never polls
+    private readonly Lock _completionsLock = new();
+    private readonly LinkedList<long> _completions = new();
+    private readonly Dictionary<long, LinkedListNode<long>> _completionNodes = new();
+    private readonly ManualResetEventSlim _completionsReady = new();
+    private bool _disposed;
+
+    // Instances only own their admission share, the engines behind it are shared process-wide
     public Instance()
     {
-        var options = new OcrPipelineOptions
+        _engines = EngineRegistry.Acquire();
+        _tenant = _engines.Admission.AddTenant();
+        Pipeline = new OcrPipeline(_engines.Detector, _engines.Recognizer, _tenant, visualize: false, _engines.Decoder);
+    }
+
+    // Result caches are keyed on the shared engines' models and options
+    public string ResultCacheFingerprint => _engines.ResultCacheFingerprint;
+
+    // Relative share of the shared engines when instances compete for them
+    public int Priority
+    {
+        get => _tenant.Weight;
+        set => _tenant.Weight = value;
+    }
+
+    // Records a ready handle unless isOpen says it was already consumed. Checked under the lock, so a handle consumed
+    // concurrently is either never added or removed again by its RemoveCompletion
+    public bool TryAddCompletion(long handle, Func<bool> isOpen)
+    {
+        lock (_completionsLock)
         {
-            DetectionOptions = new DetectionOptions(),
-            RecognitionOptions = new RecognitionOptions(),
-            DetectionEngine = new CpuEngineConfig
-            {
-                Kernel = new OnnxInferenceKernelOptions(
-                    model: Model.DbNet,
-                    quantization: Quantization.Int8,
-                    numIntraOpThreads: 4),
-                MaxParallelism = 4,
-                ReservedPCores = [0, 2, 4, 6]
-            },
-            RecognitionEngine = new CpuEngineConfig
+            if (_disposed || !isOpen())
+                return false;
+            _completionNodes[handle] = _completions.AddLast(handle);
+            _completionsReady.Set();
+            return true;
+        }
+    }
+
+    // Called when a handle is awaited or cancelled, so poll never reports it
+    public void RemoveCompletion(long handle)
+    {
+        lock (_completionsLock)
+        {
+            if (_completionNodes.Remove(handle, out var node))
+                _completions.Remove(node);
+        }
+    }
+
+    // Moves up to handles.Length ready handles into handles, returning how many
+    public int TakeCompletions(Span<long> handles)
+    {
+        lock (_completionsLock)
+        {
+            var n = 0;
+            while (n < handles.Length && _completions.First is { } node)
             {
-                Kernel = new OnnxInferenceKernelOptions(
-                    model: Model.Svtr,
-                    quantization: Quantization.Fp32,
-                    numIntraOpThreads: 4),
-                MaxParallelism = 4,
-                ReservedPCores = [0, 2, 4, 6]
+                _completions.RemoveFirst();
+                _completionNodes.Remove(node.Value);
+                handles[n++] = node.Value;
             }
-        };
+            if (_completions.Count == 0 && !_disposed)
+                _completionsReady.Reset();
+            return n;
+        }
+    }
 
-        var services = new ServiceCollection();
-        services.AddOcrPipeline(options);
-        _serviceProvider = services.BuildServiceProvider();
-        Pipeline = _serviceProvider.GetRequiredService<OcrPipeline>();
+    // False on timeout or once the instance is disposed
+    public bool WaitForCompletions(int timeoutMs) => _completionsReady.Wait(timeoutMs) && !Volatile.Read(ref _disposed);
+
+    // Signalled after each handle is added to the completions. Created on first use, since most callers never want it
+    public EventFd GetOrCreateCompletionFd()
+    {
+        lock (_completionFdLock)
+            return _completionFd ??= new EventFd();
     }
 
-    public void Dispose() => _serviceProvider.Dispose();
+    // Under the lock so a completion racing with Dispose can't write to a closed (and possibly reused) fd
+    [SupportedOSPlatform("linux")]
+    public void SignalCompletion()
+    {
+        lock (_completionFdLock)
+            _completionFd?.Signal();
+    }
+
+    public void Dispose()
+    {
+        // Wakes any blocked poll. The event itself isn't disposed, since a poll may still be waiting on it
+        lock (_completionsLock)
+        {
+            _disposed = true;
+            _completionsReady.Set();
+        }
+        _tenant.Dispose();
+        EngineRegistry.Release();
+        lock (_completionFdLock)
+        {
+            _completionFd?.Dispose();
+            _completionFd = null;
+        }
+    }
 }
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+
+namespace SpeedReader.Library;
+
+// Mirrors SpeedReaderPixelFormat in speedreader.h
+internal enum PixelFormat
+{
+    Rgb24 = 0,
+    Bgr24 = 1,
+    Rgba32 = 2,
+    Gray8 = 3
+}
+
+internal static unsafe class PixelBuffer
+{
+    // Tightly packed RGB24 is what the pipeline works in, so it's wrapped in place and the caller's buffer must outlive
+    // the request. Everything else is converted into a pipeline-owned image here
+    public static Image<Rgb24> ToImage(byte* data, int width, int height, int stride, PixelFormat format)
+    {
+        ArgumentNullException.ThrowIfNull(data);
+        ArgumentOutOfRangeException.ThrowIfLessThan(width, 1, nameof(width));
+        ArgumentOutOfRangeException.ThrowIfLessThan(height, 1, nameof(height));
+
+        var bytesPerPixel = format switch
+        {
+            PixelFormat.Rgb24 or PixelFormat.Bgr24 => 3,
+            PixelFormat.Rgba32 => 4,
+            PixelFormat.Gray8 => 1,
+            _ => throw new ArgumentOutOfRangeException(nameof(format), $"Unknown pixel format: {(int)format}")
+        };
+        ArgumentOutOfRangeException.ThrowIfLessThan(stride, checked(width * bytesPerPixel), nameof(stride));
+        var size = checked(stride * height);
+
+        return format switch
+        {
+            PixelFormat.Rgb24 when stride == width * bytesPerPixel => Image.WrapMemory<Rgb24>(data, size, width, height),
+            PixelFormat.Rgb24 => Convert<Rgb24>((nint)data, width, height, stride),
+            PixelFormat.Bgr24 => Convert<Bgr24>((nint)data, width, height, stride),
+            PixelFormat.Rgba32 => Convert<Rgba32>((nint)data, width, height, stride),
+            _ => Convert<L8>((nint)data, width, height, stride)
+        };
+    }
+
+    private static Image<Rgb24> Convert<TPixel>(nint data, int width, int height, int stride)
+        where TPixel : unmanaged, IPixel<TPixel>
+    {
+        var image = new Image<Rgb24>(width, height);
+        image.ProcessPixelRows(accessor =>
+        {
+            for (var y = 0; y < accessor.Height; y++)
+            {
+                var row = new ReadOnlySpan<TPixel>((byte*)data + (long)y * stride, width);
+                PixelOperations<TPixel>.Instance.To(Configuration.Default, row, accessor.GetRowSpan(y));
+            }
+        });
+        return image;
+    }
+}
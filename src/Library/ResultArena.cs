@@ -0,0 +1,138 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+using SpeedReader.Ocr;
+
+namespace SpeedReader.Library;
+
+// Packed result layout returned by speedreader_await_binary. Each struct mirrors its C counterpart in speedreader.h
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NativePoint
+{
+    public double X, Y;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NativeRotatedRectangle
+{
+    public double X, Y, Width, Height, Angle;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NativeRectangle
+{
+    public double X, Y, Width, Height;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NativeTextResult
+{
+    public NativeRotatedRectangle RotatedRectangle;
+    public NativeRectangle Rectangle;
+    public double Confidence;
+    public uint PolygonOffset;
+    public uint PolygonCount;
+    public uint TextOffset;
+    public uint TextLen;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal unsafe struct NativeResult
+{
+    public uint ResultCount;
+    public uint PointCount;
+    public uint TextBytes;
+    public uint Reserved;
+    public NativeTextResult* Results;
+    public NativePoint* Points;
+    public byte* Text;
+}
+
+// One arena per calling thread, so concurrent awaits never share one. Each write invalidates the previous result on
+// that thread. The buffer lives on the pinned object heap, so it's safe to hand out pointers and the GC reclaims it
+// when the thread goes away
+internal static unsafe class ResultArena
+{
+    [ThreadStatic]
+    private static byte[]? _buffer;
+
+    public static NativeResult* Write(OcrPipelineResult pipelineResult)
+    {
+        var results = pipelineResult.Results;
+        var pointCount = 0;
+        var textBytes = 0;
+        foreach (var (bbox, text, _) in results)
+        {
+            pointCount += bbox.Polygon.Points.Count;
+            textBytes += Encoding.UTF8.GetByteCount(text) + 1;  // Null-terminated
+        }
+
+        // Everything is a multiple of 8 bytes except the text, so text goes last and nothing needs padding
+        var resultsOffset = sizeof(NativeResult);
+        var pointsOffset = checked(resultsOffset + results.Count * sizeof(NativeTextResult));
+        var textOffset = checked(pointsOffset + pointCount * sizeof(NativePoint));
+        var size = checked(textOffset + textBytes);
+
+        if (_buffer == null || _buffer.Length < size)
+            _buffer = GC.AllocateUninitializedArray<byte>(Math.Max(size, (_buffer?.Length ?? 4096) * 2), pinned: true);
+
+        var basePtr = (byte*)Unsafe.AsPointer(ref MemoryMarshal.GetArrayDataReference(_buffer));
+        var header = (NativeResult*)basePtr;
+        *header = new NativeResult
+        {
+            ResultCount = (uint)results.Count,
+            PointCount = (uint)pointCount,
+            TextBytes = (uint)textBytes,
+            Results = (NativeTextResult*)(basePtr + resultsOffset),
+            Points = (NativePoint*)(basePtr + pointsOffset),
+            Text = basePtr + textOffset
+        };
+
+        var nextPoint = 0;
+        var nextText = 0;
+        for (var i = 0; i < results.Count; i++)
+        {
+            var (bbox, text, confidence) = results[i];
+            var rotated = bbox.RotatedRectangle;
+            var rectangle = bbox.AxisAlignedRectangle;
+            var points = bbox.Polygon.Points;
+
+            var textLen = Encoding.UTF8.GetBytes(text, new Span<byte>(header->Text + nextText, textBytes - nextText));
+            header->Text[nextText + textLen] = 0;
+
+            header->Results[i] = new NativeTextResult
+            {
+                RotatedRectangle = new NativeRotatedRectangle
+                {
+                    X = rotated.X,
+                    Y = rotated.Y,
+                    Width = rotated.Width,
+                    Height = rotated.Height,
+                    Angle = rotated.Angle
+                },
+                Rectangle = new NativeRectangle
+                {
+                    X = rectangle.X,
+                    Y = rectangle.Y,
+                    Width = rectangle.Width,
+                    Height = rectangle.Height
+                },
+                Confidence = confidence,
+                PolygonOffset = (uint)nextPoint,
+                PolygonCount = (uint)points.Count,
+                TextOffset = (uint)nextText,
+                TextLen = (uint)textLen
+            };
+
+            foreach (var point in points)
+                header->Points[nextPoint++] = new NativePoint { X = point.X, Y = point.Y };
+            nextText += textLen + 1;
+        }
+
+        return header;
+    }
+}
@@ -1,12 +1,18 @@
 #!/usr/bin/env -S uv run --script
 # /// script
 # requires-python = ">=3.11"
+# dependencies = ["pillow"]
 # ///
 
 import ctypes
 import json
+import os
+import select
+import threading
 from pathlib import Path
 
+from PIL import Image
+
 SCRIPT_DIR = Path(__file__).parent.resolve()
 LIB_PATH = SCRIPT_DIR / "bin/Release/net10.0/linux-x64/publish/Library.so"
 IMAGE_PATH = SCRIPT_DIR.parent.parent / "hello.png"
@@ -15,6 +21,7 @@ ERROR_BUF_SIZE = 256
 OK = 0
 ERROR = 1
 TIMEOUT = 2
+WOULD_BLOCK = 3
 
 lib = ctypes.CDLL(str(LIB_PATH))
 
@@ -26,6 +33,16 @@ lib.speedreader_create.restype = ctypes.c_int
 lib.speedreader_destroy.argtypes = [ctypes.c_int64]
 lib.speedreader_destroy.restype = None
 
+# speedreader_set_priority
+lib.speedreader_set_priority.argtypes = [ctypes.c_int64, ctypes.c_int32, ctypes.c_char_p]
+lib.speedreader_set_priority.restype = ctypes.c_int
+
+# speedreader_set_result_cache
+lib.speedreader_set_result_cache.argtypes = [
+    ctypes.c_int64, ctypes.c_int32, ctypes.c_char_p, ctypes.c_int32, ctypes.c_char_p,
+]
+lib.speedreader_set_result_cache.restype = ctypes.c_int
+
 # speedreader_submit
 lib.speedreader_submit.argtypes = [
     ctypes.c_int64, ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t,
@@ -33,6 +50,20 @@ lib.speedreader_submit.argtypes = [
 ]
 lib.speedreader_submit.restype = ctypes.c_int
 
+# speedreader_submit_batch
+lib.speedreader_submit_batch.argtypes = [
+    ctypes.c_int64, ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)), ctypes.POINTER(ctypes.c_size_t),
+    ctypes.c_size_t, ctypes.POINTER(ctypes.c_int64), ctypes.c_char_p,
+]
+lib.speedreader_submit_batch.restype = ctypes.c_int
+
+# speedreader_poll
+lib.speedreader_poll.argtypes = [
+    ctypes.c_int64, ctypes.c_int32, ctypes.POINTER(ctypes.c_int64), ctypes.c_size_t,
+    ctypes.POINTER(ctypes.c_size_t), ctypes.c_char_p,
+]
+lib.speedreader_poll.restype = ctypes.c_int
+
 # speedreader_await
 lib.speedreader_await.argtypes = [
     ctypes.c_int64, ctypes.c_int64, ctypes.c_int32,
@@ -45,6 +76,73 @@ lib.speedreader_await.restype = ctypes.c_int
 lib.speedreader_free_result.argtypes = [ctypes.POINTER(ctypes.c_uint8)]
 lib.speedreader_free_result.restype = None
 
+# speedreader_submit_pixels
+PIXEL_RGB24 = 0
+PIXEL_BGR24 = 1
+PIXEL_RGBA32 = 2
+PIXEL_GRAY8 = 3
+lib.speedreader_submit_pixels.argtypes = [
+    ctypes.c_int64, ctypes.POINTER(ctypes.c_uint8), ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.c_int,
+    ctypes.POINTER(ctypes.c_int64), ctypes.c_char_p,
+]
+lib.speedreader_submit_pixels.restype = ctypes.c_int
+
+# speedreader_submit_with_callback
+CALLBACK = ctypes.CFUNCTYPE(None, ctypes.c_int64, ctypes.c_void_p)
+lib.speedreader_submit_with_callback.argtypes = [
+    ctypes.c_int64, ctypes.POINTER(ctypes.c_uint8), ctypes.c_size_t, CALLBACK, ctypes.c_void_p,
+    ctypes.POINTER(ctypes.c_int64), ctypes.c_char_p,
+]
+lib.speedreader_submit_with_callback.restype = ctypes.c_int
+
+# speedreader_completion_fd
+lib.speedreader_completion_fd.argtypes = [ctypes.c_int64, ctypes.POINTER(ctypes.c_int), ctypes.c_char_p]
+lib.speedreader_completion_fd.restype = ctypes.c_int
+
+
+# Mirrors of the packed result structs in speedreader.h
+class Point(ctypes.Structure):
+    _fields_ = [("x", ctypes.c_double), ("y", ctypes.c_double)]
+
+
+class RotatedRectangle(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_double) for name in ("x", "y", "width", "height", "angle")]
+
+
+class Rectangle(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_double) for name in ("x", "y", "width", "height")]
+
+
+class TextResult(ctypes.Structure):
+    _fields_ = [
+        ("rotated_rectangle", RotatedRectangle),
+        ("rectangle", Rectangle),
+        ("confidence", ctypes.c_double),
+        ("polygon_offset", ctypes.c_uint32),
+        ("polygon_count", ctypes.c_uint32),
+        ("text_offset", ctypes.c_uint32),
+        ("text_len", ctypes.c_uint32),
+    ]
+
+
+class Result(ctypes.Structure):
+    _fields_ = [
+        ("result_count", ctypes.c_uint32),
+        ("point_count", ctypes.c_uint32),
+        ("text_bytes", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+        ("results", ctypes.POINTER(TextResult)),
+        ("points", ctypes.POINTER(Point)),
+        ("text", ctypes.POINTER(ctypes.c_char)),
+    ]
+
+
+# speedreader_await_binary
+lib.speedreader_await_binary.argtypes = [
+    ctypes.c_int64, ctypes.c_int64, ctypes.c_int32, ctypes.POINTER(ctypes.POINTER(Result)), ctypes.c_char_p,
+]
+lib.speedreader_await_binary.restype = ctypes.c_int
+
 
 def check(status, error_buf, context):
     if status != OK:
@@ -52,6 +150,142 @@ def check(status, error_buf, context):
         raise RuntimeError(f"{context}: {msg}")
 
 
+def await_json(instance, handle, timeout_ms, error):
+    result_ptr = ctypes.POINTER(ctypes.c_uint8)()
+    result_len = ctypes.c_size_t()
+    check(
+        lib.speedreader_await(instance, handle, timeout_ms, ctypes.byref(result_ptr), ctypes.byref(result_len), error),
+        error, "await",
+    )
+    result = json.loads(ctypes.string_at(result_ptr, result_len.value).decode())
+    lib.speedreader_free_result(result_ptr)
+    return result
+
+
+def texts(result):
+    return [r["text"] for r in result["results"]]
+
+
+# Every pixel format, each with padded rows, must read the same text as the encoded image
+def check_pixels(instance, expected, error):
+    image = Image.open(IMAGE_PATH)
+    packed = image.convert("RGB").tobytes()
+    layouts = {
+        PIXEL_RGB24: (image.convert("RGB").tobytes(), 3),
+        PIXEL_BGR24: (bytes(b for i in range(0, len(packed), 3) for b in packed[i:i + 3][::-1]), 3),
+        PIXEL_RGBA32: (image.convert("RGBA").tobytes(), 4),
+        PIXEL_GRAY8: (image.convert("L").tobytes(), 1),
+    }
+    padding = 13  # Odd, so padded rows are misaligned too
+    handle = ctypes.c_int64()
+    for pixel_format, (pixels, bpp) in layouts.items():
+        row = image.width * bpp
+        for stride in (row, row + padding):
+            data = b"".join(pixels[y * row:(y + 1) * row] + bytes(stride - row) for y in range(image.height))
+            buf = (ctypes.c_uint8 * len(data)).from_buffer_copy(data)
+            check(
+                lib.speedreader_submit_pixels(
+                    instance, buf, image.width, image.height, stride, pixel_format, ctypes.byref(handle), error),
+                error, f"submit_pixels format={pixel_format} stride={stride}",
+            )
+            # Awaited before buf goes out of scope, packed RGB24 is read in place
+            if texts(await_json(instance, handle, -1, error)) != texts(expected):
+                raise RuntimeError(f"pixels format={pixel_format} stride={stride} read different text")
+
+    row = image.width * 3
+    buf = (ctypes.c_uint8 * (row * image.height)).from_buffer_copy(packed)
+    status = lib.speedreader_submit_pixels(
+        instance, buf, image.width, image.height, row - 1, PIXEL_RGB24, ctypes.byref(handle), error)
+    if status != ERROR:
+        raise RuntimeError("submit_pixels accepted a stride shorter than a row")
+    print("submit pixels: 4 formats, packed and padded")
+
+
+# The binary result must match the header's layout and carry the same results as the JSON one
+def check_binary(instance, image_buf, image_len, expected, error):
+    sizes = {Point: 16, RotatedRectangle: 40, Rectangle: 32, TextResult: 96, Result: 40}
+    for struct, size in sizes.items():
+        if ctypes.sizeof(struct) != size:
+            raise RuntimeError(f"{struct.__name__} is {ctypes.sizeof(struct)} bytes, expected {size}")
+
+    handle = ctypes.c_int64()
+    check(lib.speedreader_submit(instance, image_buf, image_len, ctypes.byref(handle), error), error, "submit")
+    result_ptr = ctypes.POINTER(Result)()
+    check(lib.speedreader_await_binary(instance, handle, -1, ctypes.byref(result_ptr), error), error, "await_binary")
+    result = result_ptr.contents
+
+    if result.result_count != len(expected["results"]):
+        raise RuntimeError(f"binary result has {result.result_count} results, JSON has {len(expected['results'])}")
+    text_base = ctypes.addressof(result.text.contents)
+    point_count = 0
+    for i, json_result in enumerate(expected["results"]):
+        r = result.results[i]
+        text = ctypes.string_at(text_base + r.text_offset, r.text_len).decode()
+        if text != json_result["text"] or ctypes.string_at(text_base + r.text_offset + r.text_len, 1) != b"\0":
+            raise RuntimeError(f"binary result {i} text {text!r} != {json_result['text']!r}")
+        if abs(r.confidence - json_result["confidence"]) > 1e-6:
+            raise RuntimeError(f"binary result {i} confidence {r.confidence} != {json_result['confidence']}")
+        if r.polygon_offset != point_count or r.polygon_offset + r.polygon_count > result.point_count:
+            raise RuntimeError(f"binary result {i} polygon is out of place")
+        point_count += r.polygon_count
+    if point_count != result.point_count:
+        raise RuntimeError(f"polygons cover {point_count} of {result.point_count} points")
+    print(f"await binary: {result.result_count} results match JSON")
+
+
+# The callback fires on a library thread, after which a zero-timeout await must succeed
+def check_callback(instance, image_buf, image_len, expected, error):
+    fired = threading.Event()
+    seen = []
+
+    def on_complete(handle, user_data):
+        seen.append((handle, user_data))
+        fired.set()
+
+    callback = CALLBACK(on_complete)  # Kept alive until the callback has run
+    handle = ctypes.c_int64()
+    check(
+        lib.speedreader_submit_with_callback(
+            instance, image_buf, image_len, callback, ctypes.c_void_p(0x5EED), ctypes.byref(handle), error),
+        error, "submit_with_callback",
+    )
+    if not fired.wait(60):
+        raise RuntimeError("callback never fired")
+    if seen != [(handle.value, 0x5EED)]:
+        raise RuntimeError(f"callback got {seen}, expected handle {handle.value}")
+    if texts(await_json(instance, handle, 0, error)) != texts(expected):
+        raise RuntimeError("callback result differs")
+    print("submit with callback: fired once")
+
+
+# The eventfd becomes readable when a handle completes, then poll reports it without blocking
+def check_completion_fd(instance, image_buf, image_len, error):
+    fd = ctypes.c_int()
+    check(lib.speedreader_completion_fd(instance, ctypes.byref(fd), error), error, "completion_fd")
+    again = ctypes.c_int()
+    check(lib.speedreader_completion_fd(instance, ctypes.byref(again), error), error, "completion_fd")
+    if again.value != fd.value:
+        raise RuntimeError("completion_fd returned a different fd")
+
+    handle = ctypes.c_int64()
+    check(lib.speedreader_submit(instance, image_buf, image_len, ctypes.byref(handle), error), error, "submit")
+    poller = select.poll()
+    poller.register(fd.value, select.POLLIN)
+    ready = (ctypes.c_int64 * 4)()
+    count = ctypes.c_size_t()
+    reported = []
+    while handle.value not in reported:
+        if not poller.poll(60_000):
+            raise RuntimeError("completion fd never became readable")
+        os.read(fd.value, 8)
+        while (status := lib.speedreader_poll(instance, 0, ready, 4, ctypes.byref(count), error)) == OK:
+            reported.extend(ready[:count.value])
+        if status != TIMEOUT:
+            check(status, error, "poll")
+    await_json(instance, handle, 0, error)
+    print("completion fd: readable on completion")
+
+
 def main():
     error = ctypes.create_string_buffer(ERROR_BUF_SIZE)
 
@@ -83,9 +317,77 @@ def main():
     result = json.loads(result_json)
     print(json.dumps(result, indent=2))
 
+    # Submit batch, then poll until every handle is ready
+    batch_size = 4
+    images = (ctypes.POINTER(ctypes.c_uint8) * batch_size)(
+        *[ctypes.cast(image_buf, ctypes.POINTER(ctypes.c_uint8))] * batch_size
+    )
+    image_lens = (ctypes.c_size_t * batch_size)(*[len(image_data)] * batch_size)
+    handles = (ctypes.c_int64 * batch_size)()
+    check(
+        lib.speedreader_submit_batch(instance, images, image_lens, batch_size, handles, error),
+        error, "submit_batch",
+    )
+    print(f"submitted batch: handles={list(handles)}")
+
+    pending = set(handles)
+    ready = (ctypes.c_int64 * batch_size)()
+    count = ctypes.c_size_t()
+    while pending:
+        check(lib.speedreader_poll(instance, -1, ready, batch_size, ctypes.byref(count), error), error, "poll")
+        for h in ready[:count.value]:
+            check(
+                lib.speedreader_await(instance, h, 0, ctypes.byref(result_ptr), ctypes.byref(result_len), error),
+                error, "await",
+            )
+            lib.speedreader_free_result(result_ptr)
+            pending.discard(h)
+    print(f"polled batch: {batch_size} results")
+
+    # A second instance shares the first one's engines, at a higher priority
+    other = ctypes.c_int64()
+    check(lib.speedreader_create(ctypes.byref(other), error), error, "create")
+    check(lib.speedreader_set_priority(other, 2, error), error, "set_priority")
+    if lib.speedreader_set_priority(other, 0, error) != ERROR:
+        raise RuntimeError("set_priority accepted priority 0")
+    check(
+        lib.speedreader_submit(other, image_buf, len(image_data), ctypes.byref(handle), error),
+        error, "submit",
+    )
+    check(
+        lib.speedreader_await(other, handle, -1, ctypes.byref(result_ptr), ctypes.byref(result_len), error),
+        error, "await",
+    )
+    lib.speedreader_free_result(result_ptr)
+    print(f"second instance: {other.value}, priority 2")
+
+    # With a result cache, a resubmitted image comes back without running the pipeline
+    check(lib.speedreader_set_result_cache(other, 16, None, 0, error), error, "set_result_cache")
+    cached_results = []
+    for _ in range(2):
+        check(
+            lib.speedreader_submit(other, image_buf, len(image_data), ctypes.byref(handle), error),
+            error, "submit",
+        )
+        check(
+            lib.speedreader_await(other, handle, -1, ctypes.byref(result_ptr), ctypes.byref(result_len), error),
+            error, "await",
+        )
+        cached_results.append(json.loads(ctypes.string_at(result_ptr, result_len.value).decode()))
+        lib.speedreader_free_result(result_ptr)
+    if cached_results[0] != cached_results[1] or cached_results[0] != result:
+        raise RuntimeError("cached result differs")
+    print("result cache: resubmission matched")
+
+    check_pixels(instance, result, error)
+    check_binary(instance, image_buf, len(image_data), result, error)
+    check_callback(instance, image_buf, len(image_data), result, error)
+    check_completion_fd(instance, image_buf, len(image_data), error)
+
     # Destroy
+    lib.speedreader_destroy(other)
     lib.speedreader_destroy(instance)
-    print("destroyed instance")
+    print("destroyed instances")
 
 
 if __name__ == "__main__":
@@ -23,12 +23,16 @@ extern "C" {
 
 typedef int64_t SpeedReaderInstance;
 
-// Handle returned by speedreader_submit, used to retrieve the result.
-// - Each handle must be passed to exactly one call of speedreader_await or speedreader_cancel.
+// Handle returned by speedreader_submit (and friends), used to retrieve the result.
+// - Each handle must be passed to exactly one call of speedreader_await, speedreader_await_binary or
+//   speedreader_cancel.
 // - After that call, the handle is invalid and must not be reused.
 // - Handles that are neither awaited nor cancelled are leaked.
 typedef int64_t SpeedReaderHandle;
 
+// Invoked once the result for handle is ready. See speedreader_submit_with_callback.
+typedef void (*SpeedReaderCallback)(SpeedReaderHandle handle, void* user_data);
+
 // ************
 // Status codes
 // ************
@@ -36,9 +40,64 @@ typedef int64_t SpeedReaderHandle;
 typedef enum {
     SPEEDREADER_OK = 0,
     SPEEDREADER_ERROR = 1,
-    SPEEDREADER_TIMEOUT = 2,  // Only speedreader_await will ever timeout
+    SPEEDREADER_TIMEOUT = 2,  // Only speedreader_await and speedreader_poll will ever timeout
+    SPEEDREADER_WOULD_BLOCK = 3,  // Only speedreader_try_submit will ever return would-block
 } SpeedReaderStatus;
 
+// Layouts accepted by speedreader_submit_pixels, listed in memory order per pixel.
+typedef enum {
+    SPEEDREADER_PIXEL_RGB24 = 0,
+    SPEEDREADER_PIXEL_BGR24 = 1,
+    SPEEDREADER_PIXEL_RGBA32 = 2,  // Alpha is ignored
+    SPEEDREADER_PIXEL_GRAY8 = 3,
+} SpeedReaderPixelFormat;
+
+// ************
+// Binary results
+// ************
+// Packed result layout returned by speedreader_await_binary. All fields are native-endian.
+// Coordinates are in pixels of the submitted image, angles in radians.
+
+typedef struct {
+    double x;
+    double y;
+} SpeedReaderPoint;
+
+typedef struct {
+    double x;  // Top left x
+    double y;  // Top left y
+    double width;
+    double height;
+    double angle;
+} SpeedReaderRotatedRectangle;
+
+typedef struct {
+    double x;  // Top left x
+    double y;  // Top left y
+    double width;
+    double height;
+} SpeedReaderRectangle;
+
+typedef struct {
+    SpeedReaderRotatedRectangle rotated_rectangle;
+    SpeedReaderRectangle rectangle;
+    double confidence;
+    uint32_t polygon_offset;  // Index of the first polygon vertex in SpeedReaderResult.points
+    uint32_t polygon_count;   // Number of polygon vertices
+    uint32_t text_offset;     // Byte offset of the text in SpeedReaderResult.text
+    uint32_t text_len;        // Text length in bytes, UTF-8, excluding the null terminator
+} SpeedReaderTextResult;
+
+typedef struct {
+    uint32_t result_count;
+    uint32_t point_count;
+    uint32_t text_bytes;  // Total size of text, including every null terminator
+    uint32_t reserved;
+    const SpeedReaderTextResult* results;  // result_count entries
+    const SpeedReaderPoint* points;        // point_count entries
+    const char* text;                      // Null-terminated strings, back to back
+} SpeedReaderResult;
+
 // ************
 // API
 // ************
@@ -48,15 +107,51 @@ typedef enum {
 
 // Instance lifecycle.
 // Not thread-safe.
+//
+// All instances in a process share the same models, inference threads and capacity; the first
+// speedreader_create loads them and the last speedreader_destroy releases them. An instance only
+// holds its share of the capacity (see speedreader_set_priority) and its own handles.
 SpeedReaderStatus speedreader_create(
     SpeedReaderInstance* instance,
     char* error
 );
 void speedreader_destroy(SpeedReaderInstance instance);
 
+// Sets an instance's share of the shared capacity, 1 by default. While instances compete, images
+// are admitted in proportion to priority: an instance with priority 2 gets twice the throughput of
+// one with priority 1. Idle capacity is used by whoever has work, whatever their priority.
+// Applies to images submitted after the call.
+// Thread-safe.
+SpeedReaderStatus speedreader_set_priority(
+    SpeedReaderInstance instance,
+    int32_t priority,
+    char* error
+);
+
+// Remembers results for the instance's last max_entries distinct images, so resubmitting one
+// completes immediately without decode or inference. Images are matched by a SHA-256 of their
+// bytes (encoded submissions) or pixels (speedreader_submit_pixels), never across instances.
+// With disk_directory, results are also written there and survive restarts. The directory holds
+// at most max_disk_entries results, oldest written deleted first, and files left there by earlier
+// runs count towards it; 0 means the default of 65536. It should not be shared by instances that
+// must not see each other's results. Results are keyed on the models and options too, so entries
+// from another build or configuration are never served, they age out instead.
+// max_entries 0 turns the cache off (disk_directory must then be NULL). Off by default.
+// Cached results have the same layout as any other.
+// Thread-safe. Applies to images submitted after the call.
+SpeedReaderStatus speedreader_set_result_cache(
+    SpeedReaderInstance instance,
+    int32_t max_entries,
+    const char* disk_directory,
+    int32_t max_disk_entries,
+    char* error
+);
+
 // Submit an encoded image (PNG, JPEG, etc.) for OCR.
 // Returns a handle for retrieving the result.
 // May block under load until the pipeline has capacity (backpressure).
+// The image is copied, so the caller may free image_data as soon as this returns.
+// Decode errors are reported when the handle is awaited.
 // Thread-safe.
 SpeedReaderStatus speedreader_submit(
     SpeedReaderInstance instance,
@@ -66,6 +161,101 @@ SpeedReaderStatus speedreader_submit(
     char* error
 );
 
+// Like speedreader_submit, but calls callback(handle, user_data) on a library thread once the result is ready.
+// The callback should retrieve the result with a zero-timeout await, or hand the handle off to another thread.
+// It must not block: callbacks share a small pool of library threads.
+// Handles submitted this way are not reported by speedreader_poll or the completion fd.
+// The callback may run before this function returns, so *handle is also passed to it.
+// Thread-safe.
+SpeedReaderStatus speedreader_submit_with_callback(
+    SpeedReaderInstance instance,
+    const uint8_t* image_data,
+    size_t image_len,
+    SpeedReaderCallback callback,
+    void* user_data,
+    SpeedReaderHandle* handle,
+    char* error
+);
+
+// Submit a decoded image for OCR, skipping the encode/decode round trip.
+// stride is the distance in bytes between the starts of consecutive rows, at least width * bytes per pixel.
+// Otherwise behaves like speedreader_submit.
+//
+// Lifetime: tightly packed RGB24 (stride == width * 3) is read in place, without copying.
+// The buffer must then stay valid and unmodified until the handle's result is ready, i.e.
+// until speedreader_poll reports the handle or an await returns anything but timeout.
+// speedreader_cancel does not stop inference already reading the buffer, so await the handle instead.
+// Other layouts are currently converted into a copy before this returns.
+// Thread-safe.
+SpeedReaderStatus speedreader_submit_pixels(
+    SpeedReaderInstance instance,
+    const uint8_t* data,
+    int32_t width,
+    int32_t height,
+    int32_t stride,
+    SpeedReaderPixelFormat format,
+    SpeedReaderHandle* handle,
+    char* error
+);
+
+// Submit count encoded images in one call, writing one handle per image to handles.
+// Blocks like speedreader_submit until every image has entered the pipeline.
+// On error, no handles are written. Images that entered the pipeline before the error still run, but their results
+// are discarded.
+// Thread-safe.
+SpeedReaderStatus speedreader_submit_batch(
+    SpeedReaderInstance instance,
+    const uint8_t* const* images,
+    const size_t* image_lens,
+    size_t count,
+    SpeedReaderHandle* handles,
+    char* error
+);
+
+// Non-blocking submit. Submits images in order until the pipeline is full.
+// submitted receives the number of images accepted; handles[0..submitted) are valid.
+// Returns SPEEDREADER_WOULD_BLOCK if fewer than count images were accepted.
+// Thread-safe.
+SpeedReaderStatus speedreader_try_submit(
+    SpeedReaderInstance instance,
+    const uint8_t* const* images,
+    const size_t* image_lens,
+    size_t count,
+    SpeedReaderHandle* handles,
+    size_t* submitted,
+    char* error
+);
+
+// Wait for submitted images to finish, in completion order.
+// Writes up to max handles whose results are ready to handles_out and their number to count.
+// A ready handle completes without blocking when passed to speedreader_await or speedreader_await_binary.
+// Each handle is reported by at most one poll; handles already awaited or cancelled are skipped.
+// timeout_ms < 0:  block until at least one handle is ready
+// timeout_ms == 0: non-blocking check
+// timeout_ms > 0:  block up to timeout_ms milliseconds
+// Returns SPEEDREADER_TIMEOUT if no handle became ready.
+// Thread-safe.
+SpeedReaderStatus speedreader_poll(
+    SpeedReaderInstance instance,
+    int32_t timeout_ms,
+    SpeedReaderHandle* handles_out,
+    size_t max,
+    size_t* count,
+    char* error
+);
+
+// Get an eventfd that becomes readable whenever speedreader_poll has handles to report, for epoll/io_uring loops.
+// Read the fd to reset it, then poll with timeout_ms == 0 until it returns SPEEDREADER_TIMEOUT.
+// Always read before polling, or a completion between the two can be missed.
+// The fd is owned by the instance and closed by speedreader_destroy. Every call returns the same fd.
+// Linux only.
+// Thread-safe.
+SpeedReaderStatus speedreader_completion_fd(
+    SpeedReaderInstance instance,
+    int* fd,
+    char* error
+);
+
 // Retrieve the result of a previously submitted image.
 // timeout_ms < 0:  block until complete
 // timeout_ms == 0: non-blocking poll
@@ -85,6 +275,20 @@ SpeedReaderStatus speedreader_await(
     char* error
 );
 
+// Like speedreader_await, but returns the result in the packed SpeedReaderResult layout.
+// The result lives in a library-owned arena, one per calling thread, that is reused across awaits.
+// It stays valid until the next speedreader_await_binary call on the same thread; do not free it.
+// On SPEEDREADER_TIMEOUT, result is not modified.
+// Consumes the handle regardless of outcome (except timeout).
+// Thread-safe.
+SpeedReaderStatus speedreader_await_binary(
+    SpeedReaderInstance instance,
+    SpeedReaderHandle handle,
+    int32_t timeout_ms,
+    const SpeedReaderResult** result,
+    char* error
+);
+
 // Cancel a submitted image. Consumes the handle.
 // Best-effort: inference already in progress may complete.
 // Thread-safe.
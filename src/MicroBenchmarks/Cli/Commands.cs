@@ -15,6 +15,7 @@ public static class Commands
 
         rootCommand.AddCommand(CreateBdnCommand());
         rootCommand.AddCommand(CreateInferenceCommand());
+        rootCommand.AddCommand(CreateLoadCommand());
 
         return rootCommand;
     }
@@ -112,4 +113,96 @@ public static class Commands
 
         return command;
     }
+
+    private static Command CreateLoadCommand()
+    {
+        var command = new Command("load", "Run an open-loop load test and report latency percentiles");
+
+        var targetOption = new Option<string>(
+            aliases: ["-t", "--target"],
+            getDefaultValue: () => "in-process",
+            description: "What to load (in-process, rest, websocket or native)");
+
+        var urlOption = new Option<Uri>(
+            name: "--url",
+            getDefaultValue: () => new Uri("http://localhost:5000"),
+            description: "Server URL for the rest and websocket targets");
+
+        var libraryOption = new Option<string?>(
+            name: "--library",
+            description: "Path to the SpeedReader shared library for the native target");
+
+        var corpusOption = new Option<string?>(
+            name: "--corpus",
+            description: "Directory of images to send (e.g., benchmarks/icdar2015/test); synthetic images if omitted");
+
+        var limitOption = new Option<int?>(
+            name: "--limit",
+            description: "Use at most this many images from the corpus");
+
+        var rpsOption = new Option<double>(
+            aliases: ["-r", "--rps"],
+            getDefaultValue: () => 0,
+            description: "Requests per second; 0 for closed loop, where every worker sends back to back");
+
+        var concurrencyOption = new Option<int>(
+            aliases: ["-c", "--concurrency"],
+            getDefaultValue: () => 16,
+            description: "Maximum requests in flight");
+
+        var warmupOption = new Option<double>(
+            aliases: ["-w", "--warmup"],
+            getDefaultValue: () => 5.0,
+            description: "Warmup duration in seconds, not measured");
+
+        var durationOption = new Option<double>(
+            aliases: ["-d", "--duration"],
+            getDefaultValue: () => 30.0,
+            description: "Measured duration in seconds");
+
+        var jsonOption = new Option<string?>(
+            name: "--json",
+            description: "Also write the report to this file as JSON");
+
+        command.AddOption(targetOption);
+        command.AddOption(urlOption);
+        command.AddOption(libraryOption);
+        command.AddOption(corpusOption);
+        command.AddOption(limitOption);
+        command.AddOption(rpsOption);
+        command.AddOption(concurrencyOption);
+        command.AddOption(warmupOption);
+        command.AddOption(durationOption);
+        command.AddOption(jsonOption);
+
+        command.SetHandler(async context =>
+        {
+            var targetName = context.ParseResult.GetValueForOption(targetOption)!;
+            var target = targetName.ToLowerInvariant() switch
+            {
+                "in-process" => LoadTargetKind.InProcess,
+                "rest" => LoadTargetKind.Rest,
+                "websocket" => LoadTargetKind.WebSocket,
+                "native" => LoadTargetKind.Native,
+                _ => throw new ArgumentException(
+                    $"Unknown target: {targetName}. Use 'in-process', 'rest', 'websocket' or 'native'.")
+            };
+
+            await LoadBenchmark.Run(new LoadSettings
+            {
+                Target = target,
+                Server = context.ParseResult.GetValueForOption(urlOption)!,
+                LibraryPath = context.ParseResult.GetValueForOption(libraryOption),
+                CorpusDirectory = context.ParseResult.GetValueForOption(corpusOption),
+                Limit = context.ParseResult.GetValueForOption(limitOption),
+                RequestsPerSecond = context.ParseResult.GetValueForOption(rpsOption),
+                Concurrency = context.ParseResult.GetValueForOption(concurrencyOption),
+                WarmupSeconds = context.ParseResult.GetValueForOption(warmupOption),
+                DurationSeconds = context.ParseResult.GetValueForOption(durationOption),
+                JsonPath = context.ParseResult.GetValueForOption(jsonOption)
+            });
+        });
+
+        return command;
+    }
 }
@@ -6,7 +6,6 @@ using Microsoft.Extensions.DependencyInjection;
 using SpeedReader.Ocr.InferenceEngine;
 using SpeedReader.Ocr.InferenceEngine.Engines;
 using SpeedReader.Resources.CharDict;
-using SpeedReader.Resources.Weights;
 
 namespace SpeedReader.MicroBenchmarks.Cli;
 
@@ -21,7 +20,7 @@ public static class InferenceBenchmark
         var quantization = model == Model.DbNet ? Quantization.Int8 : Quantization.Fp32;
         var kernelOptions = new OnnxInferenceKernelOptions(model, quantization, intraThreads, interThreads, profile);
         var engineConfig = new CpuEngineConfig { Kernel = kernelOptions, ReservedPCores = [0, 2, 4, 6] };
-        var weights = model == Model.DbNet ? EmbeddedWeights.Dbnet_Int8 : EmbeddedWeights.Svtr_Fp32;
+        var weights = Factories.GetModelWeights(model, quantization);
 
         var services = new ServiceCollection();
         services.AddKeyedSingleton(model, engineConfig);
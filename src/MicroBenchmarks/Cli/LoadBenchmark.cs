@@ -0,0 +1,345 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Diagnostics;
+using System.Diagnostics.Metrics;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+using System.Threading.Channels;
+using SixLabors.ImageSharp;
+using SpeedReader.Ocr.SmartMetrics;
+
+namespace SpeedReader.MicroBenchmarks.Cli;
+
+public record LoadSettings
+{
+    public required LoadTargetKind Target { get; init; }
+    public Uri Server { get; init; } = new("http://localhost:5000");
+    public string? LibraryPath { get; init; }
+    public string? CorpusDirectory { get; init; }  // Null for a synthetic corpus
+    public int? Limit { get; init; }
+    public double RequestsPerSecond { get; init; }  // 0 for closed loop: every worker sends back to back
+    public int Concurrency { get; init; } = 16;
+    public double WarmupSeconds { get; init; } = 5;
+    public double DurationSeconds { get; init; } = 30;
+    public double DrainSeconds { get; init; } = 10;
+    public string? JsonPath { get; init; }
+}
+
+public record LatencySummary(int Count, double MeanMs, double P50Ms, double P99Ms, double P999Ms, double MaxMs)
+{
+    // Nearest rank, so every percentile is a latency that was actually measured
+    public static LatencySummary Of(List<double> milliseconds)
+    {
+        if (milliseconds.Count == 0)
+            return new LatencySummary(0, 0, 0, 0, 0, 0);
+
+        milliseconds.Sort();
+        return new LatencySummary(milliseconds.Count, milliseconds.Average(), Rank(0.5), Rank(0.99), Rank(0.999),
+            milliseconds[^1]);
+
+        double Rank(double quantile) =>
+            milliseconds[Math.Max(0, (int)Math.Ceiling(quantile * milliseconds.Count) - 1)];
+    }
+}
+
+public record StageSummary(string Stage, string? Model, LatencySummary Latency);
+
+public record LoadReport(
+    string Target,
+    string Corpus,
+    int CorpusImages,
+    double RequestsPerSecond,
+    int Concurrency,
+    double DurationSeconds,
+    int Completed,
+    int Errors,
+    int Unsent,
+    double Throughput,
+    LatencySummary Latency,
+    List<StageSummary> Stages);
+
+[JsonSerializable(typeof(LoadReport))]
+[JsonSourceGenerationOptions(WriteIndented = true, PropertyNamingPolicy = JsonKnownNamingPolicy.SnakeCaseLower)]
+internal partial class LoadReportJsonContext : JsonSerializerContext
+{
+}
+
+// Open-loop load: requests arrive on a fixed schedule whether or not earlier ones have finished, and latency is
+// measured from when each was due rather than when a worker got to it. A target that falls behind shows it in the tail
+// instead of quietly slowing the arrivals down. Only requests due after warmup are measured
+public static class LoadBenchmark
+{
+    private static readonly (int Width, int Height, Density Density)[] SyntheticInputs =
+    [
+        (1080, 720, Density.High),
+        (1080, 720, Density.Low),
+        (640, 480, Density.Low),
+        (1920, 1080, Density.High)
+    ];
+
+    public static async Task<LoadReport> Run(LoadSettings settings)
+    {
+        var corpus = LoadCorpus(settings);
+        Console.Error.WriteLine($"Corpus: {corpus.Count} images");
+
+        // Stage timings are only visible in-process; remote targets report end-to-end latency only
+        using var stages = new StageRecorder();
+        await using var target = CreateTarget(settings);
+        var clients = await Task.WhenAll(Enumerable.Range(0, settings.Concurrency).Select(_ => target.Connect()));
+
+        var start = Stopwatch.GetTimestamp();
+        var measureFrom = start + Ticks(settings.WarmupSeconds);
+        var stopAt = measureFrom + Ticks(settings.DurationSeconds);
+        var drainUntil = stopAt + Ticks(settings.DrainSeconds);
+        stages.Measure(measureFrom, stopAt);
+
+        var latencies = new List<double>();
+        var errors = 0;
+        var unsent = 0;
+        var lastCompletion = measureFrom;
+        var nextImage = -1;
+
+        var arrivals = Channel.CreateUnbounded<long>(new UnboundedChannelOptions { SingleWriter = true });
+        var producer = settings.RequestsPerSecond > 0
+            ? Schedule(arrivals.Writer, start, stopAt, settings.RequestsPerSecond)
+            : Task.CompletedTask;
+
+        var workers = clients.Select(client => Task.Run(async () =>
+        {
+            while (true)
+            {
+                long due;
+                if (settings.RequestsPerSecond > 0)
+                {
+                    if (!arrivals.Reader.TryRead(out due))
+                    {
+                        if (!await arrivals.Reader.WaitToReadAsync())
+                            break;
+                        continue;
+                    }
+                    if (Stopwatch.GetTimestamp() > drainUntil)
+                    {
+                        Interlocked.Increment(ref unsent);  // Still queued long after the run ended
+                        continue;
+                    }
+                }
+                else
+                {
+                    due = Stopwatch.GetTimestamp();
+                    if (due >= stopAt)
+                        break;
+                }
+
+                var image = corpus[(int)((uint)Interlocked.Increment(ref nextImage) % corpus.Count)];
+                var measured = due >= measureFrom;
+
+                try
+                {
+                    await client.Send(image);
+                }
+                catch (Exception ex)
+                {
+                    if (measured && Interlocked.Increment(ref errors) == 1)
+                        Console.Error.WriteLine($"First error: {ex.Message}");
+                    continue;
+                }
+
+                var completed = Stopwatch.GetTimestamp();
+                if (!measured)
+                    continue;
+                lock (latencies)
+                {
+                    latencies.Add(Stopwatch.GetElapsedTime(due, completed).TotalMilliseconds);
+                    lastCompletion = Math.Max(lastCompletion, completed);
+                }
+            }
+        })).ToList();
+
+        await producer;
+        await Task.WhenAll(workers);
+        foreach (var client in clients.Distinct().Where(client => !ReferenceEquals(client, target)))
+            await client.DisposeAsync();
+
+        var elapsed = Stopwatch.GetElapsedTime(measureFrom, Math.Max(lastCompletion, stopAt)).TotalSeconds;
+        var report = new LoadReport(
+            Target: settings.Target.ToString(),
+            Corpus: settings.CorpusDirectory ?? "synthetic",
+            CorpusImages: corpus.Count,
+            RequestsPerSecond: settings.RequestsPerSecond,
+            Concurrency: settings.Concurrency,
+            DurationSeconds: settings.DurationSeconds,
+            Completed: latencies.Count,
+            Errors: errors,
+            Unsent: unsent,
+            Throughput: latencies.Count / elapsed,
+            Latency: LatencySummary.Of(latencies),
+            Stages: stages.Summarize());
+
+        Print(report);
+        if (settings.JsonPath != null)
+        {
+            await File.WriteAllTextAsync(settings.JsonPath,
+                JsonSerializer.Serialize(report, LoadReportJsonContext.Default.LoadReport));
+        }
+
+        return report;
+    }
+
+    private static ILoadTarget CreateTarget(LoadSettings settings) => settings.Target switch
+    {
+        LoadTargetKind.InProcess => new InProcessTarget(),
+        LoadTargetKind.Rest => new RestTarget(settings.Server),
+        LoadTargetKind.WebSocket => new WebSocketTarget(settings.Server),
+        LoadTargetKind.Native => new NativeTarget(settings.LibraryPath
+            ?? throw new ArgumentException("The native target needs the path to the published library")),
+        _ => throw new ArgumentOutOfRangeException(nameof(settings))
+    };
+
+    // Encoded up front, so the benchmark never spends time on images while it's measuring
+    private static List<ReadOnlyMemory<byte>> LoadCorpus(LoadSettings settings)
+    {
+        List<ReadOnlyMemory<byte>> corpus;
+        if (settings.CorpusDirectory is { } directory)
+        {
+            corpus = Directory.EnumerateFiles(directory)
+                .Where(path => Path.GetExtension(path).ToLowerInvariant() is ".jpg" or ".jpeg" or ".png")
+                .Order()
+                .Take(settings.Limit ?? int.MaxValue)
+                .Select(path => (ReadOnlyMemory<byte>)File.ReadAllBytes(path))
+                .ToList();
+        }
+        else
+        {
+            corpus = SyntheticInputs
+                .Take(settings.Limit ?? int.MaxValue)
+                .Select(input =>
+                {
+                    using var image = InputGenerator.GenerateInput(input.Width, input.Height, input.Density);
+                    using var stream = new MemoryStream();
+                    image.SaveAsJpeg(stream);
+                    return (ReadOnlyMemory<byte>)stream.ToArray();
+                })
+                .ToList();
+        }
+
+        return corpus.Count > 0 ? corpus : throw new ArgumentException("The corpus has no images");
+    }
+
+    // Releases every arrival that's due, then sleeps until the next. Timer granularity only delays a release, the due
+    // time it carries is still the scheduled one
+    private static async Task Schedule(ChannelWriter<long> arrivals, long start, long stopAt, double requestsPerSecond)
+    {
+        var interval = Stopwatch.Frequency / requestsPerSecond;
+        var sent = 0L;
+        try
+        {
+            while (true)
+            {
+                var now = Stopwatch.GetTimestamp();
+                long due;
+                while ((due = start + (long)(sent * interval)) <= now && due < stopAt)
+                {
+                    arrivals.TryWrite(due);
+                    sent++;
+                }
+                if (due >= stopAt)
+                    return;
+
+                var wait = Stopwatch.GetElapsedTime(now, due);
+                await Task.Delay(wait > TimeSpan.FromMilliseconds(1) ? wait : TimeSpan.FromMilliseconds(1));
+            }
+        }
+        finally
+        {
+            arrivals.Complete();
+        }
+    }
+
+    private static long Ticks(double seconds) => (long)(seconds * Stopwatch.Frequency);
+
+    private static void Print(LoadReport report)
+    {
+        Console.WriteLine($"Target {report.Target}, {report.Concurrency} workers, " +
+            (report.RequestsPerSecond > 0 ? $"{report.RequestsPerSecond} req/s offered" : "closed loop"));
+        Console.WriteLine($"Completed {report.Completed}, errors {report.Errors}, unsent {report.Unsent}, " +
+            $"throughput {report.Throughput:F1} req/s");
+        Console.WriteLine();
+        Console.WriteLine("| Stage | Model | Count | Mean (ms) | p50 (ms) | p99 (ms) | p99.9 (ms) |");
+        Console.WriteLine("|-------|-------|-------|-----------|----------|----------|------------|");
+        Row("end_to_end", null, report.Latency);
+        foreach (var stage in report.Stages)
+            Row(stage.Stage, stage.Model, stage.Latency);
+
+        static void Row(string stage, string? model, LatencySummary latency) => Console.WriteLine(
+            $"| {stage} | {model ?? "-"} | {latency.Count} | {latency.MeanMs:F2} | {latency.P50Ms:F2} | " +
+            $"{latency.P99Ms:F2} | {latency.P999Ms:F2} |");
+    }
+
+    // Collects the stage timings the pipeline in this process records during the measured window
+    private sealed class StageRecorder : IDisposable
+    {
+        private readonly MeterListener _listener = new();
+        private readonly Dictionary<(string Stage, string? Model), List<double>> _timings = [];
+        private long _from = long.MaxValue;
+        private long _until = long.MaxValue;
+
+        public StageRecorder()
+        {
+            _listener.InstrumentPublished = (instrument, listener) =>
+            {
+                if (instrument.Meter.Name == StageTimings.MeterName)
+                    listener.EnableMeasurementEvents(instrument);
+            };
+            _listener.SetMeasurementEventCallback<double>(OnMeasurement);
+            _listener.Start();
+        }
+
+        public void Measure(long from, long until)
+        {
+            Volatile.Write(ref _until, until);
+            Volatile.Write(ref _from, from);
+        }
+
+        // A stage counts by when it finished, so images due at the edge of the window may contribute only some stages
+        private void OnMeasurement(Instrument instrument, double milliseconds,
+            ReadOnlySpan<KeyValuePair<string, object?>> tags, object? state)
+        {
+            var now = Stopwatch.GetTimestamp();
+            if (now < Volatile.Read(ref _from) || now >= Volatile.Read(ref _until))
+                return;
+
+            string? stage = null, model = null;
+            foreach (var (key, value) in tags)
+            {
+                if (key == "stage")
+                    stage = value as string;
+                else if (key == "model")
+                    model = value as string;
+            }
+            if (stage == null)
+                return;
+
+            lock (_timings)
+            {
+                if (!_timings.TryGetValue((stage, model), out var timings))
+                    _timings[(stage, model)] = timings = [];
+                timings.Add(milliseconds);
+            }
+        }
+
+        public List<StageSummary> Summarize()
+        {
+            lock (_timings)
+            {
+                return _timings
+                    .OrderBy(entry => entry.Key.Stage)
+                    .ThenBy(entry => entry.Key.Model)
+                    .Select(entry => new StageSummary(entry.Key.Stage, entry.Key.Model, LatencySummary.Of(entry.Value)))
+                    .ToList();
+            }
+        }
+
+        public void Dispose() => _listener.Dispose();
+    }
+}
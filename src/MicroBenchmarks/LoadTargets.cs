@@ -0,0 +1,256 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Net.Http.Headers;
+using System.Net.WebSockets;
+using System.Runtime.InteropServices;
+using System.Text.Json;
+using Microsoft.Extensions.DependencyInjection;
+using SpeedReader.Ocr;
+using SpeedReader.Ocr.InferenceEngine;
+using unsafe SpeedReaderCallback = delegate* unmanaged<long, nint, void>;
+using unsafe SubmitWithCallbackFn =
+    delegate* unmanaged<long, byte*, nuint, delegate* unmanaged<long, nint, void>, nint, long*, byte*, int>;
+using unsafe AwaitFn = delegate* unmanaged<long, long, int, byte**, nuint*, byte*, int>;
+
+namespace SpeedReader.MicroBenchmarks;
+
+public enum LoadTargetKind
+{
+    InProcess,
+    Rest,
+    WebSocket,
+    Native
+}
+
+// Something the load benchmark can send images to. Each worker connects its own client, so a websocket never carries
+// two requests at once and latency is per request, not per connection
+public interface ILoadTarget : IAsyncDisposable
+{
+    Task<ILoadClient> Connect();
+}
+
+public interface ILoadClient : IAsyncDisposable
+{
+    // Completes once the result is back. Throws if the target reported an error
+    Task Send(ReadOnlyMemory<byte> encodedImage);
+}
+
+// The server's pipeline, in this process, so its stage timings can be listened to directly
+public sealed class InProcessTarget : ILoadTarget, ILoadClient
+{
+    private readonly ServiceProvider _serviceProvider;
+    private readonly OcrPipeline _pipeline;
+
+    public InProcessTarget()
+    {
+        var options = new OcrPipelineOptions
+        {
+            DetectionOptions = new DetectionOptions(),
+            RecognitionOptions = new RecognitionOptions(),
+            DetectionEngine = new CpuEngineConfig
+            {
+                Kernel = new OnnxInferenceKernelOptions(
+                    model: Model.DbNet,
+                    quantization: Quantization.Int8,
+                    numIntraOpThreads: 1),
+                MaxParallelism = 1
+            },
+            RecognitionEngine = new CpuEngineConfig
+            {
+                Kernel = new OnnxInferenceKernelOptions(
+                    model: Model.Svtr,
+                    quantization: Quantization.Fp32,
+                    numIntraOpThreads: 1),
+                MaxParallelism = 1,
+                MaxBatchSize = 8
+            },
+            Visualize = false
+        };
+
+        var services = new ServiceCollection();
+        services.AddMetrics();  // Without a meter factory there are no stage timings to report
+        services.AddOcrPipeline(options);
+        _serviceProvider = services.BuildServiceProvider();
+        _pipeline = _serviceProvider.GetRequiredService<OcrPipeline>();
+    }
+
+    public Task<ILoadClient> Connect() => Task.FromResult<ILoadClient>(this);
+
+    public async Task Send(ReadOnlyMemory<byte> encodedImage)
+    {
+        var result = await await _pipeline.ReadOne(encodedImage);
+        result.Image?.Dispose();
+    }
+
+    public ValueTask DisposeAsync() => _serviceProvider.DisposeAsync();
+}
+
+public sealed class RestTarget : ILoadTarget, ILoadClient
+{
+    private readonly HttpClient _client;
+
+    public RestTarget(Uri server) =>
+        _client = new HttpClient { BaseAddress = server, Timeout = Timeout.InfiniteTimeSpan };
+
+    public Task<ILoadClient> Connect() => Task.FromResult<ILoadClient>(this);  // HttpClient pools its own connections
+
+    public async Task Send(ReadOnlyMemory<byte> encodedImage)
+    {
+        using var content = new ReadOnlyMemoryContent(encodedImage);
+        content.Headers.ContentType = new MediaTypeHeaderValue("application/octet-stream");
+        using var response = await _client.PostAsync("/api/ocr", content);
+        await response.Content.CopyToAsync(Stream.Null);  // Done when the whole body is in, not at the headers
+        response.EnsureSuccessStatusCode();
+    }
+
+    public ValueTask DisposeAsync()
+    {
+        _client.Dispose();
+        return ValueTask.CompletedTask;
+    }
+}
+
+public sealed class WebSocketTarget(Uri server) : ILoadTarget
+{
+    private readonly Uri _endpoint = new UriBuilder(server)
+    {
+        Scheme = server.Scheme == Uri.UriSchemeHttps ? "wss" : "ws",
+        Path = "/api/ws/ocr"
+    }.Uri;
+
+    public async Task<ILoadClient> Connect()
+    {
+        var socket = new ClientWebSocket();
+        await socket.ConnectAsync(_endpoint, CancellationToken.None);
+        return new Client(socket);
+    }
+
+    public ValueTask DisposeAsync() => ValueTask.CompletedTask;
+
+    private sealed class Client(ClientWebSocket socket) : ILoadClient
+    {
+        private readonly byte[] _buffer = new byte[16384];
+        private readonly MemoryStream _response = new();
+
+        public async Task Send(ReadOnlyMemory<byte> encodedImage)
+        {
+            await socket.SendAsync(encodedImage, WebSocketMessageType.Binary, endOfMessage: true,
+                CancellationToken.None);
+
+            _response.SetLength(0);
+            ValueWebSocketReceiveResult received;
+            do
+            {
+                received = await socket.ReceiveAsync(_buffer.AsMemory(), CancellationToken.None);
+                if (received.MessageType == WebSocketMessageType.Close)
+                    throw new WebSocketException("Server closed the connection");
+                _response.Write(_buffer, 0, received.Count);
+            } while (!received.EndOfMessage);
+
+            // Errors come back in-band as {"error": "..."}
+            using var json = JsonDocument.Parse(_response.GetBuffer().AsMemory(0, (int)_response.Length));
+            if (json.RootElement.TryGetProperty("error", out var error))
+                throw new InvalidOperationException(error.GetString());
+        }
+
+        public async ValueTask DisposeAsync()
+        {
+            if (socket.State == WebSocketState.Open)
+                await socket.CloseAsync(WebSocketCloseStatus.NormalClosure, "Done", CancellationToken.None);
+            socket.Dispose();
+        }
+    }
+}
+
+// speedreader.h, loaded from the published shared library. Results come back through
+// speedreader_submit_with_callback, so waiting for them doesn't hold a thread
+public sealed unsafe class NativeTarget : ILoadTarget, ILoadClient
+{
+    private const int ErrorBufferSize = 256;  // SPEEDREADER_ERROR_BUF_SIZE
+    private const int Ok = 0;
+
+    private readonly nint _library;
+    private readonly long _instance;
+    private readonly SubmitWithCallbackFn _submitWithCallback;
+    private readonly AwaitFn _await;
+    private readonly delegate* unmanaged<byte*, void> _freeResult;
+    private readonly delegate* unmanaged<long, void> _destroy;
+
+    public NativeTarget(string libraryPath)
+    {
+        _library = NativeLibrary.Load(libraryPath);
+        var create = (delegate* unmanaged<long*, byte*, int>)NativeLibrary.GetExport(_library, "speedreader_create");
+        _submitWithCallback =
+            (SubmitWithCallbackFn)NativeLibrary.GetExport(_library, "speedreader_submit_with_callback");
+        _await = (AwaitFn)NativeLibrary.GetExport(_library, "speedreader_await");
+        _freeResult = (delegate* unmanaged<byte*, void>)NativeLibrary.GetExport(_library, "speedreader_free_result");
+        _destroy = (delegate* unmanaged<long, void>)NativeLibrary.GetExport(_library, "speedreader_destroy");
+
+        long instance;
+        var error = stackalloc byte[ErrorBufferSize];
+        if (create(&instance, error) != Ok)
+            throw new InvalidOperationException($"speedreader_create failed: {Message(error)}");
+        _instance = instance;
+    }
+
+    public Task<ILoadClient> Connect() => Task.FromResult<ILoadClient>(this);
+
+    public Task Send(ReadOnlyMemory<byte> encodedImage)
+    {
+        var pending = new Pending(this);
+        var state = GCHandle.Alloc(pending);
+        var error = stackalloc byte[ErrorBufferSize];
+        long handle;
+        int status;
+        fixed (byte* image = encodedImage.Span)  // The library copies the image before returning
+        {
+            status = _submitWithCallback(_instance, image, (nuint)encodedImage.Length, (SpeedReaderCallback)&OnComplete,
+                GCHandle.ToIntPtr(state), &handle, error);
+        }
+
+        if (status != Ok)
+        {
+            state.Free();
+            return Task.FromException(new InvalidOperationException($"speedreader_submit failed: {Message(error)}"));
+        }
+        return pending.Task;
+    }
+
+    [UnmanagedCallersOnly]
+    private static void OnComplete(long handle, nint userData)
+    {
+        var state = GCHandle.FromIntPtr(userData);
+        var pending = (Pending)state.Target!;
+        state.Free();
+        pending.Complete(handle);
+    }
+
+    public ValueTask DisposeAsync()
+    {
+        _destroy(_instance);
+        NativeLibrary.Free(_library);
+        return ValueTask.CompletedTask;
+    }
+
+    private static string Message(byte* error) => Marshal.PtrToStringUTF8((nint)error) ?? "unknown error";
+
+    // Continuations run off the library's callback threads, which must not block
+    private sealed class Pending(NativeTarget target)
+        : TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously)
+    {
+        public void Complete(long handle)
+        {
+            byte* result;
+            nuint length;
+            var error = stackalloc byte[ErrorBufferSize];
+            if (target._await(target._instance, handle, 0, &result, &length, error) != Ok)
+            {
+                SetException(new InvalidOperationException($"speedreader_await failed: {Message(error)}"));
+                return;
+            }
+            target._freeResult(result);
+            SetResult();
+        }
+    }
+}
@@ -15,6 +15,7 @@ namespace SpeedReader.MicroBenchmarks;
 public class StartupBenchmark
 {
     private string _imagePath = null!;
+    private string _modelCacheDirectory = null!;
 
     [GlobalSetup]
     public void GlobalSetup()
@@ -23,9 +24,18 @@ public class StartupBenchmark
         _imagePath = "/tmp/startup_benchmark.png";
         image.SaveAsPng(_imagePath);
         image.Dispose();
+
+        // Populate the optimized model cache once so every WarmCacheStart iteration loads from it
+        _modelCacheDirectory = "/tmp/startup_benchmark_model_cache";
+        SpeedReader.Frontend.Program.Main([_imagePath, "--model-cache", _modelCacheDirectory]).GetAwaiter().GetResult();
     }
 
     [Benchmark]
     [MethodImpl(MethodImplOptions.NoInlining)]
     public async Task<int> ColdStart() => await SpeedReader.Frontend.Program.Main([_imagePath]);
+
+    [Benchmark]
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    public async Task<int> WarmCacheStart() =>
+        await SpeedReader.Frontend.Program.Main([_imagePath, "--model-cache", _modelCacheDirectory]);
 }
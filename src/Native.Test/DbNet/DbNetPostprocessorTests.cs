@@ -0,0 +1,96 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Native.DbNet;
+
+namespace SpeedReader.Native.Test.DbNet;
+
+public class DbNetPostprocessorTests
+{
+    private static DbNetBoxOptions Options(int width, int height) => new()
+    {
+        Threshold = 0.2f,
+        SimplifyEpsilon = 4,
+        Scale = 1,
+        DilationRatio = 1.5,
+        MaxX = width - 1,
+        MaxY = height - 1
+    };
+
+    private static void Fill(float[] map, int width, int left, int top, int right, int bottom, float value)
+    {
+        for (var y = top; y < bottom; y++)
+            map.AsSpan(y * width + left, right - left).Fill(value);
+    }
+
+    [Fact]
+    public void MergeTile_Overlap_TakesMax()
+    {
+        var composite = new float[20 * 10];
+        var tile = Enumerable.Range(0, 8 * 5).Select(i => i / 40f).ToArray();
+
+        DbNetPostprocessor.MergeTile(composite, 20, tile, 8, 5, left: 3, top: 2);
+        DbNetPostprocessor.MergeTile(composite, 20, tile, 8, 5, left: 5, top: 2);
+
+        for (var y = 0; y < 10; y++)
+        {
+            for (var x = 0; x < 20; x++)
+            {
+                var expected = 0f;
+                if (y is >= 2 and < 7 && x is >= 3 and < 11)
+                    expected = Math.Max(expected, tile[(y - 2) * 8 + x - 3]);
+                if (y is >= 2 and < 7 && x is >= 5 and < 13)
+                    expected = Math.Max(expected, tile[(y - 2) * 8 + x - 5]);
+                Assert.Equal(expected, composite[y * 20 + x]);
+            }
+        }
+    }
+
+    [Fact]
+    public void MergeTile_OutsideComposite_Throws() =>
+        Assert.Throws<ArgumentOutOfRangeException>(() =>
+            DbNetPostprocessor.MergeTile(new float[100], 10, new float[16], 4, 4, left: 8, top: 0));
+
+    [Fact]
+    public void FindBoxes_Rectangle_DilatesByAreaOverPerimeter()
+    {
+        var map = new float[100 * 60];
+        Fill(map, 100, 10, 10, 50, 20, 0.9f);
+        Fill(map, 100, 70, 40, 72, 42, 0.9f);  // Removed by the opening
+
+        var boxes = DbNetPostprocessor.FindBoxes(map, 100, 60, Options(100, 60), out var pendingTop);
+
+        var box = Assert.Single(boxes);
+        Assert.Equal(int.MaxValue, pendingTop);
+
+        // Pixel centers span 39 x 9, so the offset is 351 * 1.5 / 96
+        var offset = 39.0 * 9 * 1.5 / 96;
+        var xs = Enumerable.Range(0, 4).Select(i => box.Corners[2 * i]).ToList();
+        var ys = Enumerable.Range(0, 4).Select(i => box.Corners[2 * i + 1]).ToList();
+        Assert.Equal(10 - offset, xs.Min(), 6);
+        Assert.Equal(49 + offset, xs.Max(), 6);
+        Assert.Equal(10 - offset, ys.Min(), 6);
+        Assert.Equal(19 + offset, ys.Max(), 6);
+        Assert.True(box.Polygon.Length >= 8);
+    }
+
+    [Fact]
+    public void FindBoxes_RegionsEndingPastMaxBottom_ArePending()
+    {
+        var map = new float[100 * 60];
+        Fill(map, 100, 10, 10, 50, 20, 0.9f);
+        Fill(map, 100, 10, 30, 50, 45, 0.9f);
+
+        var boxes = DbNetPostprocessor.FindBoxes(map, 100, 60,
+            Options(100, 80) with { RowOffset = 20, MaxBottom = 50 }, out var pendingTop);
+
+        var box = Assert.Single(boxes);
+        Assert.True(box.Corners.Where((_, i) => i % 2 == 1).Max() < 50);  // Rows are offset
+        Assert.Equal(50, pendingTop);
+    }
+
+    [Fact]
+    public void FindBoxes_WrongLength_Throws() =>
+        Assert.Throws<ArgumentException>(() =>
+            DbNetPostprocessor.FindBoxes(new float[10], 4, 4, Options(4, 4), out _));
+}
@@ -69,4 +69,56 @@ public class InferenceSessionConstructionTests
         using var session = new InferenceSession(modelData, options);
         Assert.NotNull(session);
     }
+
+    [Fact]
+    public void CreateSession_WithOptimizedModelPath_WritesCacheThenLoadsIt()
+    {
+        var modelData = EmbeddedWeights.Dbnet_Int8.Bytes;
+        var cachePath = Path.Combine(Path.GetTempPath(), $"{Guid.NewGuid()}.ort");
+        try
+        {
+            var options = new SessionOptions().WithOptimizedModelPath(cachePath);
+
+            using (new InferenceSession(modelData, options))
+                Assert.True(File.Exists(cachePath));
+
+            var cacheWriteTime = File.GetLastWriteTimeUtc(cachePath);
+            using var cachedSession = new InferenceSession(modelData, options);
+            Assert.Equal(cacheWriteTime, File.GetLastWriteTimeUtc(cachePath));  // Loaded, not rewritten
+        }
+        finally
+        {
+            File.Delete(cachePath);
+        }
+    }
+
+    [Fact]
+    public void CreateSession_WithCorruptOptimizedModel_RebuildsIt()
+    {
+        var modelData = EmbeddedWeights.Dbnet_Int8.Bytes;
+        var cachePath = Path.Combine(Path.GetTempPath(), $"{Guid.NewGuid()}.ort");
+        try
+        {
+            File.WriteAllBytes(cachePath, [0x00, 0x01, 0x02, 0x03]);
+
+            using var session = new InferenceSession(modelData, new SessionOptions().WithOptimizedModelPath(cachePath));
+
+            Assert.NotEqual(4, new FileInfo(cachePath).Length);
+        }
+        finally
+        {
+            File.Delete(cachePath);
+        }
+    }
+
+    [Fact]
+    public void CreateSession_WithUnwritableOptimizedModelPath_Succeeds()
+    {
+        var modelData = EmbeddedWeights.Dbnet_Int8.Bytes;
+        var cachePath = Path.Combine(Path.GetTempPath(), Guid.NewGuid().ToString(), "missing", "dbnet.ort");
+
+        using var session = new InferenceSession(modelData, new SessionOptions().WithOptimizedModelPath(cachePath));
+
+        Assert.False(File.Exists(cachePath));
+    }
 }
@@ -1,6 +1,7 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
+using System.Buffers;
 using SpeedReader.Native.Onnx;
 using SpeedReader.Resources.Weights;
 
@@ -34,6 +35,63 @@ public class InferenceSessionRunTests
         session.Run(input, output);
     }
 
+    [Fact]
+    public void RunArgmax_WithSvtrv2_MatchesArgmaxOfRun()
+    {
+        var model = EmbeddedWeights.Svtr_Fp32.Bytes;
+        using var session = new InferenceSession(model);
+        const int width = 160;
+        const int steps = width / 8;
+        var random = new Random(0);
+        var inputData = new float[1 * 3 * 48 * width];
+        for (int i = 0; i < inputData.Length; i++)
+            inputData[i] = (float)random.NextDouble() * 2 - 1;
+        var input = OrtValue.Create(inputData.AsMemory(), [1, 3, 48, width]);
+
+        var logits = new float[steps * 6625];
+        session.Run(input, OrtValue.Create(logits.AsMemory(), [1, steps, 6625]));
+        var pairs = new float[steps * 2];
+        session.RunArgmax(input, OrtValue.Create(pairs.AsMemory(), [1, steps, 2]));
+
+        for (int step = 0; step < steps; step++)
+        {
+            var row = logits.AsSpan(step * 6625, 6625);
+            var expected = row.IndexOf(row.ToArray().Max());
+            Assert.Equal(expected, (int)pairs[2 * step]);
+            Assert.Equal(row[expected], pairs[2 * step + 1]);
+        }
+    }
+
+    [Fact]
+    public void RunArgmax_WithWrongSteps_Throws()
+    {
+        var model = EmbeddedWeights.Svtr_Fp32.Bytes;
+        using var session = new InferenceSession(model);
+        var input = OrtValue.Create(new float[1 * 3 * 48 * 160].AsMemory(), [1, 3, 48, 160]);
+        var output = OrtValue.Create(new float[21 * 2].AsMemory(), [1, 21, 2]);
+        var exception = Assert.Throws<OrtException>(() => session.RunArgmax(input, output));
+        Assert.Contains("output shape mismatch", exception.Message);
+    }
+
+    [Fact]
+    public void Run_WritesIntoOutputBufferInPlace()
+    {
+        var model = EmbeddedWeights.Dbnet_Int8.Bytes;
+        using var session = new InferenceSession(model);
+        var inputData = new float[640 * 640 * 3];
+
+        // Output is a slice of a larger buffer, as with pooled buffers; the guard elements must stay untouched
+        var backing = new float[640 * 640 + 2];
+        Array.Fill(backing, float.NaN);
+        var input = OrtValue.Create(inputData.AsMemory(), [1, 3, 640, 640]);
+        var output = OrtValue.Create(backing.AsMemory(1, 640 * 640), [1, 640, 640]);
+        session.Run(input, output);
+
+        Assert.True(float.IsNaN(backing[0]));
+        Assert.True(float.IsNaN(backing[^1]));
+        Assert.DoesNotContain(backing[1..^1], float.IsNaN);
+    }
+
     [Fact]
     public void Run_WithInvalidInput_Throws()
     {
@@ -96,6 +154,47 @@ public class InferenceSessionRunTests
         Assert.Contains("Output shape mismatch", exception.Message);
     }
 
+    [Fact]
+    public void Run_WithUncancelledToken_Works()
+    {
+        var model = EmbeddedWeights.Dbnet_Int8.Bytes;
+        using var session = new InferenceSession(model);
+        using var cts = new CancellationTokenSource();
+        var input = OrtValue.Create(new float[640 * 640 * 3].AsMemory(), [1, 3, 640, 640]);
+        var output = OrtValue.Create(new float[640 * 640].AsMemory(), [1, 640, 640]);
+        session.Run(input, output, cts.Token);
+    }
+
+    [Fact]
+    public void Run_WithCancelledToken_ThrowsOperationCanceledException()
+    {
+        var model = EmbeddedWeights.Dbnet_Int8.Bytes;
+        using var session = new InferenceSession(model);
+        var input = OrtValue.Create(new float[640 * 640 * 3].AsMemory(), [1, 3, 640, 640]);
+        var output = OrtValue.Create(new float[640 * 640].AsMemory(), [1, 640, 640]);
+        Assert.Throws<OperationCanceledException>(() => session.Run(input, output, new CancellationToken(true)));
+    }
+
+    [Fact]
+    public void Run_CancelledMidRun_ThrowsOperationCanceledException()
+    {
+        var model = EmbeddedWeights.Dbnet_Int8.Bytes;
+        using var session = new InferenceSession(model);
+        using var cts = new CancellationTokenSource();
+        var input = OrtValue.Create(new float[640 * 640 * 3].AsMemory(), [1, 3, 640, 640]);
+
+        // The output is pinned after the token check, right before the native run, so cancelling there always lands
+        // on a run that is already underway
+        using var outputMemory = new CancelOnPin(new float[640 * 640], cts);
+        var output = OrtValue.Create(outputMemory.Memory, [1, 640, 640]);
+        Assert.Throws<OperationCanceledException>(() => session.Run(input, output, cts.Token));
+
+        // Cancellation is scoped to the cancelled run, later runs on the same session succeed
+        var smallInput = OrtValue.Create(new float[640 * 640 * 3].AsMemory(), [1, 3, 640, 640]);
+        var smallOutput = OrtValue.Create(new float[640 * 640].AsMemory(), [1, 640, 640]);
+        session.Run(smallInput, smallOutput);
+    }
+
     [Fact]
     public void Run_Concurrently_Succeeds()
     {
@@ -140,4 +239,19 @@ public class InferenceSessionRunTests
 
         Assert.Empty(exceptions);
     }
+
+    private sealed class CancelOnPin(float[] array, CancellationTokenSource cts) : MemoryManager<float>
+    {
+        public override Span<float> GetSpan() => array;
+
+        public override MemoryHandle Pin(int elementIndex = 0)
+        {
+            cts.Cancel();
+            return array.AsMemory(elementIndex).Pin();
+        }
+
+        public override void Unpin() { }
+
+        protected override void Dispose(bool disposing) { }
+    }
 }
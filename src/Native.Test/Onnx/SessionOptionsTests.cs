@@ -15,6 +15,7 @@ public class SessionOptionsTests
         Assert.Equal(1, options.IntraOpNumThreads);
         Assert.Equal(1, options.InterOpNumThreads);
         Assert.False(options.EnableProfiling);
+        Assert.Null(options.OptimizedModelPath);
     }
 
     [Fact]
@@ -53,6 +54,17 @@ public class SessionOptionsTests
         Assert.False(options.EnableProfiling);
     }
 
+    [Fact]
+    public void WithOptimizedModelPath_Whitespace_ThrowsArgumentException() =>
+        Assert.Throws<ArgumentException>(() => new SessionOptions().WithOptimizedModelPath(" "));
+
+    [Fact]
+    public void WithOptimizedModelPath_Null_DisablesCache()
+    {
+        var options = new SessionOptions().WithOptimizedModelPath("/tmp/model.ort").WithOptimizedModelPath(null);
+        Assert.Null(options.OptimizedModelPath);
+    }
+
     [Fact]
     public void ChainedOptions_SetsAllValues()
     {
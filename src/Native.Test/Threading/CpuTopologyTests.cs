@@ -0,0 +1,156 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Native.Threading;
+
+namespace SpeedReader.Native.Test.Threading;
+
+public class CpuTopologyTests : IDisposable
+{
+    private readonly string _root = Directory.CreateTempSubdirectory("cpu-topology-").FullName;
+
+    public void Dispose() => Directory.Delete(_root, recursive: true);
+
+    private void WriteFile(string path, string contents)
+    {
+        var fullPath = Path.Combine(_root, path);
+        Directory.CreateDirectory(Path.GetDirectoryName(fullPath)!);
+        File.WriteAllText(fullPath, contents + "\n");
+    }
+
+    private void WriteCpu(int id, string siblings, int? capacity = null)
+    {
+        WriteFile($"sys/devices/system/cpu/cpu{id}/topology/thread_siblings_list", siblings);
+        if (capacity != null)
+            WriteFile($"sys/devices/system/cpu/cpu{id}/cpu_capacity", capacity.Value.ToString());
+    }
+
+    [Theory]
+    [InlineData("0", new[] { 0 })]
+    [InlineData("0-3", new[] { 0, 1, 2, 3 })]
+    [InlineData("0-1,4,6-7\n", new[] { 0, 1, 4, 6, 7 })]
+    public void ParseCpuList_ParsesKernelFormat(string list, int[] expected) =>
+        Assert.Equal(expected, LinuxCpuTopology.ParseCpuList(list));
+
+    [Fact]
+    public void ParseCpuList_ReversedRange_Throws() =>
+        Assert.Throws<FormatException>(() => LinuxCpuTopology.ParseCpuList("3-1"));
+
+    [Fact]
+    public void Read_IntelHybrid_SplitsCoresAndDropsSmtSiblings()
+    {
+        // 2 hyperthreaded P-cores (0-3) and 2 E-cores (4-5)
+        WriteFile("sys/devices/system/cpu/online", "0-5");
+        WriteCpu(0, "0-1");
+        WriteCpu(1, "0-1");
+        WriteCpu(2, "2-3");
+        WriteCpu(3, "2-3");
+        WriteCpu(4, "4");
+        WriteCpu(5, "5");
+        WriteFile("sys/devices/cpu_atom/cpus", "4-5");
+
+        var topology = LinuxCpuTopology.Read(_root);
+
+        Assert.Equal(new[] { 0, 2 }, topology.PerformanceCores);
+        Assert.Equal(new[] { 4, 5 }, topology.EfficiencyCores);
+        Assert.Equal(4, topology.MaxConcurrency);
+        Assert.Null(topology.CpuQuota);
+    }
+
+    [Fact]
+    public void Read_AsymmetricCapacity_LowerCapacityCoresAreEfficiency()
+    {
+        WriteFile("sys/devices/system/cpu/online", "0-3");
+        WriteCpu(0, "0", capacity: 446);
+        WriteCpu(1, "1", capacity: 446);
+        WriteCpu(2, "2", capacity: 1024);
+        WriteCpu(3, "3", capacity: 1024);
+
+        var topology = LinuxCpuTopology.Read(_root);
+
+        Assert.Equal(new[] { 2, 3 }, topology.PerformanceCores);
+        Assert.Equal(new[] { 0, 1 }, topology.EfficiencyCores);
+    }
+
+    [Fact]
+    public void Read_NumaNodes_GroupsCoresByNode()
+    {
+        // SMT siblings are n and n + 4, like most AMD and Intel server parts. Node 1 holds the even cores
+        WriteFile("sys/devices/system/cpu/online", "0-7");
+        for (var i = 0; i < 4; i++)
+        {
+            WriteCpu(i, $"{i},{i + 4}");
+            WriteCpu(i + 4, $"{i},{i + 4}");
+        }
+        WriteFile("sys/devices/system/node/node0/cpulist", "1,3,5,7");
+        WriteFile("sys/devices/system/node/node1/cpulist", "0,2,4,6");
+
+        var topology = LinuxCpuTopology.Read(_root);
+
+        Assert.Equal(new[] { 1, 3, 0, 2 }, topology.PerformanceCores);
+        Assert.Empty(topology.EfficiencyCores);
+        Assert.Equal(1, topology.Cpus.Single(cpu => cpu.Id == 6).NumaNode);
+    }
+
+    [Fact]
+    public void Read_AllowedList_RestrictsCpus()
+    {
+        WriteFile("sys/devices/system/cpu/online", "0-7");
+        WriteFile("proc/self/status", "Name:\ttest\nCpus_allowed:\t3c\nCpus_allowed_list:\t2-5\nvoluntary_ctxt_switches:\t1");
+
+        var topology = LinuxCpuTopology.Read(_root);
+
+        Assert.Equal(new[] { 2, 3, 4, 5 }, topology.Cpus.Select(cpu => cpu.Id));
+        Assert.Equal(new[] { 2, 3, 4, 5 }, topology.PerformanceCores);
+    }
+
+    [Fact]
+    public void Read_CgroupV2Quota_CapsConcurrency()
+    {
+        WriteFile("sys/devices/system/cpu/online", "0-15");
+        WriteFile("proc/self/cgroup", "0::/service.slice");
+        WriteFile("sys/fs/cgroup/service.slice/cpu.max", "250000 100000");
+
+        var topology = LinuxCpuTopology.Read(_root);
+
+        Assert.Equal(2.5, topology.CpuQuota);
+        Assert.Equal(3, topology.MaxConcurrency);
+    }
+
+    [Fact]
+    public void Read_CgroupV2Unlimited_HasNoQuota()
+    {
+        WriteFile("sys/devices/system/cpu/online", "0-3");
+        WriteFile("proc/self/cgroup", "0::/");
+        WriteFile("sys/fs/cgroup/cpu.max", "max 100000");
+
+        var topology = LinuxCpuTopology.Read(_root);
+
+        Assert.Null(topology.CpuQuota);
+        Assert.Equal(4, topology.MaxConcurrency);
+    }
+
+    [Fact]
+    public void Read_CgroupV1Quota_CapsConcurrency()
+    {
+        WriteFile("sys/devices/system/cpu/online", "0-7");
+        WriteFile("proc/self/cgroup", "4:memory:/job\n2:cpu,cpuacct:/job\n1:cpuset:/");
+        WriteFile("sys/fs/cgroup/cpu,cpuacct/job/cpu.cfs_quota_us", "200000");
+        WriteFile("sys/fs/cgroup/cpu,cpuacct/job/cpu.cfs_period_us", "100000");
+
+        var topology = LinuxCpuTopology.Read(_root);
+
+        Assert.Equal(2, topology.CpuQuota);
+        Assert.Equal(2, topology.MaxConcurrency);
+    }
+
+    [Fact]
+    public void Discover_ReturnsAtLeastOneUsableCpu()
+    {
+        var topology = CpuTopology.Discover();
+
+        Assert.NotEmpty(topology.Cpus);
+        Assert.NotEmpty(topology.PerformanceCores.Concat(topology.EfficiencyCores));
+        Assert.InRange(topology.MaxConcurrency, 1, topology.Cpus.Count);
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Runtime.InteropServices;
+using SpeedReader.Native.Onnx.Internal;
+
+namespace SpeedReader.Native.DbNet;
+
+public sealed record DbNetBoxOptions
+{
+    public required float Threshold { get; init; }  // Probabilities at or above this are text
+    public required double SimplifyEpsilon { get; init; }  // In map pixels
+    public required double Scale { get; init; }  // Map pixels per output pixel
+    public required double DilationRatio { get; init; }  // Offset is area * ratio / perimeter, in output pixels
+    public required double MaxX { get; init; }  // Output points are clamped to [0, MaxX] x [0, MaxY]
+    public required double MaxY { get; init; }
+    public int RowOffset { get; init; }  // Added to map rows, e.g. the first row of a band cut out of a bigger map
+    public int MinBottom { get; init; }  // Only regions whose last row, after RowOffset, is in [MinBottom, MaxBottom)
+    public int MaxBottom { get; init; } = int.MaxValue;
+}
+
+// Minimum-area rectangle and dilated contour, both as clockwise x/y pairs
+public sealed record DbNetBox(double[] Corners, double[] Polygon);
+
+// speedreader_dbnet.h: DBNet postprocessing, probability map to boxes, without the managed bounds checks and
+// allocations in between
+public static class DbNetPostprocessor
+{
+    // Takes the max where the tile overlaps what is already in the composite
+    public static unsafe void MergeTile(Span<float> composite, int compositeWidth, ReadOnlySpan<float> tile,
+        int tileWidth, int tileHeight, int left, int top)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(left);
+        ArgumentOutOfRangeException.ThrowIfNegative(top);
+        ArgumentOutOfRangeException.ThrowIfGreaterThan(left + tileWidth, compositeWidth);
+        ArgumentOutOfRangeException.ThrowIfLessThan(tile.Length, tileWidth * tileHeight, nameof(tile));
+        if (tileHeight > 0 && (long)(top + tileHeight - 1) * compositeWidth + left + tileWidth > composite.Length)
+            throw new ArgumentException("Tile does not fit inside the composite");
+
+        fixed (float* compositePtr = composite)
+        fixed (float* tilePtr = tile)
+        {
+            SpeedReaderOrt.speedreader_dbnet_merge_tile(compositePtr, (nuint)compositeWidth, tilePtr,
+                (nuint)tileWidth, (nuint)tileHeight, (nuint)left, (nuint)top);
+        }
+    }
+
+    // Boxes in order of each region's top left pixel. pendingTop is the topmost first row of the regions that end
+    // at or below MaxBottom, int.MaxValue if there are none
+    public static unsafe List<DbNetBox> FindBoxes(ReadOnlySpan<float> probabilities, int width, int height,
+        DbNetBoxOptions options, out int pendingTop)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThanOrEqual(width, 0);
+        ArgumentOutOfRangeException.ThrowIfLessThanOrEqual(height, 0);
+        if (probabilities.Length != width * height)
+        {
+            throw new ArgumentException(
+                $"Expected width x height = length, got {width} x {height} = {probabilities.Length}");
+        }
+
+        var nativeOptions = new SpeedReaderOrt.DbNetOptions
+        {
+            Threshold = options.Threshold,
+            SimplifyEpsilon = options.SimplifyEpsilon,
+            Scale = options.Scale,
+            DilationRatio = options.DilationRatio,
+            MaxX = options.MaxX,
+            MaxY = options.MaxY,
+            RowOffset = options.RowOffset,
+            MinBottom = options.MinBottom,
+            MaxBottom = options.MaxBottom
+        };
+
+        var errorBuffer = stackalloc byte[SpeedReaderOrt.ErrorBufSize];
+        SpeedReaderOrt.DbNetBoxes* boxes;
+        fixed (float* probabilitiesPtr = probabilities)
+        {
+            var status = SpeedReaderOrt.speedreader_dbnet_find_boxes(probabilitiesPtr, (nuint)width,
+                (nuint)height, &nativeOptions, &boxes, errorBuffer);
+            if (status != SpeedReaderOrt.Status.Ok)
+            {
+                var errorMessage = Marshal.PtrToStringUTF8((IntPtr)errorBuffer);
+                throw new InvalidOperationException($"DBNet postprocessing failed: {errorMessage}");
+            }
+        }
+
+        try
+        {
+            var result = new List<DbNetBox>((int)boxes->BoxCount);
+            for (var i = 0; i < (int)boxes->BoxCount; i++)
+            {
+                var box = &boxes->Boxes[i];
+                var corners = new ReadOnlySpan<double>(box->Corners, 8).ToArray();
+                var polygon = new ReadOnlySpan<double>(boxes->Points + 2 * (int)box->PointsOffset,
+                    2 * (int)box->PointCount).ToArray();
+                result.Add(new DbNetBox(corners, polygon));
+            }
+
+            pendingTop = boxes->PendingTop;
+            return result;
+        }
+        finally
+        {
+            SpeedReaderOrt.speedreader_dbnet_free_boxes(boxes);
+        }
+    }
+}
@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0
 
 using System.Runtime.InteropServices;
+using System.Text;
 using SpeedReader.Native.Onnx.Internal;
 
 namespace SpeedReader.Native.Onnx;
@@ -17,39 +18,73 @@ public sealed class InferenceSession : IDisposable
         _session = CreateSession(modelData, options ?? new SessionOptions());
     }
 
-    public void Run(OrtValue input, OrtValue output)
+    public void Run(OrtValue input, OrtValue output) => Run(input, output, CancellationToken.None);
+
+    public void Run(OrtValue input, OrtValue output, CancellationToken cancellationToken) =>
+        Run(input, output, argmax: false, cancellationToken);
+
+    // Output is the model's output with the last dimension reduced to (index, value) of its max, e.g. SVTR's
+    // [n, steps, vocab] logits become [n, steps, 2]
+    public void RunArgmax(OrtValue input, OrtValue output) => RunArgmax(input, output, CancellationToken.None);
+
+    public void RunArgmax(OrtValue input, OrtValue output, CancellationToken cancellationToken) =>
+        Run(input, output, argmax: true, cancellationToken);
+
+    private void Run(OrtValue input, OrtValue output, bool argmax, CancellationToken cancellationToken)
     {
         ObjectDisposedException.ThrowIf(_disposed, this);
         ArgumentNullException.ThrowIfNull(input);
         ArgumentNullException.ThrowIfNull(output);
-        UnsafeRunInternal(input, output);
+        cancellationToken.ThrowIfCancellationRequested();
+
+        if (!cancellationToken.CanBeCanceled)
+        {
+            UnsafeRunInternal(input, output, argmax, SafeRunOptionsHandle.SessionDefault);
+            return;
+        }
+
+        // Cancellable runs get their own run options so terminating one run doesn't affect concurrent runs
+        using var runOptions = CreateRunOptions();
+        using var registration = cancellationToken.UnsafeRegister(static state => Terminate((SafeRunOptionsHandle)state!), runOptions);
+        try
+        {
+            UnsafeRunInternal(input, output, argmax, runOptions);
+        }
+        catch (OrtException) when (cancellationToken.IsCancellationRequested)
+        {
+            throw new OperationCanceledException(cancellationToken);
+        }
     }
 
-    private unsafe void UnsafeRunInternal(OrtValue input, OrtValue output)
+    // Output is bound directly as the ORT output tensor, so results are written in place without a copy. Argmax runs
+    // let ORT allocate the full output and only the reduction is written to output
+    private unsafe void UnsafeRunInternal(OrtValue input, OrtValue output, bool argmax, SafeRunOptionsHandle runOptions)
     {
-        var outputShapeBuffer = stackalloc long[SpeedReaderOrt.MaxShapeDims];
         var errorBuffer = stackalloc byte[SpeedReaderOrt.ErrorBufSize];
-        nuint outputNdim = 0;
 
         Span<long> inputShapeLong = stackalloc long[input.Shape.Length];
         for (int i = 0; i < input.Shape.Length; i++)
             inputShapeLong[i] = input.Shape[i];
 
+        Span<long> outputShapeLong = stackalloc long[output.Shape.Length];
+        for (int i = 0; i < output.Shape.Length; i++)
+            outputShapeLong[i] = output.Shape[i];
+
         using var inputHandle = input.Data.Pin();
         using var outputHandle = output.Data.Pin();
 
         fixed (long* inputShapePtr = inputShapeLong)
+        fixed (long* outputShapePtr = outputShapeLong)
         {
-            var status = SpeedReaderOrt.speedreader_ort_run(
-                _session,
-                (float*)inputHandle.Pointer,
-                inputShapePtr,
-                (nuint)input.Shape.Length,
-                (float*)outputHandle.Pointer,
-                (nuint)output.Data.Length,
-                outputShapeBuffer,
-                &outputNdim,
-                errorBuffer);
+            var inputPtr = (float*)inputHandle.Pointer;
+            var outputPtr = (float*)outputHandle.Pointer;
+            var inputNdim = (nuint)input.Shape.Length;
+            var outputNdim = (nuint)output.Shape.Length;
+            var status = argmax
+                ? SpeedReaderOrt.speedreader_ort_run_argmax(_session, runOptions, inputPtr, inputShapePtr, inputNdim,
+                    outputPtr, outputShapePtr, outputNdim, errorBuffer)
+                : SpeedReaderOrt.speedreader_ort_run_into(_session, runOptions, inputPtr, inputShapePtr, inputNdim,
+                    outputPtr, outputShapePtr, outputNdim, errorBuffer);
 
             if (status != SpeedReaderOrt.Status.Ok)
             {
@@ -57,39 +92,37 @@ public sealed class InferenceSession : IDisposable
                 throw new OrtException($"Inference failed: {errorMessage}");
             }
         }
-
-        ThrowIfShapeMismatch(output.Shape, outputShapeBuffer, (int)outputNdim);
     }
 
-    private static unsafe void ThrowIfShapeMismatch(int[] expectedShape, long* actualShape, int actualNdim)
+    private static unsafe SafeRunOptionsHandle CreateRunOptions()
     {
-        if (expectedShape.Length == actualNdim)
+        var errorBuffer = stackalloc byte[SpeedReaderOrt.ErrorBufSize];
+        var status = SpeedReaderOrt.speedreader_ort_create_run_options(out var runOptions, errorBuffer);
+        if (status != SpeedReaderOrt.Status.Ok)
         {
-            for (int i = 0; i < actualNdim; i++)
-            {
-                if (expectedShape[i] != actualShape[i])
-                    goto THROW;
-            }
-
-            return;
+            var errorMessage = Marshal.PtrToStringUTF8((IntPtr)errorBuffer);
+            throw new OrtException($"Failed to create run options: {errorMessage}");
         }
 
-        THROW:
-        Span<long> actual = stackalloc long[actualNdim];
-        for (int i = 0; i < actualNdim; i++)
-            actual[i] = actualShape[i];
+        return runOptions;
+    }
 
-        throw new OrtException(
-            $"Output shape mismatch: expected [{string.Join(", ", expectedShape)}], got [{string.Join(", ", actual.ToArray())}]");
+    private static unsafe void Terminate(SafeRunOptionsHandle runOptions)
+    {
+        var errorBuffer = stackalloc byte[SpeedReaderOrt.ErrorBufSize];
+        SpeedReaderOrt.speedreader_ort_terminate_run(runOptions, errorBuffer);
     }
 
     private static unsafe SafeSessionHandle CreateSession(byte[] modelData, SessionOptions options)
     {
         var errorBuffer = stackalloc byte[SpeedReaderOrt.ErrorBufSize];
         var nativeOptions = options.ToNative();
+        var optimizedModelPath = options.OptimizedModelPath is { } path ? Encoding.UTF8.GetBytes(path + '\0') : null;
 
         fixed (byte* modelDataPtr = modelData)
+        fixed (byte* optimizedModelPathPtr = optimizedModelPath)
         {
+            nativeOptions.OptimizedModelPath = optimizedModelPathPtr;
             var status = SpeedReaderOrt.speedreader_ort_create_session(
                 OrtEnvironment.Instance,
                 modelDataPtr,
@@ -26,3 +26,17 @@ internal sealed class SafeSessionHandle : SafeHandleZeroOrMinusOneIsInvalid
         return true;
     }
 }
+
+internal sealed class SafeRunOptionsHandle : SafeHandleZeroOrMinusOneIsInvalid
+{
+    // An unset handle marshals as NULL, which selects the session's default run options
+    internal static readonly SafeRunOptionsHandle SessionDefault = new();
+
+    public SafeRunOptionsHandle() : base(ownsHandle: true) { }
+
+    protected override bool ReleaseHandle()
+    {
+        SpeedReaderOrt.speedreader_ort_destroy_run_options(handle);
+        return true;
+    }
+}
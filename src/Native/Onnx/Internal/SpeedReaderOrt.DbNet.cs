@@ -0,0 +1,64 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Runtime.InteropServices;
+
+namespace SpeedReader.Native.Onnx.Internal;
+
+// speedreader_dbnet.h, built into the same library
+internal static partial class SpeedReaderOrt
+{
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct DbNetOptions
+    {
+        public float Threshold;
+        public double SimplifyEpsilon;
+        public double Scale;
+        public double DilationRatio;
+        public double MaxX;
+        public double MaxY;
+        public int RowOffset;
+        public int MinBottom;
+        public int MaxBottom;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal unsafe struct DbNetBox
+    {
+        public fixed double Corners[8];
+        public nuint PointsOffset;
+        public nuint PointCount;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    internal unsafe struct DbNetBoxes
+    {
+        public DbNetBox* Boxes;
+        public nuint BoxCount;
+        public double* Points;
+        public nuint PointCount;
+        public int PendingTop;
+    }
+
+    [LibraryImport(LibraryName)]
+    internal static unsafe partial void speedreader_dbnet_merge_tile(
+        float* composite,
+        nuint compositeWidth,
+        float* tile,
+        nuint tileWidth,
+        nuint tileHeight,
+        nuint left,
+        nuint top);
+
+    [LibraryImport(LibraryName)]
+    internal static unsafe partial Status speedreader_dbnet_find_boxes(
+        float* probabilities,
+        nuint width,
+        nuint height,
+        DbNetOptions* options,
+        DbNetBoxes** boxes,
+        byte* error);
+
+    [LibraryImport(LibraryName)]
+    internal static unsafe partial void speedreader_dbnet_free_boxes(DbNetBoxes* boxes);
+}
@@ -19,11 +19,12 @@ internal static partial class SpeedReaderOrt
     }
 
     [StructLayout(LayoutKind.Sequential)]
-    internal struct SessionOptions
+    internal unsafe struct SessionOptions
     {
         public int IntraOpNumThreads;
         public int InterOpNumThreads;
         public int EnableProfiling;
+        public byte* OptimizedModelPath;
     }
 
     [LibraryImport(LibraryName)]
@@ -47,14 +48,39 @@ internal static partial class SpeedReaderOrt
     internal static partial void speedreader_ort_destroy_session(IntPtr session);
 
     [LibraryImport(LibraryName)]
-    internal static unsafe partial Status speedreader_ort_run(
+    internal static unsafe partial Status speedreader_ort_create_run_options(
+        out SafeRunOptionsHandle runOptions,
+        byte* error);
+
+    [LibraryImport(LibraryName)]
+    internal static partial void speedreader_ort_destroy_run_options(IntPtr runOptions);
+
+    [LibraryImport(LibraryName)]
+    internal static unsafe partial Status speedreader_ort_terminate_run(
+        SafeRunOptionsHandle runOptions,
+        byte* error);
+
+    [LibraryImport(LibraryName)]
+    internal static unsafe partial Status speedreader_ort_run_into(
         SafeSessionHandle session,
+        SafeRunOptionsHandle runOptions,
         float* inputData,
         long* inputShape,
         nuint inputNdim,
         float* outputData,
-        nuint outputCount,
         long* outputShape,
-        nuint* outputNdim,
+        nuint outputNdim,
+        byte* error);
+
+    [LibraryImport(LibraryName)]
+    internal static unsafe partial Status speedreader_ort_run_argmax(
+        SafeSessionHandle session,
+        SafeRunOptionsHandle runOptions,
+        float* inputData,
+        long* inputShape,
+        nuint inputNdim,
+        float* outputPairs,
+        long* outputShape,
+        nuint outputNdim,
         byte* error);
 }
@@ -8,6 +8,7 @@ public sealed class SessionOptions
     public int IntraOpNumThreads { get; private set; } = 1;
     public int InterOpNumThreads { get; private set; } = 1;
     public bool EnableProfiling { get; private set; }
+    public string? OptimizedModelPath { get; private set; }
 
     public SessionOptions WithIntraOpThreads(int count)
     {
@@ -29,6 +30,16 @@ public sealed class SessionOptions
         return this;
     }
 
+    // The optimized model is cached in ORT format at path and loaded from there by later sessions, see
+    // speedreader_ort_create_session. Null disables the cache
+    public SessionOptions WithOptimizedModelPath(string? path)
+    {
+        if (path is not null)
+            ArgumentException.ThrowIfNullOrWhiteSpace(path);
+        OptimizedModelPath = path;
+        return this;
+    }
+
     internal Internal.SpeedReaderOrt.SessionOptions ToNative() => new()
     {
         IntraOpNumThreads = IntraOpNumThreads,
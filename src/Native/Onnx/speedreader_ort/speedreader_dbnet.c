@@ -0,0 +1,813 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+#include "speedreader_dbnet.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ************
+// Vector types
+// ************
+// GCC/Clang vector extensions, so the same code is SSE/AVX on x86 and NEON on ARM. Loads and stores go through
+// memcpy, which compiles to unaligned vector moves.
+
+#define FLOAT_LANES 8
+#define BYTE_LANES 32
+
+typedef float f32x8 __attribute__((vector_size(32)));
+typedef int32_t i32x8 __attribute__((vector_size(32)));
+typedef uint8_t u8x8 __attribute__((vector_size(8)));
+typedef uint8_t u8x32 __attribute__((vector_size(32)));
+
+typedef struct {
+    double x;
+    double y;
+} Vec2;
+
+typedef struct {
+    int32_t row;
+    int32_t start;
+    int32_t end;  // Exclusive
+} Run;
+
+// ************
+// Helpers
+// ************
+
+static void write_error(char* error, const char* msg) {
+    if (error != NULL) {
+        snprintf(error, SPEEDREADER_ORT_ERROR_BUF_SIZE, "%s", msg);
+    }
+}
+
+// Grows *data to hold at least count elements. Returns 0 if allocation fails, leaving *data untouched.
+static int reserve(void** data, size_t* capacity, size_t count, size_t element_size) {
+    if (count <= *capacity) {
+        return 1;
+    }
+    size_t new_capacity = *capacity < 64 ? 64 : *capacity;
+    while (new_capacity < count) {
+        new_capacity *= 2;
+    }
+    void* grown = realloc(*data, new_capacity * element_size);
+    if (grown == NULL) {
+        return 0;
+    }
+    *data = grown;
+    *capacity = new_capacity;
+    return 1;
+}
+
+static double cross(Vec2 o, Vec2 a, Vec2 b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static double dot(Vec2 a, Vec2 b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+// ************
+// Tile merge and binarization
+// ************
+
+void speedreader_dbnet_merge_tile(
+    float* composite,
+    size_t composite_width,
+    const float* tile,
+    size_t tile_width,
+    size_t tile_height,
+    size_t left,
+    size_t top
+) {
+    for (size_t row = 0; row < tile_height; row++) {
+        float* dst = composite + (top + row) * composite_width + left;
+        const float* src = tile + row * tile_width;
+
+        size_t col = 0;
+        for (; col + FLOAT_LANES <= tile_width; col += FLOAT_LANES) {
+            f32x8 a, b;
+            memcpy(&a, dst + col, sizeof(a));
+            memcpy(&b, src + col, sizeof(b));
+            i32x8 take_tile = b > a;
+            i32x8 merged = ((i32x8)b & take_tile) | ((i32x8)a & ~take_tile);
+            memcpy(dst + col, &merged, sizeof(merged));
+        }
+        for (; col < tile_width; col++) {
+            dst[col] = src[col] > dst[col] ? src[col] : dst[col];
+        }
+    }
+}
+
+static void binarize(const float* probabilities, size_t count, float threshold, uint8_t* mask) {
+    f32x8 threshold_vec = (f32x8){0} + threshold;
+    size_t i = 0;
+    for (; i + FLOAT_LANES <= count; i += FLOAT_LANES) {
+        f32x8 p;
+        memcpy(&p, probabilities + i, sizeof(p));
+        i32x8 is_text = (p >= threshold_vec) & 1;
+        u8x8 bytes = __builtin_convertvector(is_text, u8x8);
+        memcpy(mask + i, &bytes, sizeof(bytes));
+    }
+    for (; i < count; i++) {
+        mask[i] = probabilities[i] >= threshold;
+    }
+}
+
+// ************
+// Morphological opening
+// ************
+// The mask only holds 0 and 1, so a 3x3 min is an AND of neighbors and a 3x3 max is an OR.
+
+static void and3(const uint8_t* a, const uint8_t* b, const uint8_t* c, uint8_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + BYTE_LANES <= count; i += BYTE_LANES) {
+        u8x32 va, vb, vc;
+        memcpy(&va, a + i, sizeof(va));
+        memcpy(&vb, b + i, sizeof(vb));
+        memcpy(&vc, c + i, sizeof(vc));
+        u8x32 result = va & vb & vc;
+        memcpy(out + i, &result, sizeof(result));
+    }
+    for (; i < count; i++) {
+        out[i] = a[i] & b[i] & c[i];
+    }
+}
+
+static void or3(const uint8_t* a, const uint8_t* b, const uint8_t* c, uint8_t* out, size_t count) {
+    size_t i = 0;
+    for (; i + BYTE_LANES <= count; i += BYTE_LANES) {
+        u8x32 va, vb, vc;
+        memcpy(&va, a + i, sizeof(va));
+        memcpy(&vb, b + i, sizeof(vb));
+        memcpy(&vc, c + i, sizeof(vc));
+        u8x32 result = va | vb | vc;
+        memcpy(out + i, &result, sizeof(result));
+    }
+    for (; i < count; i++) {
+        out[i] = a[i] | b[i] | c[i];
+    }
+}
+
+// Pixels on the border of the map always erode
+static void erode(uint8_t* mask, uint8_t* scratch, size_t width, size_t height) {
+    for (size_t y = 0; y < height; y++) {
+        const uint8_t* row = mask + y * width;
+        uint8_t* out = scratch + y * width;
+        out[0] = 0;
+        out[width - 1] = 0;
+        if (width > 2) {
+            and3(row, row + 1, row + 2, out + 1, width - 2);
+        }
+    }
+
+    memset(mask, 0, width);
+    memset(mask + (height - 1) * width, 0, width);
+    for (size_t y = 1; y + 1 < height; y++) {
+        and3(scratch + (y - 1) * width, scratch + y * width, scratch + (y + 1) * width, mask + y * width, width);
+    }
+}
+
+// Neighbors outside the map are ignored
+static void dilate(uint8_t* mask, uint8_t* scratch, size_t width, size_t height) {
+    for (size_t y = 0; y < height; y++) {
+        const uint8_t* row = mask + y * width;
+        uint8_t* out = scratch + y * width;
+        if (width == 1) {
+            out[0] = row[0];
+            continue;
+        }
+        out[0] = row[0] | row[1];
+        out[width - 1] = row[width - 2] | row[width - 1];
+        if (width > 2) {
+            or3(row, row + 1, row + 2, out + 1, width - 2);
+        }
+    }
+
+    for (size_t y = 0; y < height; y++) {
+        const uint8_t* above = scratch + (y == 0 ? 0 : y - 1) * width;
+        const uint8_t* below = scratch + (y + 1 == height ? y : y + 1) * width;
+        or3(above, scratch + y * width, below, mask + y * width, width);
+    }
+}
+
+// ************
+// Connected components
+// ************
+// 8-connected runs, labelled with union-find. Roots are always a component's first run, so components come out
+// ordered by their top left pixel.
+
+static size_t find(size_t* parents, size_t i) {
+    while (parents[i] != i) {
+        parents[i] = parents[parents[i]];  // Path halving
+        i = parents[i];
+    }
+    return i;
+}
+
+static void unite(size_t* parents, size_t a, size_t b) {
+    size_t root_a = find(parents, a);
+    size_t root_b = find(parents, b);
+    if (root_a < root_b) {
+        parents[root_b] = root_a;
+    } else if (root_b < root_a) {
+        parents[root_a] = root_b;
+    }
+}
+
+// Each row's runs, unioned with the touching runs in the row above. Returns 0 if allocation fails.
+static int label_runs(
+    const uint8_t* mask,
+    size_t width,
+    size_t height,
+    Run** runs,
+    size_t** parents,
+    size_t* run_count
+) {
+    size_t run_capacity = 0;
+    size_t parent_capacity = 0;
+    size_t count = 0;
+    size_t previous_row_start = 0;
+    size_t previous_row_end = 0;
+
+    for (size_t y = 0; y < height; y++) {
+        const uint8_t* row = mask + y * width;
+        size_t row_start = count;
+        size_t candidate = previous_row_start;
+
+        size_t x = 0;
+        while (x < width) {
+            const uint8_t* one = memchr(row + x, 1, width - x);
+            if (one == NULL) {
+                break;
+            }
+            size_t start = (size_t)(one - row);
+            const uint8_t* zero = memchr(row + start, 0, width - start);
+            size_t end = zero == NULL ? width : (size_t)(zero - row);
+
+            if (!reserve((void**)runs, &run_capacity, count + 1, sizeof(Run)) ||
+                !reserve((void**)parents, &parent_capacity, count + 1, sizeof(size_t))) {
+                return 0;
+            }
+            (*runs)[count] = (Run){(int32_t)y, (int32_t)start, (int32_t)end};
+            (*parents)[count] = count;
+
+            // Runs above that end before this one starts (with diagonal slack) can't touch this or later runs
+            while (candidate < previous_row_end && (size_t)(*runs)[candidate].end < start) {
+                candidate++;
+            }
+            for (size_t above = candidate; above < previous_row_end && (size_t)(*runs)[above].start <= end; above++) {
+                unite(*parents, above, count);
+            }
+
+            count++;
+            x = end;
+        }
+
+        previous_row_start = row_start;
+        previous_row_end = count;
+    }
+
+    *run_count = count;
+    return 1;
+}
+
+// ************
+// Contours
+// ************
+
+// Clockwise on screen (y points down), starting east
+static const int32_t CLOCKWISE[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+
+static int is_set(const uint8_t* mask, size_t width, size_t height, int64_t x, int64_t y) {
+    return x >= 0 && (size_t)x < width && y >= 0 && (size_t)y < height && mask[(size_t)y * width + (size_t)x] != 0;
+}
+
+// Moore neighbor tracing of a component's outer boundary into *contour, as TraceOuterBoundary in the managed
+// pipeline. Starts clockwise from the component's first pixel in scan order, whose west neighbor is background, and
+// stops on re-entering the start pixel from the same side it was left from (Jacob's criterion). Components never
+// touch, so the mask is all that's needed. Returns the point count, or 0 if allocation fails.
+static size_t trace_outer_boundary(
+    const uint8_t* mask,
+    size_t width,
+    size_t height,
+    int32_t start_x,
+    int32_t start_y,
+    int32_t row_offset,
+    Vec2** contour,
+    size_t* capacity
+) {
+    if (!reserve((void**)contour, capacity, 1, sizeof(Vec2))) {
+        return 0;
+    }
+    size_t count = 0;
+    (*contour)[count++] = (Vec2){start_x, (double)row_offset + start_y};
+
+    int64_t x = start_x;
+    int64_t y = start_y;
+    int backtrack = 4;  // West
+    int first_step = -1;
+    for (;;) {
+        int next = -1;
+        for (int i = 1; i <= 8; i++) {
+            int direction = (backtrack + i) % 8;
+            if (is_set(mask, width, height, x + CLOCKWISE[direction][0], y + CLOCKWISE[direction][1])) {
+                next = direction;
+                break;
+            }
+        }
+        if (next < 0) {
+            return count;  // Single pixel
+        }
+
+        // The neighbor checked just before next is background, and adjacent to the pixel we move to
+        int before = (next + 7) % 8;
+        int32_t bx = CLOCKWISE[before][0] - CLOCKWISE[next][0];
+        int32_t by = CLOCKWISE[before][1] - CLOCKWISE[next][1];
+        int next_backtrack = 0;
+        while (CLOCKWISE[next_backtrack][0] != bx || CLOCKWISE[next_backtrack][1] != by) {
+            next_backtrack++;
+        }
+
+        if (x == start_x && y == start_y) {
+            if (first_step == next) {
+                break;
+            }
+            if (first_step < 0) {
+                first_step = next;
+            }
+        }
+
+        x += CLOCKWISE[next][0];
+        y += CLOCKWISE[next][1];
+        backtrack = next_backtrack;
+        if (!reserve((void**)contour, capacity, count + 1, sizeof(Vec2))) {
+            return 0;
+        }
+        (*contour)[count++] = (Vec2){(double)x, (double)row_offset + (double)y};
+    }
+
+    return count - 1;  // The start, reached again
+}
+
+// Ramer-Douglas-Peucker on an open path, first and last points kept. Returns the new point count.
+static size_t simplify(Vec2* points, size_t count, double epsilon, uint8_t* keep, size_t* stack) {
+    if (count <= 3) {
+        return count;
+    }
+
+    memset(keep, 0, count);
+    keep[0] = 1;
+    keep[count - 1] = 1;
+    size_t depth = 0;
+    stack[depth++] = 0;
+    stack[depth++] = count - 1;
+    while (depth > 0) {
+        size_t last = stack[--depth];
+        size_t first = stack[--depth];
+
+        Vec2 a = points[first];
+        Vec2 b = points[last];
+        double length = hypot(b.x - a.x, b.y - a.y);
+        double max_distance = 0;
+        size_t farthest = first;
+        for (size_t i = first + 1; i < last; i++) {
+            double distance = length > 0
+                ? fabs(cross(a, b, points[i])) / length
+                : hypot(points[i].x - a.x, points[i].y - a.y);
+            if (distance > max_distance) {
+                max_distance = distance;
+                farthest = i;
+            }
+        }
+
+        if (max_distance > epsilon) {
+            keep[farthest] = 1;
+            stack[depth++] = first;
+            stack[depth++] = farthest;
+            stack[depth++] = farthest;
+            stack[depth++] = last;
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (keep[i]) {
+            points[kept++] = points[i];
+        }
+    }
+    return kept;
+}
+
+// Offsets a closed polygon outward by delta with round joins, appending the result to out. Same arc tolerance as
+// Clipper2's ClipperOffset, which the managed pipeline dilates with. Concave corners get the miter point, where
+// Clipper2 would add a loop and union it away. Returns 0 if allocation fails.
+static int offset_polygon(
+    const Vec2* points,
+    size_t count,
+    double delta,
+    Vec2** out,
+    size_t* out_count,
+    size_t* out_capacity
+) {
+    double signed_area = 0;
+    for (size_t i = 0; i < count; i++) {
+        Vec2 a = points[i];
+        Vec2 b = points[(i + 1) % count];
+        signed_area += a.x * b.y - b.x * a.y;
+    }
+    double orientation = signed_area >= 0 ? 1 : -1;
+
+    double arc_tolerance = log10(2 + delta) * 0.25;
+    double steps_per_360 = fmin(M_PI / acos(1 - fmin(arc_tolerance / delta, 1)), delta * M_PI);
+    double steps_per_rad = steps_per_360 / (2 * M_PI);
+
+    for (size_t i = 0; i < count; i++) {
+        Vec2 previous = points[(i + count - 1) % count];
+        Vec2 current = points[i];
+        Vec2 next = points[(i + 1) % count];
+
+        double length1 = hypot(current.x - previous.x, current.y - previous.y);
+        double length2 = hypot(next.x - current.x, next.y - current.y);
+        if (length1 == 0 || length2 == 0) {
+            continue;  // Repeated point
+        }
+
+        // Outward normals of the edges into and out of this point
+        Vec2 n1 = {orientation * (current.y - previous.y) / length1, -orientation * (current.x - previous.x) / length1};
+        Vec2 n2 = {orientation * (next.y - current.y) / length2, -orientation * (next.x - current.x) / length2};
+        double turn = n1.x * n2.y - n1.y * n2.x;
+        double cos_angle = dot(n1, n2);
+
+        if (!reserve((void**)out, out_capacity, *out_count + 3, sizeof(Vec2))) {
+            return 0;
+        }
+
+        if (orientation * turn < -1e-12) {
+            // Concave: the offset edges meet inside the corner
+            double sum_length = hypot(n1.x + n2.x, n1.y + n2.y);
+            if (sum_length < 1e-6) {
+                (*out)[(*out_count)++] = (Vec2){current.x + delta * n1.x, current.y + delta * n1.y};
+                (*out)[(*out_count)++] = (Vec2){current.x + delta * n2.x, current.y + delta * n2.y};
+            } else {
+                double miter = delta / (1 + cos_angle);
+                (*out)[(*out_count)++] = (Vec2){current.x + miter * (n1.x + n2.x), current.y + miter * (n1.y + n2.y)};
+            }
+            continue;
+        }
+
+        // Convex or straight: sweep an arc from one edge's normal to the other's
+        double angle = atan2(turn, cos_angle);
+        size_t steps = (size_t)ceil(fabs(angle) * steps_per_rad);
+        if (steps == 0) {
+            steps = 1;
+        }
+        if (!reserve((void**)out, out_capacity, *out_count + steps + 1, sizeof(Vec2))) {
+            return 0;
+        }
+        double step = angle / (double)steps;
+        for (size_t s = 0; s <= steps; s++) {
+            double c = cos(step * (double)s);
+            double si = sin(step * (double)s);
+            Vec2 normal = {n1.x * c - n1.y * si, n1.x * si + n1.y * c};
+            (*out)[(*out_count)++] = (Vec2){current.x + delta * normal.x, current.y + delta * normal.y};
+            if (fabs(angle) < 1e-12) {
+                break;  // Straight, one point is enough
+            }
+        }
+    }
+
+    return 1;
+}
+
+static int compare_points(const void* a, const void* b) {
+    const Vec2* p = (const Vec2*)a;
+    const Vec2* q = (const Vec2*)b;
+    if (p->x != q->x) {
+        return p->x < q->x ? -1 : 1;
+    }
+    return p->y < q->y ? -1 : p->y > q->y;
+}
+
+// Andrew's monotone chain. Sorts points in place, writes the hull counterclockwise (positive area) without collinear
+// points into hull, which must hold 2 * count points. Returns the hull size.
+static size_t convex_hull(Vec2* points, size_t count, Vec2* hull) {
+    qsort(points, count, sizeof(Vec2), compare_points);
+
+    size_t size = 0;
+    for (size_t i = 0; i < count; i++) {
+        while (size >= 2 && cross(hull[size - 2], hull[size - 1], points[i]) <= 0) {
+            size--;
+        }
+        hull[size++] = points[i];
+    }
+    size_t lower = size + 1;
+    for (size_t i = count - 1; i-- > 0;) {
+        while (size >= lower && cross(hull[size - 2], hull[size - 1], points[i]) <= 0) {
+            size--;
+        }
+        hull[size++] = points[i];
+    }
+    return size > 1 ? size - 1 : size;  // The last point is the first
+}
+
+// Rotating calipers: the minimum-area rectangle has a side on a hull edge, and the extreme points along each edge
+// only move forward as the edge rotates, so all edges are tried in O(n). Corners match ToRotatedRectangle in the
+// managed pipeline. Returns 0 if every rectangle is degenerate.
+static int min_area_rectangle(const Vec2* hull, size_t count, double corners[8]) {
+    double best_area = INFINITY;
+    size_t max_u = 1 % count;
+    size_t max_n = 1 % count;
+    size_t min_u = 1 % count;
+
+    for (size_t i = 0; i < count; i++) {
+        Vec2 a = hull[i];
+        Vec2 b = hull[(i + 1) % count];
+        double length = hypot(b.x - a.x, b.y - a.y);
+        if (length == 0) {
+            continue;
+        }
+        Vec2 u = {(b.x - a.x) / length, (b.y - a.y) / length};  // Edge direction
+        Vec2 n = {-u.y, u.x};  // Into the hull
+
+        while (dot(hull[(max_u + 1) % count], u) > dot(hull[max_u], u)) {
+            max_u = (max_u + 1) % count;
+        }
+        if (i == 0) {
+            max_n = max_u;
+        }
+        while (dot(hull[(max_n + 1) % count], n) > dot(hull[max_n], n)) {
+            max_n = (max_n + 1) % count;
+        }
+        if (i == 0) {
+            min_u = max_n;
+        }
+        while (dot(hull[(min_u + 1) % count], u) < dot(hull[min_u], u)) {
+            min_u = (min_u + 1) % count;
+        }
+
+        double lo_u = dot(hull[min_u], u);
+        double hi_u = dot(hull[max_u], u);
+        double lo_n = dot(a, n);
+        double hi_n = dot(hull[max_n], n);
+        double area = (hi_u - lo_u) * (hi_n - lo_n);
+        if (area < 1e-8 || area >= best_area) {
+            continue;
+        }
+
+        best_area = area;
+        double projections[4][2] = {{lo_u, hi_n}, {hi_u, hi_n}, {hi_u, lo_n}, {lo_u, lo_n}};
+        for (int c = 0; c < 4; c++) {
+            corners[2 * c] = projections[c][0] * u.x + projections[c][1] * n.x;
+            corners[2 * c + 1] = projections[c][0] * u.y + projections[c][1] * n.y;
+        }
+    }
+
+    return best_area != INFINITY;
+}
+
+// ************
+// Box fitting
+// ************
+
+typedef struct {
+    Vec2* contour;
+    size_t contour_capacity;
+    uint8_t* keep;
+    size_t keep_capacity;
+    size_t* stack;
+    size_t stack_capacity;
+    Vec2* sorted;
+    size_t sorted_capacity;
+    Vec2* hull;
+    size_t hull_capacity;
+} Workspace;
+
+typedef struct {
+    SpeedReaderDbNetBox* boxes;
+    size_t box_count;
+    size_t box_capacity;
+    Vec2* points;
+    size_t point_count;
+    size_t point_capacity;
+} Output;
+
+// Simplify, scale, dilate, clamp, hull and rectangle, as ToBoundingBox in the managed pipeline. Regions that
+// collapse along the way are dropped. Returns 0 if allocation fails.
+static int fit_box(Vec2* contour, size_t count, const SpeedReaderDbNetOptions* options, Workspace* workspace,
+                   Output* output) {
+    count = simplify(contour, count, options->simplify_epsilon, workspace->keep, workspace->stack);
+
+    double inverse_scale = 1 / options->scale;
+    double area = 0;
+    double perimeter = 0;
+    for (size_t i = 0; i < count; i++) {
+        contour[i].x *= inverse_scale;
+        contour[i].y *= inverse_scale;
+    }
+    for (size_t i = 0; i < count; i++) {
+        Vec2 a = contour[i];
+        Vec2 b = contour[(i + 1) % count];
+        area += a.x * b.y - b.x * a.y;
+        perimeter += hypot(b.x - a.x, b.y - a.y);
+    }
+    area = fabs(area) / 2;
+    if (perimeter == 0) {
+        return 1;
+    }
+
+    size_t first_point = output->point_count;
+    double delta = area * options->dilation_ratio / perimeter;
+    if (delta > 0) {
+        if (!offset_polygon(contour, count, delta, &output->points, &output->point_count, &output->point_capacity)) {
+            return 0;
+        }
+    } else {
+        if (!reserve((void**)&output->points, &output->point_capacity, first_point + count, sizeof(Vec2))) {
+            return 0;
+        }
+        memcpy(output->points + first_point, contour, count * sizeof(Vec2));
+        output->point_count += count;
+    }
+
+    size_t dilated_count = output->point_count - first_point;
+    Vec2* dilated = output->points + first_point;
+    for (size_t i = 0; i < dilated_count; i++) {
+        dilated[i].x = fmin(fmax(dilated[i].x, 0), options->max_x);
+        dilated[i].y = fmin(fmax(dilated[i].y, 0), options->max_y);
+    }
+
+    if (!reserve((void**)&workspace->sorted, &workspace->sorted_capacity, dilated_count, sizeof(Vec2)) ||
+        !reserve((void**)&workspace->hull, &workspace->hull_capacity, 2 * dilated_count, sizeof(Vec2))) {
+        return 0;
+    }
+    memcpy(workspace->sorted, dilated, dilated_count * sizeof(Vec2));
+    size_t hull_size = dilated_count < 3 ? 0 : convex_hull(workspace->sorted, dilated_count, workspace->hull);
+
+    SpeedReaderDbNetBox box;
+    if (hull_size < 3 || !min_area_rectangle(workspace->hull, hull_size, box.corners)) {
+        output->point_count = first_point;
+        return 1;
+    }
+
+    if (!reserve((void**)&output->boxes, &output->box_capacity, output->box_count + 1, sizeof(SpeedReaderDbNetBox))) {
+        return 0;
+    }
+    box.points_offset = first_point;
+    box.point_count = dilated_count;
+    output->boxes[output->box_count++] = box;
+    return 1;
+}
+
+// ************
+// API
+// ************
+
+SpeedReaderOrtStatus speedreader_dbnet_find_boxes(
+    const float* probabilities,
+    size_t width,
+    size_t height,
+    const SpeedReaderDbNetOptions* options,
+    SpeedReaderDbNetBoxes** boxes,
+    char* error
+) {
+    if (probabilities == NULL || options == NULL || boxes == NULL) {
+        write_error(error, "probabilities, options and boxes must not be NULL");
+        return SPEEDREADER_ORT_ERROR;
+    }
+    if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX) {
+        write_error(error, "map dimensions must be in [1, INT32_MAX]");
+        return SPEEDREADER_ORT_ERROR;
+    }
+    if (!(options->scale > 0)) {
+        write_error(error, "scale must be positive");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    SpeedReaderOrtStatus status = SPEEDREADER_ORT_ERROR;
+    uint8_t* mask = (uint8_t*)malloc(width * height);
+    uint8_t* scratch = (uint8_t*)malloc(width * height);
+    Run* runs = NULL;
+    size_t* parents = NULL;
+    size_t run_count = 0;
+    size_t* component_of = NULL;  // Per run
+    size_t* first_runs = NULL;  // Per component
+    int32_t* last_rows = NULL;
+    Workspace workspace = {0};
+    Output output = {0};
+    SpeedReaderDbNetBoxes* result = NULL;
+
+    if (mask == NULL || scratch == NULL) {
+        write_error(error, "failed to allocate mask");
+        goto cleanup;
+    }
+
+    binarize(probabilities, width * height, options->threshold, mask);
+    erode(mask, scratch, width, height);
+    dilate(mask, scratch, width, height);
+
+    if (!label_runs(mask, width, height, &runs, &parents, &run_count)) {
+        write_error(error, "failed to allocate runs");
+        goto cleanup;
+    }
+
+    // Number components by their root, which is their first run, and note the last row each reaches. Runs are in
+    // scan order, so a component's rows arrive top to bottom
+    size_t slots = run_count == 0 ? 1 : run_count;
+    component_of = (size_t*)malloc(slots * sizeof(size_t));
+    first_runs = (size_t*)malloc(slots * sizeof(size_t));
+    last_rows = (int32_t*)malloc(slots * sizeof(int32_t));
+    if (component_of == NULL || first_runs == NULL || last_rows == NULL) {
+        write_error(error, "failed to allocate components");
+        goto cleanup;
+    }
+
+    size_t component_count = 0;
+    for (size_t i = 0; i < run_count; i++) {
+        size_t root = find(parents, i);
+        size_t component = root == i ? component_count++ : component_of[root];
+        component_of[i] = component;
+        if (root == i) {
+            first_runs[component] = i;
+        }
+        last_rows[component] = runs[i].row;
+    }
+
+    int32_t pending_top = INT32_MAX;
+    for (size_t c = 0; c < component_count; c++) {
+        Run first = runs[first_runs[c]];
+        int32_t top = options->row_offset + first.row;
+        int32_t bottom = options->row_offset + last_rows[c];
+        if (bottom >= options->max_bottom) {
+            pending_top = top < pending_top ? top : pending_top;
+            continue;
+        }
+        if (bottom < options->min_bottom) {
+            continue;
+        }
+
+        size_t count = trace_outer_boundary(mask, width, height, first.start, first.row, options->row_offset,
+                                            &workspace.contour, &workspace.contour_capacity);
+        if (count == 0 ||
+            !reserve((void**)&workspace.keep, &workspace.keep_capacity, count, sizeof(uint8_t)) ||
+            !reserve((void**)&workspace.stack, &workspace.stack_capacity, 2 * count + 2, sizeof(size_t))) {
+            write_error(error, "failed to allocate contours");
+            goto cleanup;
+        }
+
+        if (!fit_box(workspace.contour, count, options, &workspace, &output)) {
+            write_error(error, "failed to allocate boxes");
+            goto cleanup;
+        }
+    }
+
+    result = (SpeedReaderDbNetBoxes*)malloc(sizeof(SpeedReaderDbNetBoxes));
+    if (result == NULL) {
+        write_error(error, "failed to allocate boxes");
+        goto cleanup;
+    }
+    result->boxes = output.boxes;
+    result->box_count = output.box_count;
+    result->points = (double*)output.points;
+    result->point_count = output.point_count;
+    result->pending_top = pending_top;
+    output.boxes = NULL;
+    output.points = NULL;
+
+    *boxes = result;
+    if (error != NULL) {
+        error[0] = '\0';
+    }
+    status = SPEEDREADER_ORT_OK;
+
+cleanup:
+    free(mask);
+    free(scratch);
+    free(runs);
+    free(parents);
+    free(component_of);
+    free(first_runs);
+    free(last_rows);
+    free(workspace.contour);
+    free(workspace.keep);
+    free(workspace.stack);
+    free(workspace.sorted);
+    free(workspace.hull);
+    free(output.boxes);
+    free(output.points);
+    return status;
+}
+
+void speedreader_dbnet_free_boxes(SpeedReaderDbNetBoxes* boxes) {
+    if (boxes == NULL) {
+        return;
+    }
+    free(boxes->boxes);
+    free(boxes->points);
+    free(boxes);
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+#ifndef SPEEDREADER_DBNET_H
+#define SPEEDREADER_DBNET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "speedreader_ort.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ************
+// DBNet postprocessing
+// ************
+// Everything between the DBNet probability map and bounding boxes: tile merge, binarization, morphological opening,
+// connected components, outer boundary tracing, contour simplification, dilation, convex hull and minimum-area
+// rectangle. Same stages as DetectionPostprocessing.ConnectedComponents in the managed pipeline. Error conventions as
+// in speedreader_ort.h.
+
+typedef struct {
+    float threshold;  // Probabilities at or above this are text
+    double simplify_epsilon;  // Ramer-Douglas-Peucker tolerance, in map pixels
+    double scale;  // Map pixels per output pixel; contours are divided by it before dilation
+    double dilation_ratio;  // Contours are offset outward by area * dilation_ratio / perimeter, in output pixels
+    double max_x;  // Output points are clamped to [0, max_x] x [0, max_y]
+    double max_y;
+    int32_t row_offset;  // Added to map rows, e.g. the first row of a band cut out of a larger map
+    int32_t min_bottom;  // Only regions whose last row (after row_offset) is in [min_bottom, max_bottom) are fitted
+    int32_t max_bottom;
+} SpeedReaderDbNetOptions;
+
+typedef struct {
+    double corners[8];  // Minimum-area rectangle of the dilated contour, clockwise x/y pairs
+    size_t points_offset;  // Dilated contour, as indices into SpeedReaderDbNetBoxes.points
+    size_t point_count;
+} SpeedReaderDbNetBox;
+
+typedef struct {
+    SpeedReaderDbNetBox* boxes;  // In order of each region's top left pixel
+    size_t box_count;
+    double* points;  // x/y pairs
+    size_t point_count;
+    int32_t pending_top;  // Topmost first row of the regions ending at or below max_bottom, INT32_MAX if none
+} SpeedReaderDbNetBoxes;
+
+// Merges one tile into a composite map, taking the max where tiles overlap. The tile must lie inside the composite.
+// Thread-safe for disjoint composites.
+void speedreader_dbnet_merge_tile(
+    float* composite,
+    size_t composite_width,
+    const float* tile,
+    size_t tile_width,
+    size_t tile_height,
+    size_t left,
+    size_t top
+);
+
+// Finds the bounding boxes in a width x height probability map. The map is not modified.
+// Thread-safe.
+//
+// Regions the options filter out are not fitted. On success, *boxes must be freed with speedreader_dbnet_free_boxes.
+SpeedReaderOrtStatus speedreader_dbnet_find_boxes(
+    const float* probabilities,
+    size_t width,
+    size_t height,
+    const SpeedReaderDbNetOptions* options,
+    SpeedReaderDbNetBoxes** boxes,
+    char* error
+);
+void speedreader_dbnet_free_boxes(SpeedReaderDbNetBoxes* boxes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPEEDREADER_DBNET_H
@@ -1,11 +1,18 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
+#define _POSIX_C_SOURCE 200809L  // O_CLOEXEC, mmap
+
 #include "speedreader_ort.h"
 #include <onnxruntime_c_api.h>
+#include <onnxruntime_session_options_config_keys.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // ************
 // Opaque handle internal structures
@@ -13,10 +20,25 @@
 
 struct SpeedReaderOrtEnv {
     OrtEnv* ort_env;
+    OrtPrepackedWeightsContainer* prepacked_weights;  // Shared by every session created in this env
 };
 
 struct SpeedReaderOrtSession {
     OrtSession* ort_session;
+    void* mapped_model;           // Cached optimized model the session reads initializers from, NULL if none
+    size_t mapped_model_size;
+    OrtMemoryInfo* mem_info;      // CPU memory info for wrapping caller buffers as tensors
+    OrtRunOptions* run_options;   // Used when the caller doesn't supply run options
+    size_t input_count;
+    size_t output_count;
+    char** input_names;
+    char** output_names;
+    int64_t output_dims[SPEEDREADER_ORT_MAX_SHAPE_DIMS];  // The model's first output, -1 for symbolic dims
+    size_t output_rank;                                   // 0 if the first output isn't a tensor ORT can describe
+};
+
+struct SpeedReaderOrtRunOptions {
+    OrtRunOptions* ort_run_options;
 };
 
 // ************
@@ -65,6 +87,513 @@ static void clear_error(char* error) {
     }
 }
 
+// ************
+// Shape helpers
+// ************
+
+// Symbolic (negative) dims are written as ?
+static size_t format_shape(char* buf, size_t buf_size, const int64_t* dims, size_t ndim) {
+    size_t len = (size_t)snprintf(buf, buf_size, "[");
+    for (size_t i = 0; i < ndim && len < buf_size; i++) {
+        if (dims[i] < 0) {
+            len += (size_t)snprintf(buf + len, buf_size - len, i == 0 ? "?" : ", ?");
+        } else {
+            len += (size_t)snprintf(buf + len, buf_size - len, i == 0 ? "%lld" : ", %lld", (long long)dims[i]);
+        }
+    }
+    if (len < buf_size) {
+        len += (size_t)snprintf(buf + len, buf_size - len, "]");
+    }
+    return len;
+}
+
+static void write_shape_mismatch_error(
+    char* error,
+    const int64_t* expected,
+    size_t expected_ndim,
+    const char* label,
+    const int64_t* actual,
+    size_t actual_ndim
+) {
+    if (error == NULL) {
+        return;
+    }
+    char expected_str[96];
+    char actual_str[96];
+    format_shape(expected_str, sizeof(expected_str), expected, expected_ndim);
+    format_shape(actual_str, sizeof(actual_str), actual, actual_ndim);
+    snprintf(error, SPEEDREADER_ORT_ERROR_BUF_SIZE,
+             "Output shape mismatch: expected %s, %s %s",
+             expected_str, label, actual_str);
+}
+
+// Checks a caller's output shape against the rank and fixed dims of the model's output. Symbolic dims can only be
+// checked by running the model.
+static SpeedReaderOrtStatus check_output_shape(
+    const SpeedReaderOrtSession* session,
+    const int64_t* output_shape,
+    size_t output_ndim,
+    char* error
+) {
+    if (session->output_rank == 0) {
+        return SPEEDREADER_ORT_OK;
+    }
+
+    int matches = output_ndim == session->output_rank;
+    for (size_t i = 0; matches && i < output_ndim; i++) {
+        matches = session->output_dims[i] < 0 || session->output_dims[i] == output_shape[i];
+    }
+    if (!matches) {
+        write_shape_mismatch_error(error, output_shape, output_ndim, "model output is",
+                                   session->output_dims, session->output_rank);
+        return SPEEDREADER_ORT_ERROR;
+    }
+    return SPEEDREADER_ORT_OK;
+}
+
+// ************
+// Argmax helpers
+// ************
+// GCC/Clang vector extensions, as in speedreader_dbnet.c
+
+#define ARGMAX_LANES 8
+
+typedef float f32x8 __attribute__((vector_size(32)));
+typedef int32_t i32x8 __attribute__((vector_size(32)));
+
+// Writes (index, value) of each row's max to pairs. Ties go to the lowest index, same as the managed IndexOfMax.
+// Each lane keeps its own max and where it was, so the row is read once.
+static void argmax_rows(const float* logits, size_t rows, size_t classes, float* pairs) {
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = logits + r * classes;
+        int32_t best_index = 0;
+        float best_value = row[0];
+        size_t c = 1;
+
+        if (classes >= 2 * ARGMAX_LANES) {
+            f32x8 max_values;
+            memcpy(&max_values, row, sizeof(max_values));
+            i32x8 indices = {0, 1, 2, 3, 4, 5, 6, 7};
+            i32x8 max_indices = indices;
+            for (c = ARGMAX_LANES; c + ARGMAX_LANES <= classes; c += ARGMAX_LANES) {
+                f32x8 values;
+                memcpy(&values, row + c, sizeof(values));
+                indices += ARGMAX_LANES;
+                i32x8 greater = values > max_values;
+                max_values = (f32x8)(((i32x8)values & greater) | ((i32x8)max_values & ~greater));
+                max_indices = (indices & greater) | (max_indices & ~greater);
+            }
+
+            best_value = max_values[0];
+            best_index = max_indices[0];
+            for (int lane = 1; lane < ARGMAX_LANES; lane++) {
+                if (max_values[lane] > best_value ||
+                    (max_values[lane] == best_value && max_indices[lane] < best_index)) {
+                    best_value = max_values[lane];
+                    best_index = max_indices[lane];
+                }
+            }
+        }
+
+        // Tail indices are past every lane's, so strictly greater keeps the first occurrence
+        for (; c < classes; c++) {
+            if (row[c] > best_value) {
+                best_value = row[c];
+                best_index = (int32_t)c;
+            }
+        }
+
+        pairs[2 * r] = (float)best_index;  // Exact, vocabularies are far below 2^24
+        pairs[2 * r + 1] = best_value;
+    }
+}
+
+// ************
+// Session helpers
+// ************
+
+static void free_names(char** names, size_t count) {
+    if (names == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        free(names[i]);
+    }
+    free(names);
+}
+
+// Releases everything owned by a (possibly partially constructed) session
+static void release_session(SpeedReaderOrtSession* session) {
+    const OrtApi* api = get_api();
+    if (session->ort_session != NULL) {
+        api->ReleaseSession(session->ort_session);
+    }
+    if (session->mapped_model != NULL) {
+        munmap(session->mapped_model, session->mapped_model_size);
+    }
+    if (session->mem_info != NULL) {
+        api->ReleaseMemoryInfo(session->mem_info);
+    }
+    if (session->run_options != NULL) {
+        api->ReleaseRunOptions(session->run_options);
+    }
+    free_names(session->input_names, session->input_count);
+    free_names(session->output_names, session->output_count);
+    free(session);
+}
+
+// Reads the session's input (or output) names into malloc'd copies
+static SpeedReaderOrtStatus read_io_names(
+    OrtSession* ort_session,
+    int inputs,
+    size_t* count,
+    char*** names,
+    char* error
+) {
+    const OrtApi* api = get_api();
+    OrtStatus* status = NULL;
+    OrtAllocator* allocator = NULL;
+
+    status = api->GetAllocatorWithDefaultOptions(&allocator);
+    if (status != NULL) {
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    size_t name_count = 0;
+    status = inputs
+        ? api->SessionGetInputCount(ort_session, &name_count)
+        : api->SessionGetOutputCount(ort_session, &name_count);
+    if (status != NULL) {
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    char** name_copies = (char**)calloc(name_count == 0 ? 1 : name_count, sizeof(char*));
+    if (name_copies == NULL) {
+        write_error(error, "failed to allocate I/O names");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    for (size_t i = 0; i < name_count; i++) {
+        char* name = NULL;
+        status = inputs
+            ? api->SessionGetInputName(ort_session, i, allocator, &name)
+            : api->SessionGetOutputName(ort_session, i, allocator, &name);
+        if (status != NULL) {
+            free_names(name_copies, name_count);
+            write_ort_error(status, error);
+            return SPEEDREADER_ORT_ERROR;
+        }
+
+        size_t name_len = strlen(name);
+        name_copies[i] = (char*)malloc(name_len + 1);
+        if (name_copies[i] != NULL) {
+            memcpy(name_copies[i], name, name_len + 1);
+        }
+        OrtStatus* free_status = api->AllocatorFree(allocator, name);
+        if (free_status != NULL) {
+            api->ReleaseStatus(free_status);
+        }
+
+        if (name_copies[i] == NULL) {
+            free_names(name_copies, name_count);
+            write_error(error, "failed to allocate I/O names");
+            return SPEEDREADER_ORT_ERROR;
+        }
+    }
+
+    *count = name_count;
+    *names = name_copies;
+    return SPEEDREADER_ORT_OK;
+}
+
+// Reads the first output's dims into the session. Outputs ORT can't describe as a tensor are left unchecked.
+static SpeedReaderOrtStatus read_output_dims(SpeedReaderOrtSession* session, char* error) {
+    const OrtApi* api = get_api();
+    OrtTypeInfo* type_info = NULL;
+    const OrtTensorTypeAndShapeInfo* tensor_info = NULL;
+
+    OrtStatus* status = api->SessionGetOutputTypeInfo(session->ort_session, 0, &type_info);
+    if (status == NULL) {
+        status = api->CastTypeInfoToTensorInfo(type_info, &tensor_info);
+    }
+
+    size_t rank = 0;
+    if (status == NULL && tensor_info != NULL) {
+        status = api->GetDimensionsCount(tensor_info, &rank);
+        if (status == NULL && rank <= SPEEDREADER_ORT_MAX_SHAPE_DIMS) {
+            status = api->GetDimensions(tensor_info, session->output_dims, rank);
+        } else {
+            rank = 0;
+        }
+    }
+
+    if (type_info != NULL) {
+        api->ReleaseTypeInfo(type_info);
+    }
+    if (status != NULL) {
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    session->output_rank = rank;
+    return SPEEDREADER_ORT_OK;
+}
+
+static SpeedReaderOrtStatus check_single_io(const SpeedReaderOrtSession* session, char* error) {
+    if (session->input_count < 1 || session->output_count < 1) {
+        snprintf(error, error == NULL ? 0 : SPEEDREADER_ORT_ERROR_BUF_SIZE,
+                 "model has %zu inputs and %zu outputs, at least one of each is required",
+                 session->input_count, session->output_count);
+        return SPEEDREADER_ORT_ERROR;
+    }
+    return SPEEDREADER_ORT_OK;
+}
+
+static OrtRunOptions* resolve_run_options(const SpeedReaderOrtSession* session, SpeedReaderOrtRunOptions* run_options) {
+    return run_options != NULL ? run_options->ort_run_options : session->run_options;
+}
+
+// Whether a failed Run could be a pre-bound output not fitting the model's output. check_output_shape has already
+// ruled that out when every output dim is fixed, otherwise only ORT's shape verification failure qualifies, so
+// runtime failures such as running out of memory are reported as is.
+static int is_output_shape_error(const SpeedReaderOrtSession* session, OrtStatus* status) {
+    int resolved = session->output_rank > 0;
+    for (size_t i = 0; resolved && i < session->output_rank; i++) {
+        resolved = session->output_dims[i] >= 0;
+    }
+    return !resolved && strstr(get_api()->GetErrorMessage(status), "shape verification failed") != NULL;
+}
+
+// A pre-bound output whose symbolic dims don't fit fails Run with a message too long for the error buffer. Runs
+// again with ORT allocating the output to learn its real shape, and reports the same size/shape mismatch errors as
+// speedreader_ort_run. Only used on the error path, once is_output_shape_error says the shape could be the problem.
+// Returns 0 if the output shape wasn't the problem.
+static int write_output_mismatch_error(
+    const SpeedReaderOrtSession* session,
+    OrtRunOptions* run_options,
+    const OrtValue* input_tensor,
+    const int64_t* output_shape,
+    size_t output_ndim,
+    size_t output_count,
+    char* error
+) {
+    const OrtApi* api = get_api();
+    OrtValue* output_tensor = NULL;
+    OrtTensorTypeAndShapeInfo* shape_info = NULL;
+
+    OrtStatus* status = api->Run(
+        session->ort_session,
+        run_options,
+        (const char* const*)session->input_names,
+        &input_tensor,
+        1,  // num_inputs
+        (const char* const*)session->output_names,
+        1,  // num_outputs
+        &output_tensor
+    );
+    if (status == NULL) {
+        status = api->GetTensorTypeAndShape(output_tensor, &shape_info);
+    }
+
+    int64_t actual_shape[SPEEDREADER_ORT_MAX_SHAPE_DIMS];
+    size_t actual_ndim = 0;
+    size_t actual_count = 0;
+    if (status == NULL) {
+        status = api->GetDimensionsCount(shape_info, &actual_ndim);
+    }
+    if (status == NULL && actual_ndim > SPEEDREADER_ORT_MAX_SHAPE_DIMS) {
+        actual_ndim = 0;
+    }
+    if (status == NULL) {
+        status = api->GetDimensions(shape_info, actual_shape, actual_ndim);
+    }
+    if (status == NULL) {
+        status = api->GetTensorShapeElementCount(shape_info, &actual_count);
+    }
+
+    if (shape_info != NULL) {
+        api->ReleaseTensorTypeAndShapeInfo(shape_info);
+    }
+    if (output_tensor != NULL) {
+        api->ReleaseValue(output_tensor);
+    }
+    if (status != NULL) {
+        api->ReleaseStatus(status);
+        return 0;
+    }
+
+    if (actual_count != output_count) {
+        snprintf(error, error == NULL ? 0 : SPEEDREADER_ORT_ERROR_BUF_SIZE,
+                 "output size mismatch: expected %zu, got %zu",
+                 output_count, actual_count);
+        return 1;
+    }
+
+    int matches = actual_ndim == output_ndim;
+    for (size_t i = 0; matches && i < output_ndim; i++) {
+        matches = actual_shape[i] == output_shape[i];
+    }
+    if (matches) {
+        return 0;
+    }
+
+    write_shape_mismatch_error(error, output_shape, output_ndim, "got", actual_shape, actual_ndim);
+    return 1;
+}
+
+// ************
+// Optimized model cache
+// ************
+
+// Maps a file read-only. Returns 0 if it doesn't exist or can't be mapped.
+static int map_file(const char* path, void** data, size_t* size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);  // The mapping keeps the file alive
+
+    if (mapped == MAP_FAILED) {
+        return 0;
+    }
+
+    *data = mapped;
+    *size = (size_t)st.st_size;
+    return 1;
+}
+
+// Loads an ORT format model that was optimized when it was cached, so the optimization passes are skipped. ORT
+// reads the graph and initializers straight from the mapping, which must outlive the session.
+static OrtStatus* create_session_from_cache(
+    const SpeedReaderOrtEnv* env,
+    const OrtSessionOptions* base_options,
+    const void* cached_model,
+    size_t cached_model_size,
+    OrtSession** ort_session
+) {
+    const OrtApi* api = get_api();
+    OrtSessionOptions* session_options = NULL;
+
+    OrtStatus* status = api->CloneSessionOptions(base_options, &session_options);
+    if (status == NULL) {
+        status = api->SetSessionGraphOptimizationLevel(session_options, ORT_DISABLE_ALL);
+    }
+    if (status == NULL) {
+        status = api->AddSessionConfigEntry(session_options, kOrtSessionOptionsConfigUseORTModelBytesDirectly, "1");
+    }
+    if (status == NULL) {
+        status = api->AddSessionConfigEntry(session_options, kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1");
+    }
+    if (status == NULL) {
+        status = api->CreateSessionFromArrayWithPrepackedWeightsContainer(
+            env->ort_env, cached_model, cached_model_size, session_options, env->prepacked_weights, ort_session);
+    }
+
+    if (session_options != NULL) {
+        api->ReleaseSessionOptions(session_options);
+    }
+    return status;
+}
+
+// Optimizes model_data and saves the optimized graph to a temporary file, which is renamed over cache_path once
+// it's complete so a concurrent reader never maps a partial file.
+static OrtStatus* create_session_and_cache(
+    const SpeedReaderOrtEnv* env,
+    const OrtSessionOptions* base_options,
+    const void* model_data,
+    size_t model_data_size,
+    const char* cache_path,
+    OrtSession** ort_session
+) {
+    const OrtApi* api = get_api();
+    OrtSessionOptions* session_options = NULL;
+
+    size_t tmp_path_size = strlen(cache_path) + 32;
+    char* tmp_path = (char*)malloc(tmp_path_size);
+    if (tmp_path == NULL) {
+        return api->CreateStatus(ORT_FAIL, "failed to allocate optimized model path");
+    }
+
+    // A unique name per session, since sessions in one process can cache the same model concurrently. mkstemp creates
+    // the file owner-only; widen it to what a plain create would give, so the cache stays readable to other users
+    snprintf(tmp_path, tmp_path_size, "%s.tmp.XXXXXX", cache_path);
+    int tmp_fd = mkstemp(tmp_path);
+    if (tmp_fd < 0) {
+        free(tmp_path);
+        return api->CreateStatus(ORT_FAIL, "failed to create optimized model file");
+    }
+    fchmod(tmp_fd, 0644);
+    close(tmp_fd);
+
+    OrtStatus* status = api->CloneSessionOptions(base_options, &session_options);
+    if (status == NULL) {
+        status = api->SetOptimizedModelFilePath(session_options, tmp_path);
+    }
+    if (status == NULL) {
+        // The ORT format can be loaded from memory without copying, the ONNX format can't
+        status = api->AddSessionConfigEntry(session_options, kOrtSessionOptionsConfigSaveModelFormat, "ORT");
+    }
+    if (status == NULL) {
+        status = api->CreateSessionFromArrayWithPrepackedWeightsContainer(
+            env->ort_env, model_data, model_data_size, session_options, env->prepacked_weights, ort_session);
+    }
+
+    if (status != NULL || rename(tmp_path, cache_path) != 0) {
+        unlink(tmp_path);
+    }
+
+    if (session_options != NULL) {
+        api->ReleaseSessionOptions(session_options);
+    }
+    free(tmp_path);
+    return status;
+}
+
+static OrtStatus* create_ort_session(
+    SpeedReaderOrtEnv* env,
+    const OrtSessionOptions* session_options,
+    const void* model_data,
+    size_t model_data_size,
+    const char* cache_path,
+    SpeedReaderOrtSession* session
+) {
+    const OrtApi* api = get_api();
+
+    if (cache_path != NULL) {
+        void* cached_model = NULL;
+        size_t cached_model_size = 0;
+        if (map_file(cache_path, &cached_model, &cached_model_size)) {
+            OrtStatus* status = create_session_from_cache(
+                env, session_options, cached_model, cached_model_size, &session->ort_session);
+            if (status == NULL) {
+                session->mapped_model = cached_model;
+                session->mapped_model_size = cached_model_size;
+                return NULL;
+            }
+            api->ReleaseStatus(status);  // Stale or corrupt, rebuild it below
+            munmap(cached_model, cached_model_size);
+        }
+
+        OrtStatus* status = create_session_and_cache(
+            env, session_options, model_data, model_data_size, cache_path, &session->ort_session);
+        if (status == NULL) {
+            return NULL;
+        }
+        api->ReleaseStatus(status);  // Most likely the cache isn't writable, create the session without it
+    }
+
+    return api->CreateSessionFromArrayWithPrepackedWeightsContainer(
+        env->ort_env, model_data, model_data_size, session_options, env->prepacked_weights, &session->ort_session);
+}
+
 // ************
 // Environment management
 // ************
@@ -95,6 +624,14 @@ SpeedReaderOrtStatus speedreader_ort_create_env(
         return SPEEDREADER_ORT_ERROR;
     }
 
+    status = api->CreatePrepackedWeightsContainer(&new_env->prepacked_weights);
+    if (status != NULL) {
+        api->ReleaseEnv(new_env->ort_env);
+        free(new_env);
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
     *env = new_env;
     return SPEEDREADER_ORT_OK;
 }
@@ -105,6 +642,7 @@ void speedreader_ort_destroy_env(SpeedReaderOrtEnv* env) {
     }
 
     const OrtApi* api = get_api();
+    api->ReleasePrepackedWeightsContainer(env->prepacked_weights);
     api->ReleaseEnv(env->ort_env);
     free(env);
 }
@@ -164,21 +702,22 @@ SpeedReaderOrtStatus speedreader_ort_create_session(
         }
     }
 
-    // Allocate session wrapper
-    SpeedReaderOrtSession* new_session = (SpeedReaderOrtSession*)malloc(sizeof(SpeedReaderOrtSession));
+    // Allocate session wrapper, zeroed so a partially constructed session can be released
+    SpeedReaderOrtSession* new_session = (SpeedReaderOrtSession*)calloc(1, sizeof(SpeedReaderOrtSession));
     if (new_session == NULL) {
         api->ReleaseSessionOptions(session_options);
         write_error(error, "failed to allocate session");
         return SPEEDREADER_ORT_ERROR;
     }
 
-    // Create session from model bytes
-    status = api->CreateSessionFromArray(
-        env->ort_env,
+    // Create session from the cached optimized model if there is one, otherwise from model bytes
+    status = create_ort_session(
+        env,
+        session_options,
         model_data,
         model_data_size,
-        session_options,
-        &new_session->ort_session
+        options->optimized_model_path,
+        new_session
     );
 
     api->ReleaseSessionOptions(session_options);
@@ -189,6 +728,25 @@ SpeedReaderOrtStatus speedreader_ort_create_session(
         return SPEEDREADER_ORT_ERROR;
     }
 
+    // Cache everything a run needs so the hot path doesn't allocate
+    status = api->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &new_session->mem_info);
+    if (status == NULL) {
+        status = api->CreateRunOptions(&new_session->run_options);
+    }
+    if (status != NULL) {
+        release_session(new_session);
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    if (read_io_names(new_session->ort_session, 1, &new_session->input_count, &new_session->input_names, error) != SPEEDREADER_ORT_OK ||
+        read_io_names(new_session->ort_session, 0, &new_session->output_count, &new_session->output_names, error) != SPEEDREADER_ORT_OK ||
+        check_single_io(new_session, error) != SPEEDREADER_ORT_OK ||
+        read_output_dims(new_session, error) != SPEEDREADER_ORT_OK) {
+        release_session(new_session);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
     *session = new_session;
     return SPEEDREADER_ORT_OK;
 }
@@ -198,9 +756,72 @@ void speedreader_ort_destroy_session(SpeedReaderOrtSession* session) {
         return;
     }
 
+    release_session(session);
+}
+
+// ************
+// Run options
+// ************
+
+SpeedReaderOrtStatus speedreader_ort_create_run_options(
+    SpeedReaderOrtRunOptions** run_options,
+    char* error
+) {
+    clear_error(error);
+
+    if (run_options == NULL) {
+        write_error(error, "run_options parameter is NULL");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
     const OrtApi* api = get_api();
-    api->ReleaseSession(session->ort_session);
-    free(session);
+
+    SpeedReaderOrtRunOptions* new_run_options = (SpeedReaderOrtRunOptions*)malloc(sizeof(SpeedReaderOrtRunOptions));
+    if (new_run_options == NULL) {
+        write_error(error, "failed to allocate run options");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    OrtStatus* status = api->CreateRunOptions(&new_run_options->ort_run_options);
+    if (status != NULL) {
+        free(new_run_options);
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    *run_options = new_run_options;
+    return SPEEDREADER_ORT_OK;
+}
+
+void speedreader_ort_destroy_run_options(SpeedReaderOrtRunOptions* run_options) {
+    if (run_options == NULL) {
+        return;
+    }
+
+    const OrtApi* api = get_api();
+    api->ReleaseRunOptions(run_options->ort_run_options);
+    free(run_options);
+}
+
+SpeedReaderOrtStatus speedreader_ort_terminate_run(
+    SpeedReaderOrtRunOptions* run_options,
+    char* error
+) {
+    clear_error(error);
+
+    if (run_options == NULL) {
+        write_error(error, "run_options parameter is NULL");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    const OrtApi* api = get_api();
+    OrtStatus* status = api->RunOptionsSetTerminate(run_options->ort_run_options);
+    if (status != NULL) {
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    return SPEEDREADER_ORT_OK;
 }
 
 // ************
@@ -228,18 +849,10 @@ SpeedReaderOrtStatus speedreader_ort_run(
 
     const OrtApi* api = get_api();
     OrtStatus* status = NULL;
-    OrtMemoryInfo* mem_info = NULL;
     OrtValue* input_tensor = NULL;
     OrtValue* output_tensor = NULL;
     OrtTensorTypeAndShapeInfo* shape_info = NULL;
 
-    // Create CPU memory info for input tensor
-    status = api->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &mem_info);
-    if (status != NULL) {
-        write_ort_error(status, error);
-        return SPEEDREADER_ORT_ERROR;
-    }
-
     // Calculate input tensor size
     size_t input_element_count = 1;
     for (size_t i = 0; i < input_ndim; i++) {
@@ -249,7 +862,7 @@ SpeedReaderOrtStatus speedreader_ort_run(
 
     // Create input tensor from existing memory
     status = api->CreateTensorWithDataAsOrtValue(
-        mem_info,
+        session->mem_info,
         (void*)input_data,
         input_size_bytes,
         input_shape,
@@ -258,24 +871,19 @@ SpeedReaderOrtStatus speedreader_ort_run(
         &input_tensor
     );
 
-    api->ReleaseMemoryInfo(mem_info);
-
     if (status != NULL) {
         write_ort_error(status, error);
         return SPEEDREADER_ORT_ERROR;
     }
 
     // Run inference
-    const char* input_names[] = {"input"};
-    const char* output_names[] = {"output"};
-
     status = api->Run(
         session->ort_session,
-        NULL,  // run_options
-        input_names,
+        session->run_options,
+        (const char* const*)session->input_names,
         (const OrtValue* const*)&input_tensor,
         1,  // num_inputs
-        output_names,
+        (const char* const*)session->output_names,
         1,  // num_outputs
         &output_tensor
     );
@@ -363,3 +971,221 @@ SpeedReaderOrtStatus speedreader_ort_run(
     api->ReleaseValue(output_tensor);
     return SPEEDREADER_ORT_OK;
 }
+
+SpeedReaderOrtStatus speedreader_ort_run_into(
+    SpeedReaderOrtSession* session,
+    SpeedReaderOrtRunOptions* run_options,
+    const float* input_data,
+    const int64_t* input_shape,
+    size_t input_ndim,
+    float* output_data,
+    const int64_t* output_shape,
+    size_t output_ndim,
+    char* error
+) {
+    clear_error(error);
+
+    if (session == NULL || input_data == NULL || input_shape == NULL ||
+        output_data == NULL || output_shape == NULL) {
+        write_error(error, "invalid argument: NULL parameter");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    const OrtApi* api = get_api();
+    OrtStatus* status = NULL;
+    OrtValue* input_tensor = NULL;
+    OrtValue* output_tensor = NULL;
+
+    // Calculate tensor sizes
+    size_t input_element_count = 1;
+    for (size_t i = 0; i < input_ndim; i++) {
+        input_element_count *= input_shape[i];
+    }
+    size_t output_element_count = 1;
+    for (size_t i = 0; i < output_ndim; i++) {
+        output_element_count *= output_shape[i];
+    }
+
+    if (check_output_shape(session, output_shape, output_ndim, error) != SPEEDREADER_ORT_OK) {
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    // Wrap caller's input and output buffers without copying
+    status = api->CreateTensorWithDataAsOrtValue(
+        session->mem_info,
+        (void*)input_data,
+        input_element_count * sizeof(float),
+        input_shape,
+        input_ndim,
+        ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT,
+        &input_tensor
+    );
+    if (status != NULL) {
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    status = api->CreateTensorWithDataAsOrtValue(
+        session->mem_info,
+        (void*)output_data,
+        output_element_count * sizeof(float),
+        output_shape,
+        output_ndim,
+        ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT,
+        &output_tensor
+    );
+
+    if (status != NULL) {
+        api->ReleaseValue(input_tensor);
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    // Run inference, ORT writes directly into the pre-bound output tensor
+    OrtRunOptions* ort_run_options = resolve_run_options(session, run_options);
+    status = api->Run(
+        session->ort_session,
+        ort_run_options,
+        (const char* const*)session->input_names,
+        (const OrtValue* const*)&input_tensor,
+        1,  // num_inputs
+        (const char* const*)session->output_names,
+        1,  // num_outputs
+        &output_tensor
+    );
+
+    api->ReleaseValue(output_tensor);
+
+    if (status != NULL) {
+        if (is_output_shape_error(session, status) &&
+            write_output_mismatch_error(session, ort_run_options, input_tensor, output_shape, output_ndim,
+                                        output_element_count, error)) {
+            api->ReleaseStatus(status);
+        } else {
+            write_ort_error(status, error);
+        }
+        api->ReleaseValue(input_tensor);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    api->ReleaseValue(input_tensor);
+    return SPEEDREADER_ORT_OK;
+}
+
+SpeedReaderOrtStatus speedreader_ort_run_argmax(
+    SpeedReaderOrtSession* session,
+    SpeedReaderOrtRunOptions* run_options,
+    const float* input_data,
+    const int64_t* input_shape,
+    size_t input_ndim,
+    float* output_pairs,
+    const int64_t* output_shape,
+    size_t output_ndim,
+    char* error
+) {
+    clear_error(error);
+
+    if (session == NULL || input_data == NULL || input_shape == NULL ||
+        output_pairs == NULL || output_shape == NULL) {
+        write_error(error, "invalid argument: NULL parameter");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    if (output_ndim < 2 || output_ndim > SPEEDREADER_ORT_MAX_SHAPE_DIMS || output_shape[output_ndim - 1] != 2) {
+        write_error(error, "invalid argument: output_shape must end in 2");
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    const OrtApi* api = get_api();
+    OrtStatus* status = NULL;
+    OrtValue* input_tensor = NULL;
+    OrtValue* output_tensor = NULL;
+    OrtTensorTypeAndShapeInfo* shape_info = NULL;
+
+    size_t input_element_count = 1;
+    for (size_t i = 0; i < input_ndim; i++) {
+        input_element_count *= input_shape[i];
+    }
+
+    status = api->CreateTensorWithDataAsOrtValue(
+        session->mem_info,
+        (void*)input_data,
+        input_element_count * sizeof(float),
+        input_shape,
+        input_ndim,
+        ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT,
+        &input_tensor
+    );
+    if (status != NULL) {
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    // ORT allocates the logits from its arena, they only live until the reduction below
+    status = api->Run(
+        session->ort_session,
+        resolve_run_options(session, run_options),
+        (const char* const*)session->input_names,
+        (const OrtValue* const*)&input_tensor,
+        1,  // num_inputs
+        (const char* const*)session->output_names,
+        1,  // num_outputs
+        &output_tensor
+    );
+
+    api->ReleaseValue(input_tensor);
+
+    if (status != NULL) {
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    status = api->GetTensorTypeAndShape(output_tensor, &shape_info);
+    if (status != NULL) {
+        api->ReleaseValue(output_tensor);
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    size_t num_dims = 0;
+    int64_t logits_shape[SPEEDREADER_ORT_MAX_SHAPE_DIMS];
+    status = api->GetDimensionsCount(shape_info, &num_dims);
+    if (status == NULL && num_dims == output_ndim) {
+        status = api->GetDimensions(shape_info, logits_shape, num_dims);
+    }
+    api->ReleaseTensorTypeAndShapeInfo(shape_info);
+
+    if (status != NULL) {
+        api->ReleaseValue(output_tensor);
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    // Every dimension but the last, the classes, must match
+    int matches = num_dims == output_ndim && logits_shape[num_dims - 1] > 0;
+    size_t rows = 1;
+    for (size_t i = 0; matches && i + 1 < num_dims; i++) {
+        matches = logits_shape[i] == output_shape[i];
+        rows *= (size_t)output_shape[i];
+    }
+    if (!matches) {
+        api->ReleaseValue(output_tensor);
+        snprintf(error, SPEEDREADER_ORT_ERROR_BUF_SIZE,
+                 "output shape mismatch: model output has %zu dimensions, expected %zu with the same leading sizes",
+                 num_dims, output_ndim);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    float* logits = NULL;
+    status = api->GetTensorMutableData(output_tensor, (void**)&logits);
+    if (status != NULL) {
+        api->ReleaseValue(output_tensor);
+        write_ort_error(status, error);
+        return SPEEDREADER_ORT_ERROR;
+    }
+
+    argmax_rows(logits, rows, (size_t)logits_shape[num_dims - 1], output_pairs);
+
+    api->ReleaseValue(output_tensor);
+    return SPEEDREADER_ORT_OK;
+}
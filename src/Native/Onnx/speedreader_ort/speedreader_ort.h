@@ -24,6 +24,7 @@ extern "C" {
 
 typedef struct SpeedReaderOrtEnv SpeedReaderOrtEnv;
 typedef struct SpeedReaderOrtSession SpeedReaderOrtSession;
+typedef struct SpeedReaderOrtRunOptions SpeedReaderOrtRunOptions;
 
 // ************
 // Response status codes
@@ -42,6 +43,7 @@ typedef struct {
     int32_t intra_op_num_threads;
     int32_t inter_op_num_threads;
     int32_t enable_profiling;  // 0 = disabled, 1 = enabled
+    const char* optimized_model_path;  // NULL = optimize model_data on every session creation
 } SpeedReaderOrtSessionOptions;
 
 // ************
@@ -54,6 +56,9 @@ typedef struct {
 
 // Environment management (one per process).
 // Not thread-safe.
+//
+// Sessions created in the same environment share one prepacked weights container, so sessions of the same model
+// hold a single copy of the prepacked weights.
 SpeedReaderOrtStatus speedreader_ort_create_env(
     SpeedReaderOrtEnv** env,
     char* error
@@ -62,6 +67,18 @@ void speedreader_ort_destroy_env(SpeedReaderOrtEnv* env);
 
 // Session management (typically one per (model, configuration)).
 // Not thread-safe.
+//
+// The session caches its CPU memory info, I/O names and default run options at creation. Runs feed the model's
+// first input and read its first output.
+//
+// With options->optimized_model_path set, the optimized graph is cached in ORT format at that path:
+// - If the file exists, it is memory-mapped and loaded with graph optimization disabled. Initializers point into the
+//   mapping, so weights stay in the page cache and are shared with every other process that maps the same file
+// - Otherwise, or if the file fails to load (e.g. it was written by another ORT version), model_data is optimized
+//   and the result is written to the path, via a temporary file and a rename so concurrent writers are safe
+// - A cache that can't be written is not an error, the session is created without it
+// The optimized graph may contain layouts specific to the CPU that wrote it, so don't share a cache between hosts
+// with different instruction sets.
 SpeedReaderOrtStatus speedreader_ort_create_session(
     SpeedReaderOrtEnv* env,
     const void* model_data,
@@ -72,6 +89,21 @@ SpeedReaderOrtStatus speedreader_ort_create_session(
 );
 void speedreader_ort_destroy_session(SpeedReaderOrtSession* session);
 
+// Run options (one per cancellable run).
+// Not thread-safe, except speedreader_ort_terminate_run.
+SpeedReaderOrtStatus speedreader_ort_create_run_options(
+    SpeedReaderOrtRunOptions** run_options,
+    char* error
+);
+void speedreader_ort_destroy_run_options(SpeedReaderOrtRunOptions* run_options);
+
+// Requests that any run using run_options stops as soon as possible. Such runs fail with an error.
+// Thread-safe.
+SpeedReaderOrtStatus speedreader_ort_terminate_run(
+    SpeedReaderOrtRunOptions* run_options,
+    char* error
+);
+
 // Inference execution.
 // Thread-safe.
 //
@@ -94,6 +126,54 @@ SpeedReaderOrtStatus speedreader_ort_run(
     char* error
 );
 
+// Inference execution into a caller-owned output buffer.
+// Thread-safe.
+//
+// The caller's buffer is bound directly as the model output, so ORT writes results in place and no copy is made.
+//
+// - run_options: may be NULL to use the session's default run options
+// - output_data: caller-allocated buffer holding exactly the product of output_shape elements
+// - output_shape: expected output shape
+// - output_ndim: number of dimensions in output_shape
+//
+// Returns error if the model's output shape does not match output_shape. The rank and fixed dims are checked against
+// the model before running, symbolic dims by the run itself.
+SpeedReaderOrtStatus speedreader_ort_run_into(
+    SpeedReaderOrtSession* session,
+    SpeedReaderOrtRunOptions* run_options,
+    const float* input_data,
+    const int64_t* input_shape,
+    size_t input_ndim,
+    float* output_data,
+    const int64_t* output_shape,
+    size_t output_ndim,
+    char* error
+);
+
+// Inference execution reduced to the argmax of the last output dimension, for CTC models like SVTR.
+// Thread-safe.
+//
+// ORT allocates the [..., classes] output, which is reduced to (index, max value) pairs before returning, so only
+// 2 floats per step are written instead of a whole vocabulary's worth. Ties go to the lowest index.
+//
+// - run_options: may be NULL to use the session's default run options
+// - output_pairs: caller-allocated buffer holding exactly the product of output_shape elements
+// - output_shape: the model's output shape with the last dimension replaced by 2
+// - output_ndim: number of dimensions in output_shape
+//
+// Returns error if the model's output shape, apart from the last dimension, does not match output_shape.
+SpeedReaderOrtStatus speedreader_ort_run_argmax(
+    SpeedReaderOrtSession* session,
+    SpeedReaderOrtRunOptions* run_options,
+    const float* input_data,
+    const int64_t* input_shape,
+    size_t input_ndim,
+    float* output_pairs,
+    const int64_t* output_shape,
+    size_t output_ndim,
+    char* error
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,83 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+namespace SpeedReader.Native.Threading;
+
+public enum CoreKind
+{
+    Performance,
+    Efficiency
+}
+
+public record LogicalCpu
+{
+    public required int Id { get; init; }
+    public required int Core { get; init; }  // Lowest logical CPU id of the physical core, shared by SMT siblings
+    public required int NumaNode { get; init; }
+    public required CoreKind Kind { get; init; }
+}
+
+// The CPUs this process may run on, as discovered at startup
+public class CpuTopology
+{
+    public IReadOnlyList<LogicalCpu> Cpus { get; }  // Ordered by id
+    public double? CpuQuota { get; }  // cgroup CPU bandwidth limit in CPUs, null if unlimited
+
+    public CpuTopology(IEnumerable<LogicalCpu> cpus, double? cpuQuota = null)
+    {
+        Cpus = cpus.OrderBy(cpu => cpu.Id).ToList().AsReadOnly();
+        if (Cpus.Count == 0)
+            throw new ArgumentException("Topology must contain at least one CPU", nameof(cpus));
+        if (cpuQuota is <= 0)
+            throw new ArgumentOutOfRangeException(nameof(cpuQuota));
+        CpuQuota = cpuQuota;
+    }
+
+    // One logical CPU per physical core (the first SMT sibling), grouped by NUMA node
+    public int[] PerformanceCores => PhysicalCores(CoreKind.Performance);
+    public int[] EfficiencyCores => PhysicalCores(CoreKind.Efficiency);
+
+    // Number of busy threads the process can actually run at once: one per physical core, capped by the cgroup quota
+    public int MaxConcurrency
+    {
+        get
+        {
+            var cores = Cpus.Select(cpu => cpu.Core).Distinct().Count();
+            return CpuQuota is { } quota ? Math.Clamp((int)Math.Ceiling(quota), 1, cores) : cores;
+        }
+    }
+
+    private int[] PhysicalCores(CoreKind kind) => Cpus
+        .Where(cpu => cpu.Kind == kind)
+        .GroupBy(cpu => cpu.Core)
+        .Select(core => core.First())
+        .OrderBy(cpu => cpu.NumaNode)
+        .ThenBy(cpu => cpu.Id)
+        .Select(cpu => cpu.Id)
+        .ToArray();
+
+    public static CpuTopology Current => field ??= Discover();
+
+    public static CpuTopology Discover()
+    {
+        if (OperatingSystem.IsLinux())
+        {
+            try
+            {
+                return LinuxCpuTopology.Read("/");
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or FormatException)
+            {
+                // Restricted or unusual sysfs, treat every CPU as its own performance core below
+            }
+        }
+
+        return new CpuTopology(Enumerable.Range(0, Environment.ProcessorCount).Select(id => new LogicalCpu
+        {
+            Id = id,
+            Core = id,
+            NumaNode = 0,
+            Kind = CoreKind.Performance
+        }));
+    }
+}
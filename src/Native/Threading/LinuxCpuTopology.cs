@@ -0,0 +1,169 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Globalization;
+
+namespace SpeedReader.Native.Threading;
+
+// Reads CPU topology from sysfs and procfs. root is "/" outside of tests
+internal static class LinuxCpuTopology
+{
+    public static CpuTopology Read(string root)
+    {
+        var cpuDir = Path.Combine(root, "sys/devices/system/cpu");
+
+        // Cpus_allowed_list is the affinity mask, which the kernel already intersects with the cgroup cpuset
+        var online = ParseCpuList(File.ReadAllText(Path.Combine(cpuDir, "online")));
+        var allowed = ReadAllowedCpus(root);
+        var ids = online.Where(id => allowed?.Contains(id) ?? true).Distinct().Order().ToList();
+        if (ids.Count == 0)
+            throw new FormatException("No online CPUs are allowed for this process");
+
+        var numaNodes = ReadNumaNodes(root);
+        var kinds = ReadCoreKinds(root, cpuDir, ids);
+
+        var cpus = ids.Select(id => new LogicalCpu
+        {
+            Id = id,
+            Core = ReadCore(cpuDir, id),
+            NumaNode = numaNodes.GetValueOrDefault(id, 0),
+            Kind = kinds[id]
+        });
+
+        return new CpuTopology(cpus, ReadCpuQuota(root));
+    }
+
+    // Lowest id among SMT siblings; without topology info every CPU is its own core
+    private static int ReadCore(string cpuDir, int id)
+    {
+        var siblings = Path.Combine(cpuDir, $"cpu{id}/topology/thread_siblings_list");
+        return File.Exists(siblings) ? ParseCpuList(File.ReadAllText(siblings)).Min() : id;
+    }
+
+    private static HashSet<int>? ReadAllowedCpus(string root)
+    {
+        var status = Path.Combine(root, "proc/self/status");
+        if (!File.Exists(status))
+            return null;
+
+        const string prefix = "Cpus_allowed_list:";
+        var line = File.ReadLines(status).FirstOrDefault(l => l.StartsWith(prefix, StringComparison.Ordinal));
+        return line == null ? null : ParseCpuList(line[prefix.Length..]).ToHashSet();
+    }
+
+    private static Dictionary<int, int> ReadNumaNodes(string root)
+    {
+        var nodes = new Dictionary<int, int>();
+        var nodeDir = Path.Combine(root, "sys/devices/system/node");
+        if (!Directory.Exists(nodeDir))
+            return nodes;
+
+        foreach (var dir in Directory.EnumerateDirectories(nodeDir, "node*"))
+        {
+            if (!int.TryParse(Path.GetFileName(dir)["node".Length..], out var node))
+                continue;
+            var cpuList = Path.Combine(dir, "cpulist");
+            if (!File.Exists(cpuList))
+                continue;
+            foreach (var cpu in ParseCpuList(File.ReadAllText(cpuList)))
+                nodes[cpu] = node;
+        }
+
+        return nodes;
+    }
+
+    private static Dictionary<int, CoreKind> ReadCoreKinds(string root, string cpuDir, List<int> ids)
+    {
+        // Intel hybrid parts register a separate PMU for the efficiency cores
+        var atomCpus = Path.Combine(root, "sys/devices/cpu_atom/cpus");
+        if (File.Exists(atomCpus))
+        {
+            var efficiency = ParseCpuList(File.ReadAllText(atomCpus)).ToHashSet();
+            return ids.ToDictionary(id => id, id => efficiency.Contains(id) ? CoreKind.Efficiency : CoreKind.Performance);
+        }
+
+        // Asymmetric ARM (and newer x86) kernels report relative capacity per CPU, the biggest cores being 1024
+        var capacities = new Dictionary<int, int>();
+        foreach (var id in ids)
+        {
+            var capacityFile = Path.Combine(cpuDir, $"cpu{id}/cpu_capacity");
+            if (File.Exists(capacityFile))
+                capacities[id] = int.Parse(File.ReadAllText(capacityFile).Trim(), CultureInfo.InvariantCulture);
+        }
+
+        var maxCapacity = capacities.Count == ids.Count ? capacities.Values.Max() : 0;
+        return ids.ToDictionary(id => id,
+            id => maxCapacity > 0 && capacities[id] < maxCapacity ? CoreKind.Efficiency : CoreKind.Performance);
+    }
+
+    private static double? ReadCpuQuota(string root)
+    {
+        var cgroupFile = Path.Combine(root, "proc/self/cgroup");
+        if (!File.Exists(cgroupFile))
+            return null;
+
+        foreach (var line in File.ReadLines(cgroupFile))
+        {
+            // hierarchy-id:controllers:path
+            var parts = line.Split(':', 3);
+            if (parts.Length != 3)
+                continue;
+            var path = parts[2].TrimStart('/');
+
+            if (parts[0] == "0" && parts[1] == "")
+            {
+                // cgroup v2: "max 100000" or "<quota> <period>"
+                var cpuMax = Path.Combine(root, "sys/fs/cgroup", path, "cpu.max");
+                if (!File.Exists(cpuMax))
+                    continue;
+                var fields = File.ReadAllText(cpuMax).Split(' ', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries);
+                if (fields.Length == 2 && fields[0] != "max")
+                    return Quota(fields[0], fields[1]);
+            }
+            else if (parts[1].Split(',').Contains("cpu"))
+            {
+                // cgroup v1: quota is -1 when unlimited
+                var controllerDir = Path.Combine(root, "sys/fs/cgroup", parts[1], path);
+                var quotaFile = Path.Combine(controllerDir, "cpu.cfs_quota_us");
+                var periodFile = Path.Combine(controllerDir, "cpu.cfs_period_us");
+                if (!File.Exists(quotaFile) || !File.Exists(periodFile))
+                    continue;
+                var quota = File.ReadAllText(quotaFile).Trim();
+                if (quota != "-1")
+                    return Quota(quota, File.ReadAllText(periodFile).Trim());
+            }
+        }
+
+        return null;
+
+        static double? Quota(string quota, string period)
+        {
+            var q = long.Parse(quota, CultureInfo.InvariantCulture);
+            var p = long.Parse(period, CultureInfo.InvariantCulture);
+            return q > 0 && p > 0 ? (double)q / p : null;
+        }
+    }
+
+    // Kernel cpu list format, e.g. "0-3,8,10-11"
+    internal static List<int> ParseCpuList(string list)
+    {
+        var cpus = new List<int>();
+        foreach (var range in list.Split(',', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries))
+        {
+            var dash = range.IndexOf('-');
+            if (dash < 0)
+            {
+                cpus.Add(int.Parse(range, CultureInfo.InvariantCulture));
+                continue;
+            }
+
+            var first = int.Parse(range[..dash], CultureInfo.InvariantCulture);
+            var last = int.Parse(range[(dash + 1)..], CultureInfo.InvariantCulture);
+            if (last < first)
+                throw new FormatException($"Invalid CPU range '{range}'");
+            for (var cpu = first; cpu <= last; cpu++)
+                cpus.Add(cpu);
+        }
+        return cpus;
+    }
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Native.DbNet;
+using SpeedReader.Ocr.Algorithms;
+using SpeedReader.Ocr.Geometry;
+
+namespace SpeedReader.Ocr.Test.Algorithms;
+
+public class ConnectedComponentsTests
+{
+    [Fact]
+    public void LabelConnectedComponents_MorphologicalOpening_RemovesSmallNoise()
+    {
+        float[] data =
+        [
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f,
+            0f, 1f, 0f, 0f, 0f, 0f, 0f, 1f, 0f,  // isolated pixels
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f,
+            0f, 0f, 0f, 1f, 1f, 1f, 0f, 0f, 0f,
+            0f, 0f, 0f, 1f, 1f, 1f, 0f, 0f, 0f,  // 3x3 solid block (survives)
+            0f, 0f, 0f, 1f, 1f, 1f, 0f, 0f, 0f,
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f,
+            0f, 1f, 0f, 0f, 0f, 0f, 0f, 1f, 0f,  // isolated pixels
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f
+        ];
+
+        var components = new ReliefMap(data, width: 9, height: 9).LabelConnectedComponents();
+
+        var component = Assert.Single(components);
+        Assert.Equal(9, component.Area);
+        Assert.Equal(new AxisAlignedRectangle { X = 3, Y = 3, Width = 3, Height = 3 }, component.Bounds);
+        Assert.Equal(new[] { (3, 3), (4, 3), (5, 3), (5, 4), (5, 5), (4, 5), (3, 5), (3, 4) },
+            component.Contour.Points.Select(p => ((int)p.X, (int)p.Y)));
+    }
+
+    [Fact]
+    public void LabelConnectedComponents_MultipleShapes_OrderedByTopLeftPixel()
+    {
+        float[] data =
+        [
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f,
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 1f, 1f, 1f, 0f,
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 1f, 1f, 1f, 0f,
+            0f, 1f, 1f, 1f, 1f, 0f, 0f, 1f, 1f, 1f, 0f,
+            0f, 1f, 1f, 1f, 1f, 0f, 0f, 0f, 0f, 0f, 0f,
+            0f, 1f, 1f, 1f, 1f, 0f, 0f, 0f, 0f, 0f, 0f,
+            0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f, 0f
+        ];
+
+        var components = new ReliefMap(data, width: 11, height: 7).LabelConnectedComponents();
+
+        Assert.Equal(2, components.Count);
+        Assert.Equal(new AxisAlignedRectangle { X = 7, Y = 1, Width = 3, Height = 3 }, components[0].Bounds);
+        Assert.Equal(new AxisAlignedRectangle { X = 1, Y = 3, Width = 4, Height = 3 }, components[1].Bounds);
+    }
+
+    [Fact]
+    public void LabelConnectedComponents_UShape_IsOneComponent()
+    {
+        // Arms join only at the bottom, so they are labelled separately at first and merged later
+        var components = new ReliefMap(UShape(), width: 12, height: 10).LabelConnectedComponents();
+
+        var component = Assert.Single(components);
+        Assert.Equal(new AxisAlignedRectangle { X = 1, Y = 1, Width = 10, Height = 8 }, component.Bounds);
+
+        // The contour follows the notch between the arms instead of bridging it
+        var contour = component.Contour.Points.Select(p => ((int)p.X, (int)p.Y)).ToList();
+        Assert.Contains((5, 6), contour);
+        Assert.Contains((3, 3), contour);
+        Assert.Contains((8, 3), contour);
+        Assert.DoesNotContain(contour, p => p.Item1 is > 3 and < 8 && p.Item2 < 6);
+    }
+
+    [Fact]
+    public void LabelConnectedComponents_Contour_WalksEveryOuterPixelClockwise()
+    {
+        var component = Assert.Single(new ReliefMap(LShape(), width: 7, height: 8).LabelConnectedComponents());
+
+        // L shape, the contour turns into the inner corner, cutting it diagonally as 8-connected tracing does
+        Assert.Equal(new[]
+            {
+                (1, 1), (2, 1), (3, 1), (4, 1), (5, 1), (5, 2), (5, 3), (4, 3), (3, 4), (3, 5), (3, 6), (2, 6),
+                (1, 6), (1, 5), (1, 4), (1, 3), (1, 2)
+            },
+            component.Contour.Points.Select(p => ((int)p.X, (int)p.Y)));
+    }
+
+    [Fact]
+    public void LabelConnectedComponents_UShape_MatchesNative() => AssertMatchesNative(UShape(), width: 12, height: 10);
+
+    [Fact]
+    public void LabelConnectedComponents_LShape_MatchesNative() => AssertMatchesNative(LShape(), width: 7, height: 8);
+
+    [Fact]
+    public void LabelConnectedComponents_EmptyInput_ReturnsEmpty()
+    {
+        var components = new ReliefMap(new float[9], width: 3, height: 3).LabelConnectedComponents();
+
+        Assert.Empty(components);
+    }
+
+    [Fact]
+    public void LabelConnectedComponents_DoesNotMutateReliefMap()
+    {
+        var data = Enumerable.Range(0, 64).Select(i => (i % 7) / 7f).ToArray();
+        var copy = data.ToArray();
+
+        _ = new ReliefMap(data, width: 8, height: 8).LabelConnectedComponents();
+
+        Assert.Equal(copy, data);
+    }
+
+    [Fact]
+    public void LabelConnectedComponents_PropertyTest_RandomShapes_MatchesTraceAllBoundaries()
+    {
+        var numIterations = 2000;
+
+        Parallel.ForEach(Enumerable.Range(0, numIterations), iteration =>
+        {
+            var random = new Random(iteration);
+
+            // Well separated rectangles, so components don't touch diagonally after opening (TraceAllBoundaries
+            // flood fills with 4-connectivity and would report those twice)
+            var width = 80;
+            var height = 60;
+            var data = new float[width * height];
+            for (var cell = 0; cell < 4; cell++)
+            {
+                if (random.Next(4) == 0)
+                    continue;
+                var left = cell % 2 * 40 + random.Next(1, 10);
+                var top = cell / 2 * 30 + random.Next(1, 10);
+                var right = left + random.Next(3, 28);
+                var bottom = top + random.Next(3, 18);
+                for (var y = top; y < bottom; y++)
+                {
+                    for (var x = left; x < right; x++)
+                        data[y * width + x] = (float)(0.2 + 0.8 * random.NextDouble());
+                }
+            }
+
+            var components = new ReliefMap([.. data], width, height).LabelConnectedComponents();
+            var boundaries = new ReliefMap([.. data], width, height).TraceAllBoundaries();
+
+            // Property: same regions, in the same order, with the same extents
+            Assert.Equal(boundaries.Count, components.Count);
+            foreach (var (component, boundary) in components.Zip(boundaries))
+            {
+                var bounds = component.Bounds;
+                Assert.Equal(boundary.Points.Min(p => p.X), bounds.X);
+                Assert.Equal(boundary.Points.Min(p => p.Y), bounds.Y);
+                Assert.Equal(boundary.Points.Max(p => p.X), bounds.X + bounds.Width - 1);
+                Assert.Equal(boundary.Points.Max(p => p.Y), bounds.Y + bounds.Height - 1);
+                Assert.Equal(bounds.Width * bounds.Height, component.Area);  // Rectangles stay rectangles
+            }
+        });
+    }
+
+    private static float[] UShape()
+    {
+        var width = 12;
+        var data = new float[width * 10];
+        for (var y = 1; y < 9; y++)
+        {
+            for (var x = 1; x < 11; x++)
+            {
+                if (x < 4 || x > 7 || y > 5)
+                    data[y * width + x] = 1;
+            }
+        }
+        return data;
+    }
+
+    private static float[] LShape() =>
+    [
+        0f, 0f, 0f, 0f, 0f, 0f, 0f,
+        0f, 1f, 1f, 1f, 1f, 1f, 0f,
+        0f, 1f, 1f, 1f, 1f, 1f, 0f,
+        0f, 1f, 1f, 1f, 1f, 1f, 0f,
+        0f, 1f, 1f, 1f, 0f, 0f, 0f,
+        0f, 1f, 1f, 1f, 0f, 0f, 0f,
+        0f, 1f, 1f, 1f, 0f, 0f, 0f,
+        0f, 0f, 0f, 0f, 0f, 0f, 0f
+    ];
+
+    // speedreader_dbnet with no dilation, so its polygon is the traced contour and its rectangle is fitted to it
+    private static void AssertMatchesNative(float[] data, int width, int height)
+    {
+        var component = Assert.Single(new ReliefMap([.. data], width, height).LabelConnectedComponents());
+        var box = Assert.Single(DbNetPostprocessor.FindBoxes(data, width, height, new DbNetBoxOptions
+        {
+            Threshold = 0.2f,
+            SimplifyEpsilon = 0,
+            Scale = 1,
+            DilationRatio = 0,
+            MaxX = width - 1,
+            MaxY = height - 1
+        }, out _));
+
+        // The managed contour has every boundary pixel and the native one is simplified, so compare their corners
+        var managedContour = component.Contour.Points.Select(p => ((double)p.X, (double)p.Y)).ToList();
+        Assert.Equal(Vertices(managedContour), Vertices(Pairs(box.Polygon)));
+
+        var rectangle = component.Contour.ToConvexHull()!.ToRotatedRectangle()!.Corners().Points;
+        Assert.Equal(Rounded(rectangle.Select(p => ((double)p.X, (double)p.Y))), Rounded(Pairs(box.Corners)));
+
+        static List<(double, double)> Pairs(double[] coordinates) =>
+            Enumerable.Range(0, coordinates.Length / 2).Select(i => (coordinates[2 * i], coordinates[2 * i + 1]))
+                .ToList();
+
+        // Corners of the closed polygon, in order
+        static List<(double, double)> Vertices(List<(double X, double Y)> points) =>
+            points.Where((p, i) =>
+            {
+                var previous = points[(i + points.Count - 1) % points.Count];
+                var next = points[(i + 1) % points.Count];
+                return (p.X - previous.X) * (next.Y - previous.Y) != (p.Y - previous.Y) * (next.X - previous.X);
+            }).ToList();
+
+        static List<(double, double)> Rounded(IEnumerable<(double X, double Y)> corners) =>
+            corners.Select(p => (Math.Round(p.X, 3), Math.Round(p.Y, 3))).Order().ToList();
+    }
+}
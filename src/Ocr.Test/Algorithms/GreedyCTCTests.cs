@@ -285,4 +285,33 @@ public class GreedyCTCTests
 
         return maxIndex;
     }
+
+    [Fact]
+    public void GreedyCTCDecodeArgmax_SameSequence_MatchesGreedyCTCDecode()
+    {
+        // Arrange
+        var numClasses = _dictionary.Count;
+        var steps = new (int Index, float Prob)[]
+        {
+            (EmbeddedCharDict.Blank, 0.9f), (1, 0.6f), (1, 0.8f), (EmbeddedCharDict.Blank, 0.9f), (1, 0.7f),
+            (2, 0.5f), (2, 0.9f)
+        };
+        var ctcSequence = new float[numClasses * steps.Length];
+        var argmaxSequence = new float[2 * steps.Length];
+        for (int step = 0; step < steps.Length; step++)
+        {
+            ctcSequence[step * numClasses + steps[step].Index] = steps[step].Prob;
+            argmaxSequence[2 * step] = steps[step].Index;
+            argmaxSequence[2 * step + 1] = steps[step].Prob;
+        }
+
+        // Act
+        var expected = ctcSequence.GreedyCTCDecode(_dictionary);
+        var actual = argmaxSequence.GreedyCTCDecodeArgmax(_dictionary);
+
+        // Assert
+        Assert.Equal(3, actual.Text.Length);
+        Assert.Equal(expected.Text, actual.Text);
+        Assert.Equal(expected.Confidence, actual.Confidence, precision: 10);
+    }
 }
@@ -0,0 +1,97 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+using SixLabors.ImageSharp.Processing;
+using SpeedReader.Ocr.Algorithms;
+
+namespace SpeedReader.Ocr.Test.Algorithms;
+
+public class ResizeToTensorTests
+{
+    private static readonly float[] Means = [123.675f, 116.28f, 103.53f];
+    private static readonly float[] Stds = [58.395f, 57.12f, 57.375f];
+
+    private static Image<Rgb24> RandomImage(int width, int height, int seed)
+    {
+        var random = new Random(seed);
+        var image = new Image<Rgb24>(width, height);
+        for (var y = 0; y < height; y++)
+        {
+            for (var x = 0; x < width; x++)
+                image[x, y] = new Rgb24((byte)random.Next(256), (byte)random.Next(256), (byte)random.Next(256));
+        }
+        return image;
+    }
+
+    [Fact]
+    public void ResizeToNormalizedChwTensor_NoResize_MatchesToNormalizedChwTensor()
+    {
+        using var image = RandomImage(37, 23, seed: 1);
+        var tile = new Rectangle(5, 3, 16, 16);
+        var expected = image.ToNormalizedChwTensor(tile, Means, Stds);
+
+        var actual = new float[3 * 16 * 16];
+        image.ResizeToNormalizedChwTensor(new Size(37, 23), tile, Means, Stds, actual);
+
+        for (var i = 0; i < expected.Length; i++)
+            Assert.Equal(expected[i], actual[i], precision: 4);
+    }
+
+    [Theory]
+    [InlineData(50, 40, 96, 96)]  // Upscale
+    [InlineData(200, 120, 64, 64)]  // Downscale
+    [InlineData(100, 30, 120, 120)]  // Wide, padded at the bottom
+    [InlineData(30, 100, 120, 120)]  // Tall, padded on the right
+    public void ResizeToNormalizedChwTensor_MatchesImageSharpPadResize(int width, int height, int tiledWidth, int tiledHeight)
+    {
+        using var image = RandomImage(width, height, seed: width * height);
+        using var resized = image.Clone(x => x.Resize(new ResizeOptions
+        {
+            Size = new Size(tiledWidth, tiledHeight),
+            Mode = ResizeMode.Pad,
+            Position = AnchorPositionMode.TopLeft
+        }));
+
+        var widthRatio = tiledWidth / (float)width;
+        var heightRatio = tiledHeight / (float)height;
+        var fittedSize = heightRatio < widthRatio
+            ? new Size((int)MathF.Round(width * heightRatio), tiledHeight)
+            : new Size(tiledWidth, (int)MathF.Round(height * widthRatio));
+
+        var tileSize = tiledWidth / 2;
+        foreach (var tile in new[] { new Rectangle(0, 0, tileSize, tileSize), new Rectangle(tileSize, tileSize, tileSize, tileSize) })
+        {
+            var expected = resized.ToNormalizedChwTensor(tile, Means, Stds);
+            var actual = new float[expected.Length];
+            image.ResizeToNormalizedChwTensor(fittedSize, tile, Means, Stds, actual);
+
+            // ImageSharp rounds the resized image to bytes, the fused kernel doesn't
+            for (var i = 0; i < expected.Length; i++)
+                Assert.True(Math.Abs(expected[i] - actual[i]) < 0.03, $"Index {i}: expected {expected[i]}, got {actual[i]}");
+        }
+    }
+
+    [Fact]
+    public void ResizeToNormalizedChwTensor_TileOutsideImage_IsPadding()
+    {
+        using var image = RandomImage(10, 10, seed: 2);
+        var actual = new float[3 * 8 * 8];
+        image.ResizeToNormalizedChwTensor(new Size(16, 16), new Rectangle(16, 0, 8, 8), Means, Stds, actual);
+
+        for (var c = 0; c < 3; c++)
+        {
+            var padding = -Means[c] / Stds[c];
+            Assert.All(actual.AsSpan(c * 64, 64).ToArray(), v => Assert.Equal(padding, v, precision: 4));
+        }
+    }
+
+    [Fact]
+    public void ResizeToNormalizedChwTensor_WrongResultLength_Throws()
+    {
+        using var image = RandomImage(10, 10, seed: 3);
+        Assert.Throws<ArgumentException>(() =>
+            image.ResizeToNormalizedChwTensor(new Size(10, 10), new Rectangle(0, 0, 4, 4), Means, Stds, new float[10]));
+    }
+}
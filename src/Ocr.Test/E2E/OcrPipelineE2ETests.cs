@@ -38,7 +38,7 @@ public class OcrPipelineE2ETests : IAsyncLifetime
         ]);
 
         // Act
-        var actualResult = await ReadOne(expectedResult.Image, expectedResult);
+        var actualResult = await ReadOne(expectedResult.Image!, expectedResult);
 
         // Assert
         Utils.ValidateDetectionsAndRecognitions(expectedResult, actualResult);
@@ -56,7 +56,7 @@ public class OcrPipelineE2ETests : IAsyncLifetime
         ]);
 
         // Act
-        var actualResult = await ReadOne(expectedResult.Image, expectedResult);
+        var actualResult = await ReadOne(expectedResult.Image!, expectedResult);
 
         // Assert
         Utils.ValidateDetectionsAndRecognitions(expectedResult, actualResult);
@@ -73,7 +73,7 @@ public class OcrPipelineE2ETests : IAsyncLifetime
         ]);
 
         // Act
-        var actualResult = await ReadOne(expectedResult.Image, expectedResult);
+        var actualResult = await ReadOne(expectedResult.Image!, expectedResult);
 
         // Assert
         Utils.ValidateDetectionsAndRecognitions(expectedResult, actualResult);
@@ -91,7 +91,7 @@ public class OcrPipelineE2ETests : IAsyncLifetime
         ]);
 
         // Act
-        var actualResult = await ReadOne(expectedResult.Image, expectedResult);
+        var actualResult = await ReadOne(expectedResult.Image!, expectedResult);
 
         // Assert
         Utils.ValidateDetectionsAndRecognitions(expectedResult, actualResult);
@@ -109,7 +109,7 @@ public class OcrPipelineE2ETests : IAsyncLifetime
         ]);
 
         // Act
-        var actualResult = await ReadOne(expectedResult.Image, expectedResult);
+        var actualResult = await ReadOne(expectedResult.Image!, expectedResult);
 
         // Assert
         Utils.ValidateDetectionsAndRecognitions(expectedResult, actualResult);
@@ -138,7 +138,7 @@ public class OcrPipelineE2ETests : IAsyncLifetime
         List<OcrPipelineResult> expectedResults = [expectedResult1, expectedResult2, expectedResult3];
 
         // Act
-        var images = expectedResults.Select(r => r.Image).ToList();
+        var images = expectedResults.Select(r => r.Image!).ToList();
         var actualResults = await ReadMany(images, expectedResults);
 
         // Assert
@@ -213,7 +213,8 @@ public class OcrPipelineE2ETests : IAsyncLifetime
                     numIntraOpThreads: 4),
                 MaxParallelism = 1,
                 ReservedPCores = [0, 2, 4, 6]
-            }
+            },
+            Visualize = true  // The tests render SVGs
         };
 
         var services = new ServiceCollection();
@@ -31,7 +31,7 @@ public class TextDetectorE2ETests
         ]);
 
         // Act
-        var actual = await RunDetection(expected.Image, expected.Detections);
+        var actual = await RunDetection(expected.Image!, expected.Detections);
 
         // Assert
         Utils.ValidateDetections(expected.Detections, actual);
@@ -49,7 +49,7 @@ public class TextDetectorE2ETests
         ]);
 
         // Act
-        var actual = await RunDetection(expected.Image, expected.Detections);
+        var actual = await RunDetection(expected.Image!, expected.Detections);
 
         // Assert
         Utils.ValidateDetections(expected.Detections, actual);
@@ -62,7 +62,7 @@ public class TextDetectorE2ETests
         var expected = Utils.CreateTestImage(720, 640, []);
 
         // Act
-        var actual = await RunDetection(expected.Image, expected.Detections);
+        var actual = await RunDetection(expected.Image!, expected.Detections);
 
         // Assert
         Utils.ValidateDetections(expected.Detections, actual);
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Collections.Concurrent;
+
+namespace SpeedReader.Ocr.Test.FlowControl;
+
+public class FairSharePoolTests
+{
+    [Fact]
+    public async Task Execute_PoolFull_AdmitsTenantsInProportionToWeight()
+    {
+        var pool = new FairSharePool<int>(poolSize: 1);
+        var blocker = pool.AddTenant();
+        var light = pool.AddTenant(weight: 1);
+        var heavy = pool.AddTenant(weight: 2);
+        var starts = new ConcurrentQueue<string>();
+
+        var gate = new TaskCompletionSource<int>();
+        _ = await blocker.Execute(() => gate.Task);
+        var queued = Enumerable.Range(0, 12)
+            .SelectMany(_ => new[]
+            {
+                light.Execute(() => Record(starts, "light")),
+                heavy.Execute(() => Record(starts, "heavy"))
+            })
+            .ToList();
+
+        gate.SetResult(0);
+        await Task.WhenAll(queued.Select(async task => await await task)).WaitAsync(TimeSpan.FromSeconds(5));
+
+        Assert.Equal(8, starts.Take(12).Count(tenant => tenant == "heavy"));
+    }
+
+    [Fact]
+    public async Task Execute_TenantWasIdle_DoesNotBankCredit()
+    {
+        var pool = new FairSharePool<int>(poolSize: 1);
+        var busy = pool.AddTenant();
+        var idle = pool.AddTenant();
+        var starts = new ConcurrentQueue<string>();
+
+        for (var i = 0; i < 10; i++)
+            await await busy.Execute(() => Task.FromResult(i));
+
+        var gate = new TaskCompletionSource<int>();
+        _ = await busy.Execute(() => gate.Task);
+        var queued = Enumerable.Range(0, 4)
+            .SelectMany(_ => new[]
+            {
+                busy.Execute(() => Record(starts, "busy")),
+                idle.Execute(() => Record(starts, "idle"))
+            })
+            .ToList();
+
+        gate.SetResult(0);
+        await Task.WhenAll(queued.Select(async task => await await task)).WaitAsync(TimeSpan.FromSeconds(5));
+
+        // Shares alternate from now on rather than the idle tenant catching up on the 10 it didn't use
+        Assert.Equal(2, starts.Take(4).Count(tenant => tenant == "idle"));
+    }
+
+    [Fact]
+    public async Task Dispose_QueuedWork_StillRuns()
+    {
+        var pool = new FairSharePool<int>(poolSize: 1);
+        var tenant = pool.AddTenant();
+        var gate = new TaskCompletionSource<int>();
+        _ = await tenant.Execute(() => gate.Task);
+
+        var queued = tenant.Execute(() => Task.FromResult(1));
+        tenant.Dispose();
+        gate.SetResult(0);
+
+        Assert.Equal(1, await await queued.WaitAsync(TimeSpan.FromSeconds(5)));
+    }
+
+    [Fact]
+    public async Task TryExecute_PoolFull_ReturnsFalseWithoutQueueing()
+    {
+        var pool = new FairSharePool<int>(poolSize: 1);
+        var first = pool.AddTenant();
+        var second = pool.AddTenant();
+        var gate = new TaskCompletionSource<int>();
+
+        Assert.True(first.TryExecute(() => gate.Task, out var running));
+        Assert.False(second.TryExecute(() => Task.FromResult(1), out _));
+        Assert.Equal(1, pool.PoolOccupancy);
+
+        gate.SetResult(0);
+        await running;
+        Assert.True(second.TryExecute(() => Task.FromResult(1), out var started));
+        Assert.Equal(1, await started);
+    }
+
+    [Fact]
+    public void Weight_LessThanOne_Throws() =>
+        Assert.Throws<ArgumentOutOfRangeException>(() => new FairSharePool<int>(poolSize: 1).AddTenant(weight: 0));
+
+    private static Task<int> Record(ConcurrentQueue<string> starts, string tenant)
+    {
+        starts.Enqueue(tenant);
+        return Task.FromResult(0);
+    }
+}
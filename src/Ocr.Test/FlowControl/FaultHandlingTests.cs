@@ -111,7 +111,7 @@ public class OcrPipelineTests
         Assert.NotNull(firstResultWrapper);
         Assert.True(firstResultWrapper.HasValue());
         var firstResult = firstResultWrapper.Value();
-        firstResult.Image.Dispose();
+        firstResult.Image?.Dispose();
 
         // Second result should fail with TestException
         var secondResultWrapper = await Next(enumerator);
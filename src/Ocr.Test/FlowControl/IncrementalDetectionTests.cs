@@ -0,0 +1,76 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.Drawing.Processing;
+using SixLabors.ImageSharp.PixelFormats;
+using SixLabors.ImageSharp.Processing;
+using SpeedReader.Ocr.Geometry;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.Visualization;
+
+namespace SpeedReader.Ocr.Test.FlowControl;
+
+public class IncrementalDetectionTests
+{
+    // Stands in for DBNet: text is wherever the image is bright. Tiles complete in random order
+    private class ThresholdingInferenceEngine : IInferenceEngine
+    {
+        private readonly Random _random = new(0);
+
+        public async Task<(float[] OutputData, int[] OutputShape)> Run(float[] inputData, int[] inputShape)
+        {
+            int delay;
+            lock (_random)
+                delay = _random.Next(20);
+            await Task.Delay(delay);
+
+            var (height, width) = (inputShape[1], inputShape[2]);
+            var output = new float[height * width];
+            for (var i = 0; i < output.Length; i++)
+                output[i] = inputData[i] > 0 ? 1 : 0;  // Red channel, ImageNet normalized
+            return (output, [height, width]);
+        }
+
+        public int CurrentMaxCapacity() => 4;
+
+        public ValueTask DisposeAsync() => ValueTask.CompletedTask;
+    }
+
+    [Theory]
+    [InlineData(DetectionPostprocessing.BoundaryTracing)]
+    [InlineData(DetectionPostprocessing.ConnectedComponents)]
+    [InlineData(DetectionPostprocessing.Native)]
+    public async Task DetectIncrementally_MatchesWholeCompositePostprocess(DetectionPostprocessing postprocessing)
+    {
+        using var image = new Image<Rgb24>(200, 700, Color.Black);
+        image.Mutate(ctx =>
+        {
+            ctx.Fill(Color.White, new RectangleF(10, 10, 80, 20));
+            ctx.Fill(Color.White, new RectangleF(110, 50, 60, 15));  // Straddles the first tile row boundary
+            ctx.Fill(Color.White, new RectangleF(20, 150, 150, 25));
+            ctx.Fill(Color.White, new RectangleF(30, 230, 20, 200));  // Spans several tile rows
+            ctx.Fill(Color.White, new RectangleF(100, 300, 70, 18));
+            ctx.Fill(Color.White, new RectangleF(15, 600, 170, 30));
+            ctx.Fill(Color.White, new RectangleF(60, 660, 50, 20));
+        });
+
+        var options = new DetectionOptions { TileWidth = 64, TileHeight = 64, Postprocessing = postprocessing };
+        var detector = new TextDetector(new ThresholdingInferenceEngine(), options, new TensorPool());
+
+        var tiling = detector.Tile(image);
+        var modelInput = detector.Preprocess(image, tiling, new VizBuilder());
+        var expected = detector.Postprocess(await detector.RunInference(modelInput), tiling, image, new VizBuilder());
+
+        var batches = new List<List<BoundingBox>>();
+        await foreach (var batch in detector.DetectIncrementally(image, new VizBuilder()))
+            batches.Add(batch);
+
+        Assert.Equal(7, expected.Count);
+        Assert.True(batches.Count > 1, $"Expected detections to arrive in several bands, got {batches.Count}");
+        Assert.All(batches, Assert.NotEmpty);
+        Assert.Equal(
+            expected.Select(box => box.AxisAlignedRectangle).OrderBy(r => r.Y).ThenBy(r => r.X),
+            batches.SelectMany(batch => batch).Select(box => box.AxisAlignedRectangle).OrderBy(r => r.Y).ThenBy(r => r.X));
+    }
+}
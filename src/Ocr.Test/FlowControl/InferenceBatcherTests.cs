@@ -0,0 +1,184 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Collections.Concurrent;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+
+namespace SpeedReader.Ocr.Test.FlowControl;
+
+public class InferenceBatcherTests
+{
+    // Doubles every element, mimicking a kernel that maps [n, k] -> [n, k]
+    private static Task<(float[] OutputData, int[] OutputShape)> Double(float[] data, int[] shape) =>
+        Task.FromResult((data.Select(x => x * 2).ToArray(), shape));
+
+    [Fact]
+    public async Task Run_SplitsBatchedOutputsBackToCallers()
+    {
+        await using var batcher = new InferenceBatcher(Double, maxBatchSize: 4, maxBatchWaitMicroseconds: 10_000, maxInFlightBatches: 1);
+
+        var tasks = Enumerable.Range(0, 10)
+            .Select(i => batcher.Run([i, i + 0.5f], [2]))
+            .ToList();
+        var results = await Task.WhenAll(tasks);
+
+        for (var i = 0; i < results.Length; i++)
+        {
+            Assert.Equal(new[] { 2f * i, 2f * i + 1 }, results[i].OutputData);
+            Assert.Equal(new[] { 2 }, results[i].OutputShape);
+        }
+    }
+
+    [Fact]
+    public async Task Run_QueuedRequestsAreCoalesced()
+    {
+        var gate = new TaskCompletionSource();
+        var batchSizes = new ConcurrentQueue<int>();
+
+        await using var batcher = new InferenceBatcher(async (data, shape) =>
+        {
+            batchSizes.Enqueue(shape[0]);
+            await gate.Task;
+            return (data, shape);
+        }, maxBatchSize: 4, maxBatchWaitMicroseconds: 0, maxInFlightBatches: 1);
+
+        // First request occupies the only batch slot, the rest queue up behind it
+        var first = batcher.Run([0], [1]);
+        await Task.Delay(50);
+        var rest = Enumerable.Range(1, 8).Select(i => batcher.Run([i], [1])).ToList();
+
+        gate.SetResult();
+        await Task.WhenAll(rest.Prepend(first));
+
+        Assert.Equal(new[] { 1, 4, 4 }, batchSizes.ToArray());
+    }
+
+    [Fact]
+    public async Task Run_DoesNotMixShapes()
+    {
+        var shapes = new ConcurrentQueue<int[]>();
+        var gate = new TaskCompletionSource();
+
+        await using var batcher = new InferenceBatcher(async (data, shape) =>
+        {
+            shapes.Enqueue(shape);
+            await gate.Task;
+            return (data, shape);
+        }, maxBatchSize: 8, maxBatchWaitMicroseconds: 0, maxInFlightBatches: 1);
+
+        var first = batcher.Run([0], [1]);
+        await Task.Delay(50);
+        var a = batcher.Run([1], [1]);
+        var b = batcher.Run([2], [1]);
+        var c = batcher.Run([3, 3], [2]);
+        var d = batcher.Run([4], [1]);
+
+        gate.SetResult();
+        var results = await Task.WhenAll(first, a, b, c, d);
+
+        Assert.Equal(new[] { new[] { 1, 1 }, new[] { 2, 1 }, new[] { 1, 2 }, new[] { 1, 1 } }, shapes.ToArray());
+        Assert.Equal(new[] { 3f, 3f }, results[3].OutputData);
+        Assert.Equal(new[] { 4f }, results[4].OutputData);
+    }
+
+    [Fact]
+    public async Task Run_BatchFailurePropagatesToEveryRequest()
+    {
+        await using var batcher = new InferenceBatcher((_, _) => throw new TestException(),
+            maxBatchSize: 4, maxBatchWaitMicroseconds: 10_000, maxInFlightBatches: 1);
+
+        var tasks = Enumerable.Range(0, 4).Select(i => batcher.Run([i], [1])).ToList();
+
+        foreach (var task in tasks)
+            await Assert.ThrowsAsync<TestException>(() => task);
+    }
+
+    [Fact]
+    public async Task Run_FailedBatchReturnsItsInputToThePool()
+    {
+        var tensorPool = new TensorPool();
+        await using var batcher = new InferenceBatcher((_, _) => throw new TestException(),
+            maxBatchSize: 4, maxBatchWaitMicroseconds: 0, maxInFlightBatches: 1, tensorPool);
+
+        await Assert.ThrowsAsync<TestException>(() => batcher.Run([1, 2], [2]));
+
+        Assert.Equal(2 * sizeof(float), tensorPool.PooledBytes);
+    }
+
+    [Fact]
+    public async Task Run_PartialBatchIsDispatchedWhenTheWaitExpires()
+    {
+        await using var batcher = new InferenceBatcher(Double, maxBatchSize: 4, maxBatchWaitMicroseconds: 500, maxInFlightBatches: 1);
+
+        // Sub-millisecond waits round up to the timer's resolution, the lone request must not wait for a full batch
+        var result = await batcher.Run([1], [1]).WaitAsync(TimeSpan.FromSeconds(5));
+        var second = await batcher.Run([2], [1]).WaitAsync(TimeSpan.FromSeconds(5));
+
+        Assert.Equal(new[] { 2f }, result.OutputData);
+        Assert.Equal(new[] { 4f }, second.OutputData);
+    }
+
+    [Fact]
+    public async Task MaxInFlightBatches_Raised_DispatchesQueuedBatches()
+    {
+        var gate = new TaskCompletionSource();
+        var started = 0;
+        await using var batcher = new InferenceBatcher(async (data, shape) =>
+        {
+            Interlocked.Increment(ref started);
+            await gate.Task;
+            return (data, shape);
+        }, maxBatchSize: 1, maxBatchWaitMicroseconds: 0, maxInFlightBatches: 1);
+
+        var tasks = Enumerable.Range(0, 3).Select(i => batcher.Run([i], [1])).ToList();
+        await Task.Delay(50);
+        Assert.Equal(1, started);
+
+        batcher.MaxInFlightBatches = 3;
+        await Task.Delay(50);
+        Assert.Equal(3, started);
+
+        gate.SetResult();
+        await Task.WhenAll(tasks);
+    }
+
+    [Fact]
+    public async Task MaxInFlightBatches_Lowered_TakesEffectAsBatchesFinish()
+    {
+        var gate = new SemaphoreSlim(0);
+        var started = 0;
+        await using var batcher = new InferenceBatcher(async (data, shape) =>
+        {
+            Interlocked.Increment(ref started);
+            await gate.WaitAsync();
+            return (data, shape);
+        }, maxBatchSize: 1, maxBatchWaitMicroseconds: 0, maxInFlightBatches: 2);
+
+        var tasks = Enumerable.Range(0, 4).Select(i => batcher.Run([i], [1])).ToList();
+        await Task.Delay(50);
+        Assert.Equal(2, started);
+
+        // The first batch to finish gives up its slot instead of passing it on
+        batcher.MaxInFlightBatches = 1;
+        gate.Release();
+        await Task.Delay(50);
+        Assert.Equal(2, started);
+
+        gate.Release();
+        await Task.Delay(50);
+        Assert.Equal(3, started);
+
+        gate.Release(2);
+        await Task.WhenAll(tasks);
+    }
+
+    [Fact]
+    public async Task Run_AfterDispose_Throws()
+    {
+        var batcher = new InferenceBatcher(Double, maxBatchSize: 4, maxBatchWaitMicroseconds: 0, maxInFlightBatches: 1);
+        await batcher.DisposeAsync();
+
+        Assert.Throws<ObjectDisposedException>(() => batcher.Run([0], [1]));
+    }
+}
@@ -56,7 +56,13 @@ public class MockTextDetector : TextDetector
 
     public MockTextDetector(Func<Task<List<BoundingBox>>> detect, int capacity = 1) : base(new MockInferenceEngine(capacity), new DetectionOptions()) => _detect = detect;
 
-    public override async Task<List<BoundingBox>> Detect(Image<Rgb24> image, VizBuilder vizBuilder) => await _detect();
+    public override async IAsyncEnumerable<List<BoundingBox>> DetectIncrementally(Image<Rgb24> image, VizBuilder vizBuilder)
+    {
+        // Like the real detector, never yields an empty list
+        var boxes = await _detect();
+        if (boxes.Count > 0)
+            yield return boxes;
+    }
 }
 
 
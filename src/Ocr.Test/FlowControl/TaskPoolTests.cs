@@ -0,0 +1,106 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+namespace SpeedReader.Ocr.Test.FlowControl;
+
+public class TaskPoolTests
+{
+    [Fact]
+    public async Task Execute_PoolFull_QueuesUntilSlotFrees()
+    {
+        var pool = new TaskPool<int>(initialPoolSize: 2);
+        var gates = Enumerable.Range(0, 3).Select(_ => new TaskCompletionSource<int>()).ToArray();
+
+        var entered = gates.Select(gate => pool.Execute(() => gate.Task)).ToArray();
+
+        Assert.True(entered[0].IsCompleted);
+        Assert.True(entered[1].IsCompleted);
+        Assert.False(entered[2].IsCompleted);
+        Assert.Equal(2, pool.PoolOccupancy);
+
+        gates[0].SetResult(0);
+        await entered[2].WaitAsync(TimeSpan.FromSeconds(5));
+
+        gates[1].SetResult(1);
+        gates[2].SetResult(2);
+        Assert.Equal(new[] { 0, 1, 2 }, await Task.WhenAll(entered.Select(async task => await await task)));
+    }
+
+    [Fact]
+    public async Task SetPoolSize_Increase_StartsQueuedTasks()
+    {
+        var pool = new TaskPool<int>();
+        var gate = new TaskCompletionSource<int>();
+        _ = await pool.Execute(() => gate.Task);
+
+        var queued = pool.Execute(() => Task.FromResult(1));
+        Assert.False(queued.IsCompleted);
+
+        pool.SetPoolSize(2);
+        Assert.Equal(1, await await queued.WaitAsync(TimeSpan.FromSeconds(5)));
+        gate.SetResult(0);
+    }
+
+    [Fact]
+    public async Task Execute_TaskCreatorThrows_ReturnsFaultedTaskAndFreesSlot()
+    {
+        var pool = new TaskPool<int>();
+
+        var userTask = await pool.Execute(() => throw new InvalidOperationException());
+
+        await Assert.ThrowsAsync<UserTaskCreationException>(() => userTask);
+        Assert.Equal(1, await await pool.Execute(() => Task.FromResult(1)).WaitAsync(TimeSpan.FromSeconds(5)));
+    }
+
+    [Fact]
+    public async Task TryExecute_PoolFull_ReturnsFalseWithoutQueueing()
+    {
+        var pool = new TaskPool<int>();
+        var gate = new TaskCompletionSource<int>();
+
+        Assert.True(pool.TryExecute(() => gate.Task, out var first));
+        Assert.False(pool.TryExecute(() => Task.FromResult(1), out _));
+        Assert.Equal(1, pool.PoolOccupancy);
+
+        gate.SetResult(0);
+        await first;
+        Assert.True(pool.TryExecute(() => Task.FromResult(1), out var second));
+        Assert.Equal(1, await second);
+    }
+
+    [Fact]
+    public async Task Execute_ManyConcurrentCallers_NeverExceedsPoolSize()
+    {
+        const int poolSize = 4;
+        var pool = new TaskPool<int>(poolSize);
+        var running = 0;
+        var maxRunning = 0;
+
+        var callers = Enumerable.Range(0, 2000).Select(i => Task.Run(async () =>
+        {
+            var userTask = await pool.Execute(async () =>
+            {
+                var now = Interlocked.Increment(ref running);
+                InterlockedMax(ref maxRunning, now);
+                await Task.Yield();
+                Interlocked.Decrement(ref running);
+                return i;
+            });
+            return await userTask;
+        }));
+        var results = await Task.WhenAll(callers).WaitAsync(TimeSpan.FromSeconds(30));
+
+        Assert.Equal(Enumerable.Range(0, 2000), results);
+        Assert.InRange(maxRunning, 1, poolSize);
+
+        static void InterlockedMax(ref int target, int value)
+        {
+            while (true)
+            {
+                var current = Volatile.Read(ref target);
+                if (value <= current || Interlocked.CompareExchange(ref target, value, current) == current)
+                    return;
+            }
+        }
+    }
+}
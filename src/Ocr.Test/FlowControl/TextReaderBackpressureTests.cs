@@ -103,4 +103,57 @@ public class TextReaderBackpressureTests
         // Make sure we didn't throw any exceptions
         await task;
     }
+
+    [Fact]
+    public async Task TextReader_ReadMany_MaxPending_CapsUnconsumedResults()
+    {
+        var count = 0;
+        var reader = new OcrPipeline(new MockTextDetector(() =>
+        {
+            Interlocked.Increment(ref count);
+            return MockTextDetector.SimpleResult;
+        }), new MockTextRecognizer());
+
+        var image = new Image<Rgb24>(720, 640, Color.White);
+        var inputs = Enumerable.Range(0, 10).Select(_ => image).ToAsyncEnumerable();
+        await using var results = reader.ReadMany(inputs, new ReadManyOptions { MaxPending = 2 }).GetAsyncEnumerator();
+
+        // Holding on to the first result leaves only one more slot, even though the pool has room
+        Assert.True(await results.MoveNextAsync());
+        await Task.Delay(100);
+        Assert.Equal(2, count);
+
+        // Moving on frees the first slot
+        Assert.True(await results.MoveNextAsync());
+        await Task.Delay(100);
+        Assert.Equal(3, count);
+    }
+
+    [Fact]
+    public async Task TextReader_ReadMany_Unordered_YieldsInCompletionOrder()
+    {
+        var tcs = new TaskCompletionSource();
+        var count = 0;
+        var reader = new OcrPipeline(new MockTextDetector(async () =>
+        {
+            if (Interlocked.Increment(ref count) == 1)
+                await tcs.Task;  // First image is slow
+            return MockTextDetector.SimpleResult;
+        }, capacity: 2), new MockTextRecognizer(Task.CompletedTask, capacity: 2));
+
+        var images = Enumerable.Range(0, 3).Select(i => new Image<Rgb24>(100 + i, 100)).ToList();
+        await using var results = reader.ReadMany(images.ToAsyncEnumerable(), new ReadManyOptions { Ordered = false })
+            .GetAsyncEnumerator();
+
+        // The slow first image doesn't hold back the others
+        Assert.True(await results.MoveNextAsync());
+        Assert.NotEqual(100, results.Current.Value().Image!.Width);
+        Assert.True(await results.MoveNextAsync());
+        Assert.NotEqual(100, results.Current.Value().Image!.Width);
+
+        tcs.SetResult();
+        Assert.True(await results.MoveNextAsync());
+        Assert.Equal(100, results.Current.Value().Image!.Width);
+        Assert.False(await results.MoveNextAsync());
+    }
 }
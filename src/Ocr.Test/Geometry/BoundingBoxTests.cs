@@ -0,0 +1,54 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Ocr.Geometry;
+
+namespace SpeedReader.Ocr.Test.Geometry;
+
+public class BoundingBoxTests
+{
+    private static BoundingBox Box(List<PointF> corners)
+    {
+        var rotatedRectangle = new RotatedRectangle(corners);
+        return new BoundingBox
+        {
+            Polygon = new Polygon(corners),
+            RotatedRectangle = rotatedRectangle,
+            AxisAlignedRectangle = rotatedRectangle.ToAxisAlignedRectangle()
+        };
+    }
+
+    [Fact]
+    public void Scale_UnequalScales_ScalesEachAxisSeparately()
+    {
+        var box = Box([(10, 20), (50, 20), (50, 30), (10, 30)]);
+
+        var scaled = box.Scale(2, 3);
+
+        Assert.Equal(new PointF[] { (20, 60), (100, 60), (100, 90), (20, 90) }, scaled.Polygon.Points.ToArray());
+        Assert.Equal(20, scaled.AxisAlignedRectangle.X, 6);
+        Assert.Equal(60, scaled.AxisAlignedRectangle.Y, 6);
+        Assert.Equal(80, scaled.AxisAlignedRectangle.Width, 6);
+        Assert.Equal(30, scaled.AxisAlignedRectangle.Height, 6);
+        Assert.Equal(80, scaled.RotatedRectangle.Width, 6);
+        Assert.Equal(30, scaled.RotatedRectangle.Height, 6);
+    }
+
+    [Fact]
+    public void Scale_RotatedBox_RefitsRectanglesToScaledPolygon()
+    {
+        // A square rotated 45 degrees becomes a rhombus of area 400 under unequal scales. Its rectangles are refit to
+        // it, rather than scaled along with it
+        var box = Box([(10, 0), (20, 10), (10, 20), (0, 10)]);
+
+        var scaled = box.Scale(2, 1);
+
+        var rectangle = scaled.AxisAlignedRectangle;
+        foreach (var (x, y) in scaled.Polygon.Points)
+        {
+            Assert.InRange(x, rectangle.X - 1e-6, rectangle.X + rectangle.Width + 1e-6);
+            Assert.InRange(y, rectangle.Y - 1e-6, rectangle.Y + rectangle.Height + 1e-6);
+        }
+        Assert.InRange(scaled.RotatedRectangle.Width * scaled.RotatedRectangle.Height, 400 - 1e-6, 800 + 1e-6);
+    }
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+using SixLabors.ImageSharp.Processing;
+using SpeedReader.Ocr.Algorithms;
+using SpeedReader.Ocr.Geometry;
+
+namespace SpeedReader.Ocr.Test.Geometry;
+
+public class RotatedRectangleWarpTests
+{
+    private const int TensorWidth = 160;
+    private const int TensorHeight = 48;
+    private static readonly float[] Means = [127.5f, 127.5f, 127.5f];
+    private static readonly float[] Stds = [127.5f, 127.5f, 127.5f];
+
+    public static TheoryData<double, double, double, double, double> Rectangles => new()
+    {
+        { 10, 10, 160, 48, 0 },  // Same size as the tensor
+        { 5, 20, 150.3, 20.7, 0.1 },  // Wide, upscaled
+        { 30, 5, 60, 40, 0.5 },  // Tall, padded on the right
+        { 0, 0, 390, 30, 0 },  // Downscaled
+        { 390, 290, 40, 40, -0.3 },  // Partially outside the image
+    };
+
+    [Theory]
+    [MemberData(nameof(Rectangles))]
+    public void WarpToNormalizedChwTensor_MatchesCropResizeNormalize(double x, double y, double width, double height, double angle)
+    {
+        using var image = CreateTestImage(400, 300);
+        var rectangle = new RotatedRectangle { X = x, Y = y, Width = width, Height = height, Angle = angle };
+
+        var expected = CropResizeNormalize(rectangle, image);
+        var actual = new float[3 * TensorWidth * TensorHeight];
+        rectangle.WarpToNormalizedChwTensor(image, TensorWidth, TensorHeight, Means, Stds, actual);
+
+        // Bilinear straight from the source vs. bilinear crop followed by a bicubic resize, so only close on average
+        var meanError = expected.Zip(actual, (e, a) => Math.Abs(e - a)).Average();
+        Assert.True(meanError < 0.02, $"Mean error {meanError}");
+    }
+
+    [Fact]
+    public void WarpToNormalizedChwTensor_ImageWiderThan16BitCoordinates_MatchesCropResizeNormalize()
+    {
+        using var image = CreateTestImage(40_000, 60);
+        var rectangle = new RotatedRectangle { X = 39_800, Y = 5, Width = 150, Height = 40, Angle = 0.05 };
+
+        var expected = CropResizeNormalize(rectangle, image);
+        var actual = new float[3 * TensorWidth * TensorHeight];
+        rectangle.WarpToNormalizedChwTensor(image, TensorWidth, TensorHeight, Means, Stds, actual);
+
+        var meanError = expected.Zip(actual, (e, a) => Math.Abs(e - a)).Average();
+        Assert.True(meanError < 0.02, $"Mean error {meanError}");
+    }
+
+    [Fact]
+    public void WarpToNormalizedChwTensor_PadsRightWithNormalizedBlack()
+    {
+        using var image = new Image<Rgb24>(100, 100, new Rgb24(255, 255, 255));
+        var rectangle = new RotatedRectangle { X = 10, Y = 10, Width = 48, Height = 48, Angle = 0 };
+
+        var actual = new float[3 * TensorWidth * TensorHeight];
+        rectangle.WarpToNormalizedChwTensor(image, TensorWidth, TensorHeight, Means, Stds, actual);
+
+        for (var c = 0; c < 3; c++)
+        {
+            for (var row = 0; row < TensorHeight; row++)
+            {
+                for (var col = 0; col < TensorWidth; col++)
+                {
+                    var value = actual[c * TensorWidth * TensorHeight + row * TensorWidth + col];
+                    Assert.Equal(col < 48 ? 1f : -1f, value, 1e-5f);
+                }
+            }
+        }
+    }
+
+    [Fact]
+    public void WarpToNormalizedChwTensor_WrongResultLength_Throws()
+    {
+        using var image = new Image<Rgb24>(10, 10);
+        var rectangle = new RotatedRectangle { X = 0, Y = 0, Width = 5, Height = 5, Angle = 0 };
+
+        Assert.Throws<ArgumentException>(() =>
+            rectangle.WarpToNormalizedChwTensor(image, TensorWidth, TensorHeight, Means, Stds, new float[10]));
+    }
+
+    private static float[] CropResizeNormalize(RotatedRectangle rectangle, Image<Rgb24> image)
+    {
+        using var crop = rectangle.Crop(image);
+        crop.Mutate(x => x.Resize(new ResizeOptions
+        {
+            Size = new Size(TensorWidth, TensorHeight),
+            Mode = ResizeMode.Pad,
+            Position = AnchorPositionMode.TopLeft
+        }));
+        var result = new float[3 * TensorWidth * TensorHeight];
+        crop.ToNormalizedChwTensor(new Rectangle(0, 0, TensorWidth, TensorHeight), Means, Stds, result);
+        return result;
+    }
+
+    // Smooth gradients, so results don't hinge on the choice of interpolation
+    private static Image<Rgb24> CreateTestImage(int width, int height)
+    {
+        var image = new Image<Rgb24>(width, height);
+        image.ProcessPixelRows(accessor =>
+        {
+            for (var y = 0; y < height; y++)
+            {
+                var row = accessor.GetRowSpan(y);
+                for (var x = 0; x < width; x++)
+                {
+                    row[x] = new Rgb24(
+                        (byte)(128 + 100 * Math.Sin(x * 0.05)),
+                        (byte)(128 + 100 * Math.Cos(y * 0.04)),
+                        (byte)((x + y) * 255 / (width + height)));
+                }
+            }
+        });
+        return image;
+    }
+}
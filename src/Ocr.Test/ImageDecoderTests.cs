@@ -0,0 +1,45 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+
+namespace SpeedReader.Ocr.Test;
+
+public class ImageDecoderTests
+{
+    private static byte[] EncodeJpeg(int width, int height)
+    {
+        using var image = new Image<Rgb24>(width, height, Color.White);
+        using var stream = new MemoryStream();
+        image.SaveAsJpeg(stream);
+        return stream.ToArray();
+    }
+
+    [Fact]
+    public void DetectionSize_NoHint_ReturnsNull() =>
+        Assert.Null(new ImageDecoder(new DecodeOptions()).DetectionSize(EncodeJpeg(4000, 3000)));
+
+    [Fact]
+    public void DetectionSize_SmallerThanHint_ReturnsNull() =>
+        Assert.Null(new ImageDecoder(new DecodeOptions { MaxDetectionDimension = 2000 })
+            .DetectionSize(EncodeJpeg(1600, 1200)));
+
+    [Fact]
+    public void DetectionSize_LargerThanHint_ScalesLongSideDown() =>
+        Assert.Equal(new Size(1000, 750), new ImageDecoder(new DecodeOptions { MaxDetectionDimension = 1000 })
+            .DetectionSize(EncodeJpeg(4000, 3000)));
+
+    [Fact]
+    public async Task Decode_TargetSize_DecodesAtReducedResolution()
+    {
+        var decoder = new ImageDecoder(new DecodeOptions { MaxDetectionDimension = 1000 });
+        var encoded = EncodeJpeg(4000, 3000);
+
+        using var reduced = await decoder.Decode(encoded, decoder.DetectionSize(encoded));
+        using var full = await decoder.Decode(encoded);
+
+        Assert.Equal(new Size(1000, 750), reduced.Size);
+        Assert.Equal(new Size(4000, 3000), full.Size);
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Ocr.InferenceEngine;
+
+namespace SpeedReader.Ocr.Test.InferenceEngine;
+
+public class InferenceWireTests
+{
+    private readonly TensorPool _tensorPool = new();
+
+    [Fact]
+    public void Request_RoundTrips()
+    {
+        var data = Enumerable.Range(0, 2 * 3 * 4).Select(i => i * 0.5f).ToArray();
+
+        var frame = InferenceWire.EncodeRequest(Model.Svtr, data, [2, 3, 4]);
+        var (model, decoded, shape) = InferenceWire.DecodeRequest(frame, _tensorPool);
+
+        Assert.Equal(Model.Svtr, model);
+        Assert.Equal(new[] { 2, 3, 4 }, shape);
+        Assert.Equal(data, decoded);
+    }
+
+    [Fact]
+    public void Response_RoundTripsItemsAsOneBatch()
+    {
+        float[][] items = [[1, 2, 3], [4, 5, 6]];
+
+        var frame = InferenceWire.EncodeResponse(items, [3], new WorkerLoad(QueueDepth: 7, Capacity: 16));
+        var (data, shape, load) = InferenceWire.DecodeResponse(frame, _tensorPool);
+
+        Assert.Equal(new[] { 2, 3 }, shape);
+        Assert.Equal(new float[] { 1, 2, 3, 4, 5, 6 }, data);
+        Assert.Equal(new WorkerLoad(7, 16), load);
+    }
+
+    [Fact]
+    public void DecodeResponse_Error_ThrowsWithMessage()
+    {
+        var frame = InferenceWire.EncodeError("Svtr is not served here");
+
+        var exception = Assert.Throws<RemoteInferenceException>(() => InferenceWire.DecodeResponse(frame, _tensorPool));
+
+        Assert.Equal("Svtr is not served here", exception.Message);
+    }
+
+    [Fact]
+    public void DecodeRequest_TruncatedData_Throws()
+    {
+        var frame = InferenceWire.EncodeRequest(Model.DbNet, new float[12], [1, 3, 4]);
+
+        Assert.Throws<InvalidDataException>(() => InferenceWire.DecodeRequest(frame.AsSpan(..^1), _tensorPool));
+    }
+
+    [Fact]
+    public void DecodeRequest_UnknownModel_Throws()
+    {
+        var frame = InferenceWire.EncodeRequest(Model.DbNet, new float[1], [1]);
+        frame[1] = 99;
+
+        Assert.Throws<InvalidDataException>(() => InferenceWire.DecodeRequest(frame, _tensorPool));
+    }
+}
@@ -0,0 +1,178 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Collections.Concurrent;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+
+namespace SpeedReader.Ocr.Test.InferenceEngine;
+
+public class OcrThreadPoolTests
+{
+    // Runners are told apart by thread rather than core, so everything can pin to core 0
+    private static OcrThreadPool CreatePool(int pCores, int eCores, int dbnetWorkers) => new(
+        new Topology { PCores = new int[pCores], ECores = new int[eCores] }, dbnetWorkers);
+
+    // Runners are never started, so FindJob only runs when a test calls RunNext. Indexed DBNet P-cores, SVTR P-cores,
+    // then E-cores
+    private static OcrThreadPool CreateIdlePool(int pCores, int eCores, int dbnetWorkers) => new(
+        new Topology { PCores = new int[pCores], ECores = new int[eCores] }, dbnetWorkers, null, null, null,
+        startRunners: false);
+
+    private static Func<int> Job(ConcurrentDictionary<int, int> threads, int milliseconds = 5) => () =>
+    {
+        threads.AddOrUpdate(Environment.CurrentManagedThreadId, 1, (_, n) => n + 1);
+        Thread.Sleep(milliseconds);
+        return Environment.CurrentManagedThreadId;
+    };
+
+    [Fact]
+    public async Task RunSvtr_Burst_SpreadsAcrossIdleRunners()
+    {
+        using var pool = CreatePool(pCores: 2, eCores: 2, dbnetWorkers: 1);
+        var threads = new ConcurrentDictionary<int, int>();
+
+        await Task.WhenAll(Enumerable.Range(0, 64).Select(_ => pool.RunSvtr(Job(threads))));
+
+        Assert.Equal(4, threads.Count);  // Idle DBNet runner helps too
+        Assert.Equal(64, threads.Values.Sum());
+    }
+
+    [Fact]
+    public async Task RunDbNet_StaysOnDbNetRunners()
+    {
+        using var pool = CreatePool(pCores: 3, eCores: 2, dbnetWorkers: 1);
+        var dbnetThreads = new ConcurrentDictionary<int, int>();
+        var svtrThreads = new ConcurrentDictionary<int, int>();
+
+        var svtr = Enumerable.Range(0, 32).Select(_ => pool.RunSvtr(Job(svtrThreads)));
+        var dbnet = Enumerable.Range(0, 32).Select(_ => pool.RunDbNet(Job(dbnetThreads)));
+        await Task.WhenAll(svtr.Concat(dbnet));
+
+        Assert.Single(dbnetThreads);
+        Assert.Equal(32, dbnetThreads.Values.Sum());
+    }
+
+    [Fact]
+    public async Task Rebalance_MovesRunnerBetweenClasses()
+    {
+        using var pool = CreatePool(pCores: 3, eCores: 0, dbnetWorkers: 1);
+        var threads = new ConcurrentDictionary<int, int>();
+
+        Assert.True(pool.RebalanceSvtr2DbNet());
+        Assert.Equal(2, pool.DbNetPowerWorkers);
+        Assert.Equal(1, pool.SvtrPowerWorkers);
+
+        await Task.WhenAll(Enumerable.Range(0, 32).Select(_ => pool.RunDbNet(Job(threads))));
+        Assert.Equal(2, threads.Count);
+
+        Assert.True(pool.RebalanceDbNet2Svtr());
+        Assert.True(pool.RebalanceDbNet2Svtr());
+        Assert.False(pool.RebalanceDbNet2Svtr());
+        Assert.Equal(3, pool.SvtrPowerWorkers);
+    }
+
+    [Fact]
+    public async Task Run_JobThrows_FaultsTask()
+    {
+        using var pool = CreatePool(pCores: 1, eCores: 0, dbnetWorkers: 1);
+
+        await Assert.ThrowsAsync<InvalidOperationException>(() =>
+            pool.RunSvtr<int>(() => throw new InvalidOperationException()));
+        Assert.Equal(1, await pool.RunDbNet(() => 1));
+    }
+
+    [Fact]
+    public async Task Dispose_FinishesQueuedJobsThenRejectsNewOnes()
+    {
+        var pool = CreatePool(pCores: 1, eCores: 1, dbnetWorkers: 1);
+        var threads = new ConcurrentDictionary<int, int>();
+        var jobs = Enumerable.Range(0, 16).Select(_ => pool.RunSvtr(Job(threads, milliseconds: 1))).ToList();
+
+        pool.Dispose();
+
+        await Task.WhenAll(jobs);
+        Assert.Throws<ObjectDisposedException>(() => pool.RunSvtr(() => 0));
+    }
+
+    [Fact]
+    public void FindJob_SvtrPowerRunner_StealsFromOwnClassThenECoresThenDbNetCores()
+    {
+        using var pool = CreateIdlePool(pCores: 3, eCores: 1, dbnetWorkers: 1);  // DBNet 0, SVTR 1-2, E-core 3
+        var order = new List<string>();
+        pool.Enqueue(0, Model.Svtr, () => { order.Add("dbnet core"); return 0; });
+        pool.Enqueue(3, Model.Svtr, () => { order.Add("e-core"); return 0; });
+        pool.Enqueue(2, Model.Svtr, () => { order.Add("same class"); return 0; });
+        pool.Enqueue(1, Model.Svtr, () => { order.Add("own"); return 0; });
+
+        while (pool.RunNext(1)) { }
+
+        Assert.Equal(new[] { "own", "same class", "e-core", "dbnet core" }, order);
+    }
+
+    [Fact]
+    public void FindJob_EfficiencyRunner_StealsFromOwnClassThenSvtrCoresThenDbNetCores()
+    {
+        using var pool = CreateIdlePool(pCores: 2, eCores: 2, dbnetWorkers: 1);  // DBNet 0, SVTR 1, E-cores 2-3
+        var order = new List<string>();
+        pool.Enqueue(0, Model.Svtr, () => { order.Add("dbnet core"); return 0; });
+        pool.Enqueue(1, Model.Svtr, () => { order.Add("svtr core"); return 0; });
+        pool.Enqueue(3, Model.Svtr, () => { order.Add("same class"); return 0; });
+        pool.Enqueue(2, Model.Svtr, () => { order.Add("own"); return 0; });
+
+        while (pool.RunNext(2)) { }
+
+        Assert.Equal(new[] { "own", "same class", "svtr core", "dbnet core" }, order);
+    }
+
+    [Fact]
+    public void FindJob_DbNetRunner_RunsDbNetWorkBeforeSvtrAndECoresBeforeSvtrCores()
+    {
+        using var pool = CreateIdlePool(pCores: 3, eCores: 1, dbnetWorkers: 2);  // DBNet 0-1, SVTR 2, E-core 3
+        var order = new List<string>();
+        pool.Enqueue(2, Model.Svtr, () => { order.Add("svtr core"); return 0; });
+        pool.Enqueue(3, Model.Svtr, () => { order.Add("e-core"); return 0; });
+        pool.Enqueue(0, Model.Svtr, () => { order.Add("own svtr"); return 0; });
+        pool.Enqueue(1, Model.DbNet, () => { order.Add("stolen dbnet"); return 0; });
+        pool.Enqueue(0, Model.DbNet, () => { order.Add("own dbnet"); return 0; });
+
+        while (pool.RunNext(0)) { }
+
+        Assert.Equal(new[] { "own dbnet", "stolen dbnet", "own svtr", "e-core", "svtr core" }, order);
+    }
+
+    [Fact]
+    public void FindJob_DbNetJobs_AreNeverStolenOffDbNetCores()
+    {
+        using var pool = CreateIdlePool(pCores: 2, eCores: 1, dbnetWorkers: 1);  // DBNet 0, SVTR 1, E-core 2
+        var job = pool.Enqueue(0, Model.DbNet, () => 0);
+
+        Assert.False(pool.RunNext(1));
+        Assert.False(pool.RunNext(2));
+        Assert.True(pool.RunNext(0));
+        Assert.True(job.IsCompletedSuccessfully);
+    }
+
+    [Fact]
+    public async Task RunSvtr_RunnerClaimedWhileFinishingLateJob_RunsClaimedJob()
+    {
+        using var pool = CreatePool(pCores: 1, eCores: 0, dbnetWorkers: 0);
+        var late = new TaskCompletionSource<Task<int>>();
+        var claimed = new TaskCompletionSource<Task<int>>();
+        var fired = 0;
+
+        // After its first job the only runner publishes that it's idle. Before its recheck, a late job lands on its
+        // queue without claiming it, and a submitter claims it and queues another job behind the late one
+        pool.OnIdlePublished = () =>
+        {
+            if (Interlocked.Exchange(ref fired, 1) == 1)
+                return;
+            late.SetResult(pool.Enqueue(0, Model.Svtr, () => 1));
+            claimed.SetResult(pool.RunSvtr(() => 2));
+        };
+
+        Assert.Equal(0, await pool.RunSvtr(() => 0));
+        Assert.Equal(1, await await late.Task);
+        Assert.Equal(2, await (await claimed.Task).WaitAsync(TimeSpan.FromSeconds(5)));
+    }
+}
@@ -0,0 +1,238 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Collections.Concurrent;
+using System.Net.Http.Headers;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+
+namespace SpeedReader.Ocr.Test.InferenceEngine;
+
+public class RemoteEngineTests
+{
+    private static readonly Uri WorkerA = new("http://worker-a");
+    private static readonly Uri WorkerB = new("http://worker-b");
+
+    [Fact]
+    public async Task Run_ReturnsWorkerOutput()
+    {
+        var workers = new FakeWorkers();
+        await using var engine = CreateEngine(workers, WorkerA);
+
+        var (output, shape) = await engine.Run([1, 2, 3], [3]);
+
+        Assert.Equal(new float[] { 2, 4, 6 }, output);  // Fake workers double their input
+        Assert.Equal(new[] { 3 }, shape);
+    }
+
+    [Fact]
+    public async Task Run_BatchesConcurrentRequests()
+    {
+        var workers = new FakeWorkers();
+        await using var engine = CreateEngine(workers, [WorkerA], maxBatchSize: 4, maxBatchWaitMicroseconds: 50_000);
+
+        var results = await Task.WhenAll(Enumerable.Range(0, 4).Select(i => engine.Run([i, i], [2])));
+
+        Assert.True(workers.Requests.Count < 4);
+        for (var i = 0; i < 4; i++)
+            Assert.Equal(new[] { 2f * i, 2f * i }, results[i].OutputData);
+    }
+
+    [Fact]
+    public async Task Run_PrefersWorkerReportingShorterQueue()
+    {
+        var workers = new FakeWorkers();
+        workers.QueueDepths[WorkerA.Host] = 100;
+        await using var engine = CreateEngine(workers, WorkerA, WorkerB);
+
+        // Both are idle until they've answered once, after that A's reported queue keeps requests on B
+        await engine.Run([1], [1]);
+        await engine.Run([1], [1]);
+        workers.Requests.Clear();
+        for (var i = 0; i < 8; i++)
+            await engine.Run([1], [1]);
+
+        Assert.All(workers.Requests, host => Assert.Equal(WorkerB.Host, host));
+    }
+
+    [Fact]
+    public async Task Run_UnreachableWorker_FailsOverToNext()
+    {
+        var workers = new FakeWorkers();
+        workers.Down.Add(WorkerA.Host);
+        await using var engine = CreateEngine(workers, WorkerA, WorkerB);
+
+        for (var i = 0; i < 4; i++)
+        {
+            var (output, _) = await engine.Run([1], [1]);
+            Assert.Equal(new[] { 2f }, output);
+        }
+    }
+
+    [Fact]
+    public async Task Run_HungWorker_TimesOutAndFailsOverToNext()
+    {
+        var workers = new FakeWorkers();
+        workers.Hung.Add(WorkerA.Host);
+        await using var engine = new RemoteEngine(new RemoteEngineConfig
+        {
+            Workers = [WorkerA, WorkerB],
+            MaxBatchSize = 1,
+            RequestTimeoutMilliseconds = 100
+        }, Model.Svtr, handler: workers);
+
+        for (var i = 0; i < 4; i++)
+        {
+            var (output, _) = await engine.Run([1], [1]).WaitAsync(TimeSpan.FromSeconds(5));
+            Assert.Equal(new[] { 2f }, output);
+        }
+    }
+
+    [Fact]
+    public async Task Run_AllWorkersUnreachable_Throws()
+    {
+        var workers = new FakeWorkers();
+        workers.Down.Add(WorkerA.Host);
+        await using var engine = CreateEngine(workers, WorkerA);
+
+        await Assert.ThrowsAsync<HttpRequestException>(() => engine.Run([1], [1]));
+    }
+
+    [Fact]
+    public async Task Run_WorkerError_ThrowsRemoteInferenceException()
+    {
+        var workers = new FakeWorkers { Error = "Svtr is not served here" };
+        await using var engine = CreateEngine(workers, WorkerA, WorkerB);
+
+        var exception = await Assert.ThrowsAsync<RemoteInferenceException>(() => engine.Run([1], [1]));
+        Assert.Equal("Svtr is not served here", exception.Message);
+        Assert.Single(workers.Requests);  // The worker was reached, so another one wouldn't do better
+    }
+
+    [Fact]
+    public async Task CurrentMaxCapacity_SumsReportedCapacities()
+    {
+        var workers = new FakeWorkers();
+        await using var engine = CreateEngine(workers, WorkerA, WorkerB);
+        Assert.Equal(2 * 8, engine.CurrentMaxCapacity());  // Assumed until reported
+
+        workers.Capacity = 3;
+        await engine.Run([1], [1]);
+        await engine.Run([1], [1]);
+
+        Assert.Equal(2 * 3, engine.CurrentMaxCapacity());
+    }
+
+    [Fact]
+    public async Task Run_ReportedCapacity_LimitsBatchesInFlight()
+    {
+        var workers = new FakeWorkers { Capacity = 1 };
+        await using var engine = CreateEngine(workers, [WorkerA], maxBatchSize: 2, maxBatchWaitMicroseconds: 0);
+        await engine.Run([1], [1]);  // Learns the capacity
+
+        workers.Gate = new TaskCompletionSource();
+        var runs = Enumerable.Range(0, 6).Select(i => engine.Run([i], [1])).ToList();
+        await Task.Delay(100);
+        workers.Gate.SetResult();
+        await Task.WhenAll(runs);
+
+        Assert.Equal(1, workers.MaxConcurrent);  // Not the 8 assumed at construction
+    }
+
+    [Fact]
+    public void Config_MaxBatchSizeOverWorkerLimit_Throws()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => new RemoteEngineConfig
+        {
+            Workers = [WorkerA],
+            MaxBatchSize = RemoteEngineConfig.MaxWorkerBatchSize + 1
+        });
+    }
+
+    private static RemoteEngine CreateEngine(FakeWorkers workers, params Uri[] addresses) =>
+        CreateEngine(workers, addresses, maxBatchSize: 1, maxBatchWaitMicroseconds: 0);
+
+    private static RemoteEngine CreateEngine(FakeWorkers workers, Uri[] addresses, int maxBatchSize,
+        int maxBatchWaitMicroseconds) =>
+        new(new RemoteEngineConfig
+        {
+            Workers = addresses,
+            MaxBatchSize = maxBatchSize,
+            MaxBatchWaitMicroseconds = maxBatchWaitMicroseconds,
+            WorkerCapacity = 8
+        }, Model.Svtr, handler: workers);
+
+    // Answers like Inference.PostInfer would, doubling every input
+    private sealed class FakeWorkers : HttpMessageHandler
+    {
+        private readonly TensorPool _tensorPool = new();
+
+        public ConcurrentQueue<string> Requests { get; } = new();
+        public ConcurrentDictionary<string, int> QueueDepths { get; } = new();
+        public HashSet<string> Down { get; } = [];
+        public HashSet<string> Hung { get; } = [];  // Accept requests and never answer
+        public int Capacity { get; set; } = 8;
+        public string? Error { get; init; }
+        public TaskCompletionSource? Gate { get; set; }  // Holds requests until set
+        public int MaxConcurrent => _maxConcurrent;
+
+        private int _concurrent;
+        private int _maxConcurrent;
+
+        protected override async Task<HttpResponseMessage> SendAsync(HttpRequestMessage request,
+            CancellationToken cancellationToken)
+        {
+            var host = request.RequestUri!.Host;
+            if (Down.Contains(host))
+                throw new HttpRequestException($"Connection refused ({host})");
+            Requests.Enqueue(host);
+            if (Hung.Contains(host))
+                await Task.Delay(Timeout.Infinite, cancellationToken);
+
+            var concurrent = Interlocked.Increment(ref _concurrent);
+            try
+            {
+                InterlockedMax(ref _maxConcurrent, concurrent);
+                if (Gate is { } gate)
+                    await gate.Task;
+            }
+            finally
+            {
+                Interlocked.Decrement(ref _concurrent);
+            }
+
+            byte[] frame;
+            if (Error != null)
+            {
+                frame = InferenceWire.EncodeError(Error);
+            }
+            else
+            {
+                var body = await request.Content!.ReadAsByteArrayAsync(cancellationToken);
+                var (_, data, shape) = InferenceWire.DecodeRequest(body, _tensorPool);
+                var itemLength = data.Length / shape[0];
+                var items = Enumerable.Range(0, shape[0])
+                    .Select(i => data.AsSpan(i * itemLength, itemLength).ToArray().Select(x => 2 * x).ToArray())
+                    .ToList();
+                frame = InferenceWire.EncodeResponse(items, shape[1..],
+                    new WorkerLoad(QueueDepths.GetValueOrDefault(host), Capacity));
+            }
+
+            var content = new ByteArrayContent(frame);
+            content.Headers.ContentType = new MediaTypeHeaderValue(InferenceWire.MediaType);
+            return new HttpResponseMessage { Content = content };
+        }
+
+        private static void InterlockedMax(ref int target, int value)
+        {
+            var current = Volatile.Read(ref target);
+            while (value > current)
+            {
+                var seen = Interlocked.CompareExchange(ref target, value, current);
+                if (seen == current)
+                    return;
+                current = seen;
+            }
+        }
+    }
+}
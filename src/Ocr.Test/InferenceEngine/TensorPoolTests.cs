@@ -0,0 +1,97 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Ocr.InferenceEngine;
+
+namespace SpeedReader.Ocr.Test.InferenceEngine;
+
+public class TensorPoolTests
+{
+    [Fact]
+    public void Rent_ReturnsExactLength()
+    {
+        var pool = new TensorPool();
+        Assert.Equal(17, pool.Rent(17).Length);
+        Assert.Equal(3 * 48 * 160, pool.Rent([3, 48, 160]).Length);
+    }
+
+    [Fact]
+    public void Rent_AfterReturn_ReusesBuffer()
+    {
+        var pool = new TensorPool();
+        var buffer = pool.Rent(100);
+        pool.Return(buffer);
+
+        Assert.Same(buffer, pool.Rent(100));
+        Assert.NotSame(buffer, pool.Rent(100));
+    }
+
+    [Fact]
+    public void Rent_IsKeyedByLength()
+    {
+        var pool = new TensorPool();
+        var buffer = pool.Rent(100);
+        pool.Return(buffer);
+
+        Assert.NotSame(buffer, pool.Rent(101));
+        Assert.Same(buffer, pool.Rent(100));
+    }
+
+    [Fact]
+    public void Return_BeyondCapacity_DropsBuffers()
+    {
+        var pool = new TensorPool(maxBuffersPerLength: 2);
+        var buffers = Enumerable.Range(0, 3).Select(_ => pool.Rent(10)).ToList();
+        pool.Return(buffers);
+
+        var rented = Enumerable.Range(0, 3).Select(_ => pool.Rent(10)).ToList();
+        Assert.Equal(2, rented.Count(r => buffers.Contains(r)));
+    }
+
+    [Fact]
+    public void Rent_Zero_ReturnsEmpty()
+    {
+        var pool = new TensorPool();
+        Assert.Empty(pool.Rent(0));
+        pool.Return(Array.Empty<float>());
+    }
+
+    [Fact]
+    public void Return_BeyondByteBudget_EvictsLeastRecentlyRentedLength()
+    {
+        var pool = new TensorPool(maxPooledBytes: 2 * 100 * sizeof(float));
+        var stale = pool.Rent(100);
+        var hot = pool.Rent(101);
+        pool.Return(stale);
+        pool.Return(hot);  // Over budget, evicts the stale length
+
+        Assert.Equal(101 * sizeof(float), pool.PooledBytes);
+        Assert.NotSame(stale, pool.Rent(100));
+        Assert.Same(hot, pool.Rent(101));
+    }
+
+    [Fact]
+    public void Return_BeyondByteBudget_KeepsMoreRecentlyRentedLengths()
+    {
+        var pool = new TensorPool(maxPooledBytes: 2 * 100 * sizeof(float));
+        var stale = pool.Rent(101);
+        var hot = pool.Rent(100);
+        pool.Return(hot);
+        pool.Return(stale);  // Would evict a length in more recent use, so it is dropped instead
+
+        Assert.Equal(100 * sizeof(float), pool.PooledBytes);
+        Assert.Same(hot, pool.Rent(100));
+        Assert.NotSame(stale, pool.Rent(101));
+    }
+
+    [Fact]
+    public void Return_LargerThanByteBudget_DropsBuffer()
+    {
+        var pool = new TensorPool(maxPooledBytes: 10 * sizeof(float));
+        var buffer = pool.Rent(11);
+        pool.Return(buffer);
+
+        Assert.Equal(0, pool.PooledBytes);
+        Assert.NotSame(buffer, pool.Rent(11));
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Native.Threading;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+
+namespace SpeedReader.Ocr.Test.InferenceEngine;
+
+public class TopologyTests
+{
+    private static readonly OnnxInferenceKernelOptions Kernel = new(Model.Svtr, Quantization.Fp32, numIntraOpThreads: 1);
+
+    // Cores 0-3 are hyperthreaded P-cores (0/1, 2/3, ...), 8-11 are E-cores
+    private static CpuTopology Hybrid(double? quota = null) => new(
+        Enumerable.Range(0, 8).Select(id => new LogicalCpu { Id = id, Core = id & ~1, NumaNode = 0, Kind = CoreKind.Performance })
+            .Concat(Enumerable.Range(8, 4).Select(id => new LogicalCpu { Id = id, Core = id, NumaNode = 0, Kind = CoreKind.Efficiency })),
+        quota);
+
+    [Fact]
+    public void Resolve_EmptyConfig_UsesDiscoveredCores()
+    {
+        var topology = Topology.Resolve(new CpuEngineConfig { Kernel = Kernel }, Hybrid());
+
+        Assert.Equal(new[] { 0, 2, 4, 6 }, topology.PCores);
+        Assert.Equal(new[] { 8, 9, 10, 11 }, topology.ECores);
+    }
+
+    [Fact]
+    public void Resolve_ConfiguredCores_DropsCoresThatDontExist()
+    {
+        var config = new CpuEngineConfig { Kernel = Kernel, ReservedPCores = [0, 2], UnreservedPCores = [4, 40], ECores = [9, 99] };
+
+        var topology = Topology.Resolve(config, Hybrid());
+
+        Assert.Equal(new[] { 0, 2, 4 }, topology.PCores);
+        Assert.Equal(new[] { 9 }, topology.ECores);
+    }
+
+    [Fact]
+    public void Resolve_NoConfiguredCoreExists_FallsBackToDiscovered()
+    {
+        var config = new CpuEngineConfig { Kernel = Kernel, ReservedPCores = [64, 66] };
+
+        var topology = Topology.Resolve(config, Hybrid());
+
+        Assert.Equal(new[] { 0, 2, 4, 6 }, topology.PCores);
+    }
+
+    [Fact]
+    public void Resolve_Quota_LimitsRunnersPreferringPCores()
+    {
+        var topology = Topology.Resolve(new CpuEngineConfig { Kernel = Kernel }, Hybrid(quota: 5.5));
+
+        Assert.Equal(new[] { 0, 2, 4, 6 }, topology.PCores);
+        Assert.Equal(new[] { 8, 9 }, topology.ECores);
+    }
+
+    [Fact]
+    public void Resolve_OnlyEfficiencyCores_RunsDbNetOnThem()
+    {
+        var cpus = Enumerable.Range(0, 4).Select(id => new LogicalCpu { Id = id, Core = id, NumaNode = 0, Kind = CoreKind.Efficiency });
+
+        var topology = Topology.Resolve(new CpuEngineConfig { Kernel = Kernel }, new CpuTopology(cpus));
+
+        Assert.Equal(new[] { 0, 1, 2, 3 }, topology.PCores);
+        Assert.Empty(topology.ECores);
+    }
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Diagnostics;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+
+namespace SpeedReader.Ocr.Test.InferenceEngine;
+
+public class WorkerRebalancerTests
+{
+    private static readonly RebalancingOptions Options = new() { WaitThresholdMilliseconds = 20, Hysteresis = 2 };
+    private static readonly QueueSample Idle = new(0, 0);
+
+    [Fact]
+    public void Decide_SvtrBackedUp_MovesDbNetCoreToSvtr() =>
+        Assert.Equal(RebalanceDecision.DbNetToSvtr, WorkerRebalancer.Decide(Idle, new QueueSample(12, 80), 4, 4, Options));
+
+    [Fact]
+    public void Decide_DbNetBackedUp_MovesSvtrCoreToDbNet() =>
+        Assert.Equal(RebalanceDecision.SvtrToDbNet, WorkerRebalancer.Decide(new QueueSample(3, 150), Idle, 4, 4, Options));
+
+    [Fact]
+    public void Decide_BothBackedUpEvenly_Holds() =>
+        Assert.Equal(RebalanceDecision.Hold,
+            WorkerRebalancer.Decide(new QueueSample(6, 60), new QueueSample(5, 90), 4, 4, Options));
+
+    [Fact]
+    public void Decide_WaitBelowThreshold_Holds() =>
+        Assert.Equal(RebalanceDecision.Hold, WorkerRebalancer.Decide(Idle, new QueueSample(12, 10), 4, 4, Options));
+
+    [Fact]
+    public void Decide_NothingQueued_Holds() =>
+        Assert.Equal(RebalanceDecision.Hold, WorkerRebalancer.Decide(Idle, new QueueSample(0.5, 80), 4, 4, Options));
+
+    [Fact]
+    public void Decide_DbNetAtMinimum_Holds() =>
+        Assert.Equal(RebalanceDecision.Hold, WorkerRebalancer.Decide(Idle, new QueueSample(12, 80), 1, 7, Options));
+
+    [Fact]
+    public void Decide_NoSvtrPowerWorkers_Holds() =>
+        Assert.Equal(RebalanceDecision.Hold, WorkerRebalancer.Decide(new QueueSample(3, 150), Idle, 8, 0, Options));
+
+    [Fact]
+    public async Task ThreadPool_SvtrOnlyLoad_MovesPCoresToSvtr()
+    {
+        var topology = new Topology { PCores = [0, 0, 0, 0], ECores = [] };
+        var options = new RebalancingOptions
+        {
+            IntervalMilliseconds = 10,
+            WaitThresholdMilliseconds = 1,
+            CooldownIntervals = 0
+        };
+        using var pool = new OcrThreadPool(topology, startingDbNetWorkers: 3, options);
+
+        var stopwatch = Stopwatch.StartNew();
+        while (pool.DbNetPowerWorkers > options.MinDbNetWorkers && stopwatch.Elapsed < TimeSpan.FromSeconds(10))
+        {
+            var jobs = Enumerable.Range(0, 32).Select(_ => pool.RunSvtr(() =>
+            {
+                Thread.Sleep(2);
+                return 0;
+            }));
+            await Task.WhenAll(jobs);
+        }
+
+        Assert.Equal(options.MinDbNetWorkers, pool.DbNetPowerWorkers);
+        Assert.Equal(3, pool.SvtrPowerWorkers);
+    }
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SpeedReader.Ocr.Geometry;
+using SpeedReader.Ocr.Test.FlowControl;
+using SpeedReader.Resources.CharDict;
+
+namespace SpeedReader.Ocr.Test;
+
+public class RecognitionBucketTests
+{
+    private static readonly TextRecognizer Recognizer = new(new MockInferenceEngine(), new EmbeddedCharDict(),
+        new RecognitionOptions { RecognitionInputWidths = [320, 80, 160], RecognitionInputHeight = 48 });
+
+    private static RotatedRectangle Region(double width, double height) =>
+        new() { X = 0, Y = 0, Width = width, Height = height, Angle = 0 };
+
+    [Theory]
+    [InlineData(30, 24, 80)]  // Short word, padded to the narrowest bucket
+    [InlineData(40, 24, 80)]  // Exactly fills a bucket
+    [InlineData(41, 24, 160)]
+    [InlineData(150, 24, 320)]
+    [InlineData(1000, 24, 320)]  // Too long for any bucket, squashed into the widest
+    public void InputWidth_PicksNarrowestBucketThatFits(double width, double height, int expected) =>
+        Assert.Equal(expected, Recognizer.InputWidth(Region(width, height)));
+
+    [Fact]
+    public void RecognitionInputWidths_NotMultipleOf8_Throws() =>
+        Assert.Throws<ArgumentOutOfRangeException>(() => new RecognitionOptions { RecognitionInputWidths = [100] });
+}
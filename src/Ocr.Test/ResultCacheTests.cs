@@ -0,0 +1,269 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Runtime.ExceptionServices;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+using SpeedReader.Ocr.Geometry;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.Test.FlowControl;
+using SpeedReader.Ocr.Visualization;
+
+namespace SpeedReader.Ocr.Test;
+
+public class ResultCacheTests
+{
+    private const string Fingerprint = "test pipeline";
+
+    private static byte[] EncodePng(int width, int height)
+    {
+        using var image = new Image<Rgb24>(width, height, Color.White);
+        using var stream = new MemoryStream();
+        image.SavePng(stream);
+        return stream.ToArray();
+    }
+
+    private static OcrPipelineResult Result(string text) =>
+        new(null, MockTextDetector.SimpleResult, [(text, 0.5)], VizBuilder.Disabled);
+
+    // Boxes compare by value except the polygon, whose points are a list
+    private static void AssertSameResults(OcrPipelineResult expected, OcrPipelineResult actual)
+    {
+        Assert.Equal(expected.Results.Count, actual.Results.Count);
+        foreach (var ((expectedBox, expectedText, expectedConfidence), (actualBox, actualText, actualConfidence)) in
+                 expected.Results.Zip(actual.Results))
+        {
+            Assert.Equal(expectedText, actualText);
+            Assert.Equal(expectedConfidence, actualConfidence);
+            Assert.Equal(expectedBox.RotatedRectangle, actualBox.RotatedRectangle);
+            Assert.Equal(expectedBox.AxisAlignedRectangle, actualBox.AxisAlignedRectangle);
+            Assert.Equal(expectedBox.Polygon.Points, actualBox.Polygon.Points);
+        }
+    }
+
+    private static OcrPipeline CountingPipeline(Action onDetect, bool visualize = false) => new(
+        new MockTextDetector(() =>
+        {
+            onDetect();
+            return MockTextDetector.SimpleResult;
+        }),
+        new MockTextRecognizer(() => [("cached", 0.9)]),
+        visualize);
+
+    [Fact]
+    public async Task ReadOne_RepeatImage_SkipsPipeline()
+    {
+        var detections = 0;
+        var pipeline = CountingPipeline(() => Interlocked.Increment(ref detections));
+        pipeline.ResultCache = new ResultCache(new ResultCacheOptions(), Fingerprint);
+        var encoded = EncodePng(64, 64);
+
+        var first = await await pipeline.ReadOne(encoded);
+        first.Image?.Dispose();
+        var second = await await pipeline.ReadOne(encoded);
+
+        Assert.Equal(1, detections);
+        Assert.Null(second.Image);
+        AssertSameResults(first, second);
+        Assert.True(pipeline.TryReadOne(encoded, out var third));
+        AssertSameResults(first, await third);
+        Assert.Equal(1, detections);
+    }
+
+    [Fact]
+    public async Task ReadOne_Visualizing_IgnoresCache()
+    {
+        var detections = 0;
+        var pipeline = CountingPipeline(() => Interlocked.Increment(ref detections), visualize: true);
+        pipeline.ResultCache = new ResultCache(new ResultCacheOptions(), Fingerprint);
+        var encoded = EncodePng(64, 64);
+
+        (await await pipeline.ReadOne(encoded)).Image?.Dispose();
+        (await await pipeline.ReadOne(encoded)).Image?.Dispose();
+
+        Assert.Equal(2, detections);
+    }
+
+    [Fact]
+    public void TryGet_FullCache_EvictsLeastRecentlyUsed()
+    {
+        var cache = new ResultCache(new ResultCacheOptions { MaxEntries = 2 }, Fingerprint);
+        var (a, b, c) = (cache.Key([1]), cache.Key([2]), cache.Key([3]));
+        cache.Add(a, Result("a"));
+        cache.Add(b, Result("b"));
+
+        Assert.True(cache.TryGet(a, out _));  // Now b is least recently used
+        cache.Add(c, Result("c"));
+
+        Assert.True(cache.TryGet(a, out var resultA));
+        Assert.False(cache.TryGet(b, out _));
+        Assert.True(cache.TryGet(c, out _));
+        Assert.Equal("a", resultA.Results.Single().Text);
+    }
+
+    [Fact]
+    public void Key_PixelsAndEncodedBytes_Differ()
+    {
+        var cache = new ResultCache(new ResultCacheOptions(), Fingerprint);
+        using var image = new Image<Rgb24>(1, 1, Color.Black);
+        Assert.NotEqual(cache.Key(image), cache.Key([0, 0, 0]));
+        using var copy = image.Clone();
+        Assert.Equal(cache.Key(image), cache.Key(copy));
+    }
+
+    [Fact]
+    public void Key_OtherFingerprint_Differs()
+    {
+        var cache = new ResultCache(new ResultCacheOptions(), Fingerprint);
+        var other = new ResultCache(new ResultCacheOptions(), "other pipeline");
+        Assert.NotEqual(cache.Key([1]), other.Key([1]));
+    }
+
+    [Fact]
+    public void Fingerprint_CoversRecognitionWidths()
+    {
+        var options = new OcrPipelineOptions
+        {
+            DetectionOptions = new DetectionOptions(),
+            RecognitionOptions = new RecognitionOptions(),
+            DetectionEngine = new CpuEngineConfig
+            {
+                Kernel = new OnnxInferenceKernelOptions(Model.DbNet, Quantization.Int8, numIntraOpThreads: 1)
+            },
+            RecognitionEngine = new CpuEngineConfig
+            {
+                Kernel = new OnnxInferenceKernelOptions(Model.Svtr, Quantization.Fp32, numIntraOpThreads: 1)
+            },
+            RemoteEngine = new RemoteEngineConfig { Workers = [new Uri("http://worker-1:5000")] }
+        };
+        var narrower = options with
+        {
+            RecognitionOptions = new RecognitionOptions { RecognitionInputWidths = [80, 160] }
+        };
+
+        Assert.Equal(ResultCache.Fingerprint(options), ResultCache.Fingerprint(options with { }));
+        Assert.NotEqual(ResultCache.Fingerprint(options), ResultCache.Fingerprint(narrower));
+    }
+
+    [Fact]
+    public async Task DiskTier_SurvivesNewCache()
+    {
+        var directory = Directory.CreateTempSubdirectory("speedreader_result_cache_");
+        try
+        {
+            var options = new ResultCacheOptions { DiskDirectory = directory.FullName };
+            var cache = new ResultCache(options, Fingerprint);
+            var key = cache.Key([42]);
+            var expected = new OcrPipelineResult(null, MockTextDetector.SimpleResult, [("disk é", 0.25)],
+                VizBuilder.Disabled);
+            cache.Add(key, expected);
+
+            // Written in the background
+            var path = Path.Combine(directory.FullName, $"{key}.bin");
+            for (var i = 0; i < 100 && !File.Exists(path); i++)
+                await Task.Delay(20);
+
+            var reopened = new ResultCache(options, Fingerprint);
+            Assert.True(reopened.TryGet(reopened.Key([42]), out var actual));
+            AssertSameResults(expected, actual);
+
+            // A pipeline with other models or options doesn't see it
+            var reconfigured = new ResultCache(options, "other pipeline");
+            Assert.False(reconfigured.TryGet(reconfigured.Key([42]), out _));
+        }
+        finally
+        {
+            directory.Delete(recursive: true);
+        }
+    }
+
+    [Fact]
+    public async Task DiskTier_OverMaxDiskEntries_EvictsOldestWritten()
+    {
+        var directory = Directory.CreateTempSubdirectory("speedreader_result_cache_");
+        try
+        {
+            var cache = new ResultCache(
+                new ResultCacheOptions { DiskDirectory = directory.FullName, MaxDiskEntries = 2 }, Fingerprint);
+            var (a, b, c) = (cache.Key([1]), cache.Key([2]), cache.Key([3]));
+            string PathOf(ResultCacheKey key) => Path.Combine(directory.FullName, $"{key}.bin");
+
+            cache.Add(a, Result("a"));
+            cache.Add(b, Result("b"));
+            cache.Add(c, Result("c"));
+
+            // Written, then evicted, in the background
+            for (var i = 0; i < 100 && (File.Exists(PathOf(a)) || !File.Exists(PathOf(c))); i++)
+                await Task.Delay(20);
+
+            Assert.False(File.Exists(PathOf(a)));
+            Assert.True(File.Exists(PathOf(b)));
+            Assert.True(File.Exists(PathOf(c)));
+
+            // Files left by an earlier run count towards the bound as soon as a cache opens the directory
+            File.SetLastWriteTimeUtc(PathOf(b), DateTime.UtcNow.AddMinutes(-1));
+            _ = new ResultCache(
+                new ResultCacheOptions { DiskDirectory = directory.FullName, MaxDiskEntries = 1 }, Fingerprint);
+
+            Assert.False(File.Exists(PathOf(b)));
+            Assert.True(File.Exists(PathOf(c)));
+        }
+        finally
+        {
+            directory.Delete(recursive: true);
+        }
+    }
+
+    [Fact]
+    public void DiskTier_Miss_DoesNotOpenAFile()
+    {
+        var directory = Directory.CreateTempSubdirectory("speedreader_result_cache_");
+        try
+        {
+            var cache = new ResultCache(new ResultCacheOptions { DiskDirectory = directory.FullName }, Fingerprint);
+            var key = cache.Key([9]);
+
+            // First chance exceptions are process wide, so only count ones about this key's file
+            var thrown = 0;
+            void OnException(object? sender, FirstChanceExceptionEventArgs args)
+            {
+                if (args.Exception.Message.Contains(key.ToString()))
+                    Interlocked.Increment(ref thrown);
+            }
+
+            AppDomain.CurrentDomain.FirstChanceException += OnException;
+            try
+            {
+                Assert.False(cache.TryGet(key, out _));
+            }
+            finally
+            {
+                AppDomain.CurrentDomain.FirstChanceException -= OnException;
+            }
+            Assert.Equal(0, thrown);
+        }
+        finally
+        {
+            directory.Delete(recursive: true);
+        }
+    }
+
+    [Fact]
+    public void DiskTier_CorruptEntry_IsMiss()
+    {
+        var directory = Directory.CreateTempSubdirectory("speedreader_result_cache_");
+        try
+        {
+            var options = new ResultCacheOptions { DiskDirectory = directory.FullName };
+            var key = new ResultCache(options, Fingerprint).Key([7]);
+            File.WriteAllBytes(Path.Combine(directory.FullName, $"{key}.bin"), [0x53, 0x52, 0x43, 0x31, 5, 0]);
+
+            var cache = new ResultCache(options, Fingerprint);
+            Assert.False(cache.TryGet(key, out _));
+        }
+        finally
+        {
+            directory.Delete(recursive: true);
+        }
+    }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Diagnostics.Metrics;
+using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.InferenceEngine.Engines;
+using SpeedReader.Ocr.SmartMetrics;
+
+namespace SpeedReader.Ocr.Test;
+
+public class StageTimingsTests
+{
+    // Meters from this factory only, so tests running in parallel don't see each other's measurements
+    private sealed class TestMeterFactory : IMeterFactory
+    {
+        private readonly List<Meter> _meters = [];
+
+        public Meter Create(MeterOptions options)
+        {
+            var meter = new Meter(options);
+            lock (_meters)
+                _meters.Add(meter);
+            return meter;
+        }
+
+        public bool Owns(Meter meter)
+        {
+            lock (_meters)
+                return _meters.Contains(meter);
+        }
+
+        public void Dispose()
+        {
+            foreach (var meter in _meters)
+                meter.Dispose();
+        }
+    }
+
+    private sealed record Recorded(string Instrument, double Value, Dictionary<string, object?> Tags);
+
+    private static MeterListener Listen(TestMeterFactory factory, List<Recorded> recorded)
+    {
+        var listener = new MeterListener
+        {
+            InstrumentPublished = (instrument, meterListener) =>
+            {
+                if (factory.Owns(instrument.Meter))
+                    meterListener.EnableMeasurementEvents(instrument);
+            }
+        };
+        listener.SetMeasurementEventCallback<double>((instrument, value, tags, _) =>
+        {
+            lock (recorded)
+            {
+                var tagsByKey = tags.ToArray().ToDictionary(tag => tag.Key, tag => tag.Value);
+                recorded.Add(new Recorded(instrument.Name, value, tagsByKey));
+            }
+        });
+        listener.Start();
+        return listener;
+    }
+
+    [Fact]
+    public void Start_NothingListening_IsZero()
+    {
+        using var factory = new TestMeterFactory();
+        Assert.Equal(0, new StageTimings(factory).Start());
+        Assert.Equal(0, StageTimings.Disabled.Start());
+    }
+
+    [Fact]
+    public void Record_TagsStageAndModel()
+    {
+        using var factory = new TestMeterFactory();
+        var timings = new StageTimings(factory);
+        List<Recorded> recorded = [];
+        using var listener = Listen(factory, recorded);
+
+        timings.Record(PipelineStage.Inference, TimeSpan.FromMilliseconds(3), Model.Svtr);
+        timings.Record(PipelineStage.Decode, TimeSpan.FromMilliseconds(5));
+
+        Assert.Collection(recorded,
+            inference =>
+            {
+                Assert.Equal(3, inference.Value, 6);
+                Assert.Equal("inference", inference.Tags["stage"]);
+                Assert.Equal("svtr", inference.Tags["model"]);
+            },
+            decode =>
+            {
+                Assert.Equal(5, decode.Value, 6);
+                Assert.Equal("decode", decode.Tags["stage"]);
+                Assert.False(decode.Tags.ContainsKey("model"));
+            });
+    }
+
+    [Fact]
+    public async Task ThreadPool_BusyRunner_ReportsQueueWaitAndUtilization()
+    {
+        using var factory = new TestMeterFactory();
+        var timings = new StageTimings(factory);
+        var topology = new Topology { PCores = [0], ECores = [] };
+        List<Recorded> recorded = [];
+        using var listener = Listen(factory, recorded);
+        using var pool = new OcrThreadPool(topology, startingDbNetWorkers: 1, meterFactory: factory,
+            stageTimings: timings);
+
+        listener.RecordObservableInstruments();  // First sample only sets the baseline
+        await Task.WhenAll(Enumerable.Range(0, 4).Select(_ => pool.RunDbNet(() =>
+        {
+            Thread.Sleep(20);
+            return 0;
+        })));
+
+        List<Recorded> queueWaits;
+        lock (recorded)
+        {
+            queueWaits = [.. recorded.Where(r => r.Tags.GetValueOrDefault("stage") is "queue_wait")];
+            recorded.Clear();
+        }
+        Assert.Equal(4, queueWaits.Count);
+        Assert.All(queueWaits, wait => Assert.Equal("dbnet", wait.Tags["model"]));
+        Assert.Contains(queueWaits, wait => wait.Value >= 15);  // One runner, so later jobs waited for earlier ones
+
+        listener.RecordObservableInstruments();
+        var utilization = Assert.Single(recorded,
+            r => r.Instrument == $"{WorkerRebalancer.MeterName}.runner_utilization");
+        Assert.InRange(utilization.Value, 0.5, 1);
+        Assert.Equal(0, utilization.Tags["core"]);
+        Assert.Equal("dbnet_power", utilization.Tags["class"]);
+    }
+}
@@ -15,55 +15,81 @@ public static class GreedyCTC
         var numClasses = dictionary.Count;
         Debug.Assert(ctcSequence.Length % numClasses == 0);
 
-        var decoded = new StringBuilder();
-        var characterConfidences = new List<double>();
-
-        int prevIndex = -1;
-        double currentCharMaxProb = 0.0;
-        int currentCharIndex = -1;
-
+        var collapser = new Collapser(dictionary);
         int numSteps = ctcSequence.Length / numClasses;
         for (int step = 0; step < numSteps; step++)
         {
             int offset = step * numClasses;
             var sequence = ctcSequence.AsSpan().Slice(offset, numClasses);
             var maxIndex = IndexOfMax(sequence);
-            double maxProb = ctcSequence[offset + maxIndex];
+            collapser.Add(maxIndex, ctcSequence[offset + maxIndex]);
+        }
+
+        return collapser.Result();
+    }
+
+    // Same decode for a sequence that was already reduced to one (index, prob) pair per step, e.g. by
+    // InferenceSession.RunArgmax
+    public static (string Text, double Confidence) GreedyCTCDecodeArgmax(this float[] argmaxSequence,
+        EmbeddedCharDict dictionary)
+    {
+        Debug.Assert(argmaxSequence.Length % 2 == 0);
+
+        var collapser = new Collapser(dictionary);
+        for (int i = 0; i < argmaxSequence.Length; i += 2)
+            collapser.Add((int)argmaxSequence[i], argmaxSequence[i + 1]);
 
+        return collapser.Result();
+    }
+
+    private sealed class Collapser(EmbeddedCharDict dictionary)
+    {
+        private readonly StringBuilder _decoded = new();
+        private readonly List<double> _characterConfidences = [];
+
+        private int _prevIndex = -1;
+        private double _currentCharMaxProb = 0.0;
+        private int _currentCharIndex = -1;
+
+        public void Add(int maxIndex, double maxProb)
+        {
             // CTC greedy decoding rule: only add if different from previous and not blank
-            if (maxIndex != prevIndex && maxIndex != EmbeddedCharDict.Blank)
+            if (maxIndex != _prevIndex && maxIndex != EmbeddedCharDict.Blank)
             {
                 // If we had a previous character, save its confidence
-                if (prevIndex != -1 && prevIndex != EmbeddedCharDict.Blank)
+                if (_prevIndex != -1 && _prevIndex != EmbeddedCharDict.Blank)
                 {
-                    characterConfidences.Add(currentCharMaxProb);
+                    _characterConfidences.Add(_currentCharMaxProb);
                 }
 
                 // Start new character
                 char character = dictionary.IndexToChar(maxIndex);
-                decoded.Append(character);
-                currentCharMaxProb = maxProb; // Reset for new character
-                currentCharIndex = maxIndex;
+                _decoded.Append(character);
+                _currentCharMaxProb = maxProb; // Reset for new character
+                _currentCharIndex = maxIndex;
             }
-            else if (maxIndex == currentCharIndex && currentCharIndex != -1)
+            else if (maxIndex == _currentCharIndex && _currentCharIndex != -1)
             {
                 // Same character as current, update max probability for this character
-                currentCharMaxProb = Math.Max(currentCharMaxProb, maxProb);
+                _currentCharMaxProb = Math.Max(_currentCharMaxProb, maxProb);
             }
 
-            prevIndex = maxIndex;
+            _prevIndex = maxIndex;
         }
 
-        // Last character's confidence
-        if (decoded.Length > 0)
-            characterConfidences.Add(currentCharMaxProb);
+        public (string Text, double Confidence) Result()
+        {
+            // Last character's confidence
+            if (_decoded.Length > 0)
+                _characterConfidences.Add(_currentCharMaxProb);
 
-        // Calculate geometric mean using log-space
-        var geometricMean = characterConfidences.Count > 0
-            ? Math.Exp(characterConfidences.Average(Math.Log))
-            : 0.0;
+            // Calculate geometric mean using log-space
+            var geometricMean = _characterConfidences.Count > 0
+                ? Math.Exp(_characterConfidences.Average(Math.Log))
+                : 0.0;
 
-        return (decoded.ToString(), geometricMean);
+            return (_decoded.ToString(), geometricMean);
+        }
     }
 
     internal static int IndexOfMax(ReadOnlySpan<float> span)
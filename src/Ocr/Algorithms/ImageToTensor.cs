@@ -9,13 +9,22 @@ namespace SpeedReader.Ocr.Algorithms;
 public static class PixelsToFloatsExtensions
 {
     public static float[] ToNormalizedChwTensor(this Image<Rgb24> image, Rectangle rect, ReadOnlySpan<float> means, ReadOnlySpan<float> stds)
+    {
+        var result = new float[3 * rect.Height * rect.Width];  // CHW, 3 channels (rgb), height, width
+        image.ToNormalizedChwTensor(rect, means, stds, result);
+        return result;
+    }
+
+    // Writes into a caller-owned (e.g. pooled) buffer of exactly 3 * rect.Height * rect.Width elements
+    public static void ToNormalizedChwTensor(this Image<Rgb24> image, Rectangle rect, ReadOnlySpan<float> means, ReadOnlySpan<float> stds, float[] result)
     {
         if (means.Length != 3 || stds.Length != 3)
             throw new ArgumentException("means and stds must have length 3 (R, G, B)");
 
         var height = rect.Height;
         var width = rect.Width;
-        var result = new float[3 * height * width];  // CHW, 3 channels (rgb), height, width
+        if (result.Length != 3 * height * width)
+            throw new ArgumentException($"Expected result length {3 * height * width}, got {result.Length}", nameof(result));
 
         // Copy to local variables b/c we can't use spans in the ProcessPixelRows lambda
         var meanR = means[0];
@@ -47,7 +56,5 @@ public static class PixelsToFloatsExtensions
                 }
             }
         });
-
-        return result;
     }
 }
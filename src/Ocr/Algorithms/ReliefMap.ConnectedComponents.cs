@@ -0,0 +1,336 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Buffers;
+using System.Numerics;
+using System.Runtime.InteropServices;
+using SpeedReader.Ocr.Geometry;
+
+namespace SpeedReader.Ocr.Algorithms;
+
+public record ConnectedComponent
+{
+    public required Polygon Contour { get; init; }  // Clockwise, starting at the top left
+    public required int Area { get; init; }  // Pixel count
+    public required AxisAlignedRectangle Bounds { get; init; }
+}
+
+public static partial class ReliefMapExtensions
+{
+    // Alternative to TraceAllBoundaries. Works on a byte mask instead of the float map, so the relief map is not
+    // mutated: binarize, open with a separable 3x3 min/max, then label 8-connected runs with union-find.
+    //
+    // Contours are the component's outer boundary pixels, walked clockwise from its first pixel in scan order, so
+    // concave notches are kept. Holes are not traced
+    public static List<ConnectedComponent> LabelConnectedComponents(this ReliefMap map)
+    {
+        var width = map.Width;
+        var height = map.Height;
+        var mask = ArrayPool<byte>.Shared.Rent(width * height);
+        var scratch = ArrayPool<byte>.Shared.Rent(width * height);
+        try
+        {
+            // Same threshold as TraceAllBoundaries, recommended by the DBNet paper
+            BinarizeToMask(map.Data, 0.2f, mask.AsSpan(0, width * height));
+
+            // Morphological opening
+            Erode(mask, scratch, width, height);
+            Dilate(mask, scratch, width, height);
+
+            return LabelRuns(mask.AsSpan(0, width * height), width, height);
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(mask);
+            ArrayPool<byte>.Shared.Return(scratch);
+        }
+    }
+
+    private static void BinarizeToMask(ReadOnlySpan<float> data, float threshold, Span<byte> mask)
+    {
+        var i = 0;
+        if (Vector.IsHardwareAccelerated)
+        {
+            // Four float vectors narrow into one byte vector
+            var floatCount = Vector<float>.Count;
+            var thresholdVec = new Vector<float>(threshold);
+            var one = Vector<byte>.One;
+            for (; i <= data.Length - 4 * floatCount; i += 4 * floatCount)
+            {
+                var a = Vector.GreaterThanOrEqual(new Vector<float>(data.Slice(i)), thresholdVec);
+                var b = Vector.GreaterThanOrEqual(new Vector<float>(data.Slice(i + floatCount)), thresholdVec);
+                var c = Vector.GreaterThanOrEqual(new Vector<float>(data.Slice(i + 2 * floatCount)), thresholdVec);
+                var d = Vector.GreaterThanOrEqual(new Vector<float>(data.Slice(i + 3 * floatCount)), thresholdVec);
+                var bytes = Vector.AsVectorByte(Vector.Narrow(Vector.Narrow(a, b), Vector.Narrow(c, d)));
+                (bytes & one).CopyTo(mask.Slice(i));
+            }
+        }
+
+        for (; i < data.Length; i++)
+            mask[i] = data[i] >= threshold ? (byte)1 : (byte)0;
+    }
+
+    // 3x3 min. Pixels on the border of the map always erode, matching Erode on the float map
+    private static void Erode(byte[] mask, byte[] scratch, int width, int height)
+    {
+        for (var y = 0; y < height; y++)
+        {
+            var row = mask.AsSpan(y * width, width);
+            var output = scratch.AsSpan(y * width, width);
+            output[0] = 0;
+            output[^1] = 0;
+            if (width > 2)
+                Min3(row[..^2], row[1..^1], row[2..], output[1..^1]);
+        }
+
+        mask.AsSpan(0, width).Clear();
+        mask.AsSpan((height - 1) * width, width).Clear();
+        for (var y = 1; y < height - 1; y++)
+        {
+            Min3(scratch.AsSpan((y - 1) * width, width), scratch.AsSpan(y * width, width),
+                scratch.AsSpan((y + 1) * width, width), mask.AsSpan(y * width, width));
+        }
+    }
+
+    // 3x3 max, ignoring neighbors outside the map
+    private static void Dilate(byte[] mask, byte[] scratch, int width, int height)
+    {
+        for (var y = 0; y < height; y++)
+        {
+            var row = mask.AsSpan(y * width, width);
+            var output = scratch.AsSpan(y * width, width);
+            if (width == 1)
+            {
+                output[0] = row[0];
+                continue;
+            }
+            output[0] = Math.Max(row[0], row[1]);
+            output[^1] = Math.Max(row[^2], row[^1]);
+            if (width > 2)
+                Max3(row[..^2], row[1..^1], row[2..], output[1..^1]);
+        }
+
+        for (var y = 0; y < height; y++)
+        {
+            var above = scratch.AsSpan(Math.Max(y - 1, 0) * width, width);
+            var below = scratch.AsSpan(Math.Min(y + 1, height - 1) * width, width);
+            Max3(above, scratch.AsSpan(y * width, width), below, mask.AsSpan(y * width, width));
+        }
+    }
+
+    private static void Min3(ReadOnlySpan<byte> a, ReadOnlySpan<byte> b, ReadOnlySpan<byte> c, Span<byte> output)
+    {
+        var i = 0;
+        if (Vector.IsHardwareAccelerated)
+        {
+            for (; i <= output.Length - Vector<byte>.Count; i += Vector<byte>.Count)
+            {
+                var min = Vector.Min(Vector.Min(new Vector<byte>(a.Slice(i)), new Vector<byte>(b.Slice(i))), new Vector<byte>(c.Slice(i)));
+                min.CopyTo(output.Slice(i));
+            }
+        }
+
+        for (; i < output.Length; i++)
+            output[i] = Math.Min(Math.Min(a[i], b[i]), c[i]);
+    }
+
+    private static void Max3(ReadOnlySpan<byte> a, ReadOnlySpan<byte> b, ReadOnlySpan<byte> c, Span<byte> output)
+    {
+        var i = 0;
+        if (Vector.IsHardwareAccelerated)
+        {
+            for (; i <= output.Length - Vector<byte>.Count; i += Vector<byte>.Count)
+            {
+                var max = Vector.Max(Vector.Max(new Vector<byte>(a.Slice(i)), new Vector<byte>(b.Slice(i))), new Vector<byte>(c.Slice(i)));
+                max.CopyTo(output.Slice(i));
+            }
+        }
+
+        for (; i < output.Length; i++)
+            output[i] = Math.Max(Math.Max(a[i], b[i]), c[i]);
+    }
+
+    private record struct Run(int Row, int Start, int End);  // End is exclusive
+
+    private static List<ConnectedComponent> LabelRuns(ReadOnlySpan<byte> mask, int width, int height)
+    {
+        // Pass 1: extract runs row by row and union each run with the 8-connected runs in the row above
+        var runs = new List<Run>();
+        var parents = new List<int>();
+        var previousRowStart = 0;
+        var previousRowEnd = 0;
+
+        for (var y = 0; y < height; y++)
+        {
+            var row = mask.Slice(y * width, width);
+            var rowStart = runs.Count;
+            var candidate = previousRowStart;
+
+            var x = 0;
+            while (x < width)
+            {
+                var start = row[x..].IndexOf((byte)1);
+                if (start < 0)
+                    break;
+                start += x;
+                var length = row[start..].IndexOf((byte)0);
+                var end = length < 0 ? width : start + length;
+
+                var index = runs.Count;
+                runs.Add(new Run(y, start, end));
+                parents.Add(index);
+
+                // Runs above that end before this one starts (with diagonal slack) can't touch this or later runs
+                while (candidate < previousRowEnd && runs[candidate].End < start)
+                    candidate++;
+                for (var above = candidate; above < previousRowEnd && runs[above].Start <= end; above++)
+                    Union(parents, above, index);
+
+                x = end;
+            }
+
+            previousRowStart = rowStart;
+            previousRowEnd = runs.Count;
+        }
+
+        // Pass 2: runs are in scan order, so each component's root is its first run and components come out ordered
+        // by their top left pixel, same as TraceAllBoundaries
+        var componentOf = new Dictionary<int, int>();
+        var extents = new List<List<Run>>();  // Per component, merged row extents
+        var areas = new List<int>();
+
+        var runSpan = CollectionsMarshal.AsSpan(runs);
+        for (var i = 0; i < runSpan.Length; i++)
+        {
+            var run = runSpan[i];
+            var root = Find(parents, i);
+            if (!componentOf.TryGetValue(root, out var component))
+            {
+                component = extents.Count;
+                componentOf[root] = component;
+                extents.Add([]);
+                areas.Add(0);
+            }
+
+            areas[component] += run.End - run.Start;
+            var rows = extents[component];
+            if (rows.Count > 0 && rows[^1].Row == run.Row)
+                rows[^1] = rows[^1] with { Start = Math.Min(rows[^1].Start, run.Start), End = Math.Max(rows[^1].End, run.End) };
+            else
+                rows.Add(run);
+        }
+
+        var components = new List<ConnectedComponent>(extents.Count);
+        for (var c = 0; c < extents.Count; c++)
+            components.Add(ToComponent(mask, width, height, extents[c], areas[c]));
+
+        return components;
+
+        static ConnectedComponent ToComponent(ReadOnlySpan<byte> mask, int width, int height, List<Run> rows, int area)
+        {
+            var contour = TraceOuterBoundary(mask, width, height, rows[0].Start, rows[0].Row, 2 * rows.Count);
+
+            var left = int.MaxValue;
+            var right = int.MinValue;
+            foreach (var row in rows)
+            {
+                left = Math.Min(left, row.Start);
+                right = Math.Max(right, row.End);
+            }
+
+            return new ConnectedComponent
+            {
+                Contour = new Polygon(contour),
+                Area = area,
+                Bounds = new AxisAlignedRectangle
+                {
+                    X = left,
+                    Y = rows[0].Row,
+                    Width = right - left,
+                    Height = rows.Count
+                }
+            };
+        }
+
+    }
+
+    // Clockwise on screen (y points down), starting east
+    private static readonly (int dx, int dy)[] _clockwise =
+    [
+        (1, 0), (1, 1), (0, 1), (-1, 1),
+        (-1, 0), (-1, -1), (0, -1), (1, -1)
+    ];
+
+    // Moore neighbor tracing from the component's first pixel in scan order, whose west neighbor is background. Every
+    // foreground pixel next to the boundary belongs to the same component, so the mask is all that's needed. Stops on
+    // re-entering the start pixel from the same side it was left from (Jacob's criterion), so one pixel wide parts are
+    // walked down one side and back up the other
+    private static List<Point> TraceOuterBoundary(ReadOnlySpan<byte> mask, int width, int height, int startX,
+        int startY, int capacity)
+    {
+        var contour = new List<Point>(capacity) { (startX, startY) };
+        var (x, y) = (startX, startY);
+        var backtrack = 4;  // West
+        int? firstStep = null;
+
+        while (true)
+        {
+            var next = -1;
+            for (var i = 1; i <= 8; i++)
+            {
+                var direction = (backtrack + i) % 8;
+                var (dx, dy) = _clockwise[direction];
+                if (IsSet(mask, width, height, x + dx, y + dy))
+                {
+                    next = direction;
+                    break;
+                }
+            }
+            if (next < 0)
+                return contour;  // Single pixel
+
+            // The neighbor checked just before next is background, and adjacent to the pixel we move to
+            var (bx, by) = _clockwise[(next + 7) % 8];
+            var (nx, ny) = _clockwise[next];
+            var nextBacktrack = Array.IndexOf(_clockwise, (bx - nx, by - ny));
+
+            if (x == startX && y == startY)
+            {
+                if (firstStep == next)
+                    break;
+                firstStep ??= next;
+            }
+
+            (x, y) = (x + nx, y + ny);
+            backtrack = nextBacktrack;
+            contour.Add((x, y));
+        }
+
+        contour.RemoveAt(contour.Count - 1);  // The start, reached again
+        return contour;
+
+        static bool IsSet(ReadOnlySpan<byte> mask, int width, int height, int x, int y) =>
+            x >= 0 && x < width && y >= 0 && y < height && mask[y * width + x] != 0;
+    }
+
+    // Keeps the smaller index as the root, so roots are always a component's first run
+    private static void Union(List<int> parents, int a, int b)
+    {
+        var rootA = Find(parents, a);
+        var rootB = Find(parents, b);
+        if (rootA < rootB)
+            parents[rootB] = rootA;
+        else if (rootB < rootA)
+            parents[rootA] = rootB;
+    }
+
+    private static int Find(List<int> parents, int i)
+    {
+        while (parents[i] != i)
+        {
+            parents[i] = parents[parents[i]];  // Path halving
+            i = parents[i];
+        }
+        return i;
+    }
+}
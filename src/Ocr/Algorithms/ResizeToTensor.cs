@@ -0,0 +1,203 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Buffers;
+using System.Numerics;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+
+namespace SpeedReader.Ocr.Algorithms;
+
+public static class ResizeToTensorExtensions
+{
+    // Equivalent to resizing the image to fittedSize (bicubic, like ImageSharp's default resampler), padding it with
+    // black to the bottom right, cropping tile out of the padded image and converting that with ToNormalizedChwTensor.
+    // Only the pixels that land in the tile are ever computed, and the resized image is never materialized
+    public static void ResizeToNormalizedChwTensor(this Image<Rgb24> image, Size fittedSize, Rectangle tile,
+        ReadOnlySpan<float> means, ReadOnlySpan<float> stds, float[] result)
+    {
+        if (means.Length != 3 || stds.Length != 3)
+            throw new ArgumentException("means and stds must have length 3 (R, G, B)");
+        ArgumentOutOfRangeException.ThrowIfLessThan(fittedSize.Width, 1, nameof(fittedSize));
+        ArgumentOutOfRangeException.ThrowIfLessThan(fittedSize.Height, 1, nameof(fittedSize));
+
+        var tileWidth = tile.Width;
+        var tileHeight = tile.Height;
+        var planeSize = tileWidth * tileHeight;
+        if (result.Length != 3 * planeSize)
+            throw new ArgumentException($"Expected result length {3 * planeSize}, got {result.Length}", nameof(result));
+
+        // (v - mean) / std == v * (1 / std) + (-mean / std)
+        Span<float> scales = [1 / stds[0], 1 / stds[1], 1 / stds[2]];
+        Span<float> biases = [-means[0] * scales[0], -means[1] * scales[1], -means[2] * scales[2]];
+
+        // Padding is black, so everything starts out as a normalized zero
+        for (var c = 0; c < 3; c++)
+            result.AsSpan(c * planeSize, planeSize).Fill(biases[c]);
+
+        // Part of the tile that overlaps the resized image, in tile coordinates
+        var width = Math.Min(tile.Right, fittedSize.Width) - tile.Left;
+        var height = Math.Min(tile.Bottom, fittedSize.Height) - tile.Top;
+        if (width <= 0 || height <= 0)
+            return;
+
+        var horizontal = KernelMap.Create(image.Width, fittedSize.Width, tile.Left, width);
+        var vertical = KernelMap.Create(image.Height, fittedSize.Height, tile.Top, height);
+
+        // Horizontal pass over only the source rows the tile needs, de-interleaving into planar RGB
+        var firstSourceRow = vertical.FirstSource;
+        var sourceRows = vertical.LastSource - firstSourceRow + 1;
+        var intermediatePlaneSize = sourceRows * width;
+        var intermediate = ArrayPool<float>.Shared.Rent(3 * intermediatePlaneSize);
+        try
+        {
+            image.ProcessPixelRows(accessor =>
+            {
+                for (var row = 0; row < sourceRows; row++)
+                {
+                    var pixels = accessor.GetRowSpan(firstSourceRow + row);
+                    var rOut = intermediate.AsSpan(0 * intermediatePlaneSize + row * width, width);
+                    var gOut = intermediate.AsSpan(1 * intermediatePlaneSize + row * width, width);
+                    var bOut = intermediate.AsSpan(2 * intermediatePlaneSize + row * width, width);
+
+                    for (var x = 0; x < width; x++)
+                    {
+                        var weights = horizontal.Weights(x);
+                        var taps = pixels.Slice(horizontal.Starts[x], weights.Length);
+                        float r = 0, g = 0, b = 0;
+                        for (var k = 0; k < weights.Length; k++)
+                        {
+                            var pixel = taps[k];
+                            var w = weights[k];
+                            r += pixel.R * w;
+                            g += pixel.G * w;
+                            b += pixel.B * w;
+                        }
+                        rOut[x] = r;
+                        gOut[x] = g;
+                        bOut[x] = b;
+                    }
+                }
+            });
+
+            // Vertical pass, clamp to the byte range like a resized Rgb24 image would be, then normalize
+            for (var c = 0; c < 3; c++)
+            {
+                var plane = intermediate.AsSpan(c * intermediatePlaneSize, intermediatePlaneSize);
+                for (var y = 0; y < height; y++)
+                {
+                    var output = result.AsSpan(c * planeSize + y * tileWidth, width);
+                    var weights = vertical.Weights(y);
+                    var firstTap = vertical.Starts[y] - firstSourceRow;
+                    VerticalTaps(plane, width, firstTap, weights, scales[c], biases[c], output);
+                }
+            }
+        }
+        finally
+        {
+            ArrayPool<float>.Shared.Return(intermediate);
+        }
+    }
+
+    private static void VerticalTaps(ReadOnlySpan<float> plane, int width, int firstTap, ReadOnlySpan<float> weights,
+        float scale, float bias, Span<float> output)
+    {
+        var x = 0;
+        if (Vector.IsHardwareAccelerated)
+        {
+            var min = Vector<float>.Zero;
+            var max = new Vector<float>(255f);
+            var scaleVec = new Vector<float>(scale);
+            var biasVec = new Vector<float>(bias);
+            for (; x <= width - Vector<float>.Count; x += Vector<float>.Count)
+            {
+                var sum = Vector<float>.Zero;
+                for (var k = 0; k < weights.Length; k++)
+                    sum += new Vector<float>(plane.Slice((firstTap + k) * width + x)) * weights[k];
+                sum = Vector.Min(Vector.Max(sum, min), max);
+                (sum * scaleVec + biasVec).CopyTo(output.Slice(x));
+            }
+        }
+
+        for (; x < width; x++)
+        {
+            var sum = 0f;
+            for (var k = 0; k < weights.Length; k++)
+                sum += plane[(firstTap + k) * width + x] * weights[k];
+            output[x] = Math.Clamp(sum, 0f, 255f) * scale + bias;
+        }
+    }
+
+    // Resampling weights along one axis for a contiguous range of destination pixels. Mirrors ImageSharp's kernel
+    // map: the kernel is widened by the downscale ratio, clipped to the source and normalized
+    private sealed class KernelMap
+    {
+        private const float Radius = 2;  // Bicubic
+
+        public required int[] Starts { get; init; }
+        public required int[] Lengths { get; init; }
+        public required float[] FlatWeights { get; init; }
+        public required int Stride { get; init; }
+        public required int FirstSource { get; init; }
+        public required int LastSource { get; init; }
+
+        public ReadOnlySpan<float> Weights(int i) => FlatWeights.AsSpan(i * Stride, Lengths[i]);
+
+        public static KernelMap Create(int sourceSize, int destinationSize, int firstDestination, int count)
+        {
+            var ratio = (double)sourceSize / destinationSize;
+            var scale = Math.Max(ratio, 1);
+            var radius = Math.Ceiling(scale * Radius);
+            var stride = (int)(2 * radius) + 1;
+
+            var starts = new int[count];
+            var lengths = new int[count];
+            var weights = new float[count * stride];
+
+            for (var i = 0; i < count; i++)
+            {
+                var center = (firstDestination + i + 0.5) * ratio - 0.5;
+                var left = Math.Max(0, (int)Math.Ceiling(center - radius));
+                var right = Math.Min(sourceSize - 1, (int)Math.Floor(center + radius));
+
+                var row = weights.AsSpan(i * stride, right - left + 1);
+                var sum = 0f;
+                for (var j = left; j <= right; j++)
+                {
+                    var w = Bicubic((float)((j - center) / scale));
+                    row[j - left] = w;
+                    sum += w;
+                }
+                if (sum != 0)
+                {
+                    for (var j = 0; j < row.Length; j++)
+                        row[j] /= sum;
+                }
+
+                starts[i] = left;
+                lengths[i] = row.Length;
+            }
+
+            return new KernelMap
+            {
+                Starts = starts,
+                Lengths = lengths,
+                FlatWeights = weights,
+                Stride = stride,
+                FirstSource = starts[0],
+                LastSource = starts[^1] + lengths[^1] - 1
+            };
+        }
+
+        // Catmull-Rom (a = -0.5), same as ImageSharp's BicubicResampler
+        private static float Bicubic(float x)
+        {
+            x = Math.Abs(x);
+            if (x <= 1)
+                return (1.5f * x - 2.5f) * x * x + 1;
+            if (x < 2)
+                return ((-0.5f * x + 2.5f) * x - 4) * x + 2;
+            return 0;
+        }
+    }
+}
@@ -5,18 +5,94 @@ using SpeedReader.Ocr.InferenceEngine;
 
 namespace SpeedReader.Ocr;
 
+public enum DetectionPostprocessing
+{
+    BoundaryTracing,  // Float map: binarize, open, Moore trace and flood fill per region
+    ConnectedComponents,  // Byte mask: binarize, open, run-based union-find labelling
+    Native  // ConnectedComponents and box fitting in speedreader_ort, straight from the merged map to boxes
+}
+
 public record DetectionOptions
 {
     public int TileWidth { get; init; } = 640;
     public int TileHeight { get; init; } = 640;
+    public DetectionPostprocessing Postprocessing { get; init; } = DetectionPostprocessing.BoundaryTracing;
 }
 
 public record RecognitionOptions
 {
-    public int RecognitionInputWidth { get; init; } = 160;
+    // Each region is resized to the input height, then padded to the narrowest bucket its width fits in (or squashed
+    // into the widest). SVTR emits one time step per 8 pixels, so every bucket must be a multiple of 8
+    public int[] RecognitionInputWidths
+    {
+        get;
+        init => field = value.Length > 0 && value.All(width => width > 0 && width % 8 == 0)
+            ? value.Order().Distinct().ToArray()
+            : throw new ArgumentOutOfRangeException(nameof(value));
+    } = [80, 160, 320, 640];
+
     public int RecognitionInputHeight { get; init; } = 48;
 }
 
+public record DecodeOptions
+{
+    // Max encoded images decoding at once
+    public int MaxParallelism
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = Math.Max(1, Environment.ProcessorCount / 2);
+
+    // Size hint for encoded images. Detection sees images no larger than this on their long side, decoded at reduced
+    // resolution; the full image is only decoded if there's text to recognize. Null detects at full resolution.
+    // Ignored when visualizing, since the visualization draws on the detection image
+    public int? MaxDetectionDimension
+    {
+        get;
+        init => field = value is null or > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    }
+}
+
+public record ReadManyOptions
+{
+    // Cap on results in flight plus completed but not yet consumed. Null means twice the pipeline's capacity
+    public int? MaxPending
+    {
+        get;
+        init => field = value is null or > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    }
+
+    // Unordered yields results as they complete, so one slow image doesn't hold back the ones behind it
+    public bool Ordered { get; init; } = true;
+}
+
+public record ResultCacheOptions
+{
+    // Results held in memory, least recently used evicted first
+    public int MaxEntries
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 4096;
+
+    // Second tier behind memory, one small file per result, so results survive restarts. Keys cover the models and
+    // options, so a changed configuration starts with misses. Null keeps the cache in memory only
+    public string? DiskDirectory
+    {
+        get;
+        init => field = value == null || !string.IsNullOrWhiteSpace(value)
+            ? value
+            : throw new ArgumentOutOfRangeException(nameof(value));
+    }
+
+    // Results kept in DiskDirectory, oldest written evicted first. Files already there count towards it on startup
+    public int MaxDiskEntries
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 65536;
+}
+
 public record OcrPipelineOptions
 {
     public required DetectionOptions DetectionOptions { get; init; }
@@ -24,4 +100,20 @@ public record OcrPipelineOptions
 
     public required CpuEngineConfig DetectionEngine { get; init; }
     public required CpuEngineConfig RecognitionEngine { get; init; }
+
+    // Shard both models across other servers instead of running them here. DetectionEngine and RecognitionEngine are
+    // then unused, each worker runs whatever models it was started with. Null runs locally
+    public RemoteEngineConfig? RemoteEngine { get; init; }
+
+    public RebalancingOptions Rebalancing { get; init; } = new();
+
+    public DecodeOptions Decode { get; init; } = new();
+
+    // Collect what OcrPipelineResult.VizBuilder needs to render an SVG. Off by default, it costs a full pass over the
+    // probability map
+    public bool Visualize { get; init; }
+
+    // Serve repeat images from a cache instead of the models. Null disables it. Ignored when visualizing, since cached
+    // results have nothing to render
+    public ResultCacheOptions? ResultCache { get; init; }
 }
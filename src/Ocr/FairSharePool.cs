@@ -0,0 +1,200 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Diagnostics.CodeAnalysis;
+
+namespace SpeedReader.Ocr;
+
+// A TaskPool shared by several tenants, e.g. pipelines for different callers over the same engines. While there's
+// room every tenant starts right away; once the pool is full each free slot goes to the waiting tenant that has used
+// the least of its share. Starting a task advances a tenant's virtual time by 1 / Weight, and the waiting tenant with
+// the lowest virtual time goes next, so under contention tenants get slots in proportion to their weights. A tenant
+// that had nothing waiting restarts at the current virtual time, it can't bank credit while idle
+public class FairSharePool<T>
+{
+    private readonly Lock _lock = new();
+    private readonly List<Tenant> _tenants = [];
+    private int _poolSize;
+    private int _poolOccupancy;
+    private double _virtualTime;  // Virtual time of the most recent start
+
+    public FairSharePool(int poolSize)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(poolSize, 1, nameof(poolSize));
+        _poolSize = poolSize;
+    }
+
+    public int PoolSize
+    {
+        get
+        {
+            lock (_lock)
+                return _poolSize;
+        }
+    }
+
+    public int PoolOccupancy
+    {
+        get
+        {
+            lock (_lock)
+                return _poolOccupancy;
+        }
+    }
+
+    public Tenant AddTenant(int weight = 1)
+    {
+        var tenant = new Tenant(this, weight);
+        lock (_lock)
+        {
+            tenant.VirtualTime = _virtualTime;
+            _tenants.Add(tenant);
+        }
+        return tenant;
+    }
+
+    public void SetPoolSize(int newSize)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(newSize, 1, nameof(newSize));
+        lock (_lock)
+            _poolSize = newSize;
+        StartNewTasks();  // If pool size decreased this does nothing
+    }
+
+    private Task<Task<T>> Execute(Tenant tenant, Func<Task<T>> userTaskCreator)
+    {
+        lock (_lock)
+        {
+            // Nobody waits while there's room, so starting right away never jumps the queue
+            if (_poolOccupancy >= _poolSize)
+            {
+                if (tenant.Pending.Count == 0)
+                    tenant.VirtualTime = Math.Max(tenant.VirtualTime, _virtualTime);
+                var tcs = new TaskCompletionSource<Task<T>>(TaskCreationOptions.RunContinuationsAsynchronously);
+                tenant.Pending.Enqueue((tcs, userTaskCreator));
+                return tcs.Task;
+            }
+            Admit(tenant);
+        }
+
+        return Task.FromResult(StartUserTask(userTaskCreator));
+    }
+
+    private bool TryExecute(Tenant tenant, Func<Task<T>> userTaskCreator, [NotNullWhen(true)] out Task<T>? userTask)
+    {
+        lock (_lock)
+        {
+            if (_poolOccupancy >= _poolSize)
+            {
+                userTask = null;
+                return false;
+            }
+            Admit(tenant);
+        }
+
+        userTask = StartUserTask(userTaskCreator);
+        return true;
+    }
+
+    // Caller holds _lock
+    private void Admit(Tenant tenant)
+    {
+        _poolOccupancy++;
+        _virtualTime = Math.Max(_virtualTime, tenant.VirtualTime);
+        tenant.VirtualTime += 1.0 / tenant.Weight;
+    }
+
+    // Tasks start outside the lock, user task creators may take a while and completions call back into the pool
+    private Task<T> StartUserTask(Func<Task<T>> taskCreator)
+    {
+        Task<T> userTask;
+        try
+        {
+            userTask = taskCreator();
+        }
+        catch (Exception ex)
+        {
+            userTask = Task.FromException<T>(new UserTaskCreationException("Error creating user task", ex));
+        }
+
+        userTask.ConfigureAwait(false).GetAwaiter().UnsafeOnCompleted(OnUserTaskCompleted);
+        return userTask;
+    }
+
+    private void OnUserTaskCompleted()
+    {
+        lock (_lock)
+            _poolOccupancy--;
+        StartNewTasks();
+    }
+
+    private void StartNewTasks()
+    {
+        while (true)
+        {
+            TaskCompletionSource<Task<T>> tcs;
+            Func<Task<T>> taskCreator;
+            lock (_lock)
+            {
+                if (_poolOccupancy >= _poolSize || NextTenant() is not { } tenant)
+                    return;
+                (tcs, taskCreator) = tenant.Pending.Dequeue();
+                Admit(tenant);
+            }
+
+            tcs.SetResult(StartUserTask(taskCreator));
+        }
+    }
+
+    // Caller holds _lock. Also forgets removed tenants once they have nothing left to run
+    private Tenant? NextTenant()
+    {
+        _tenants.RemoveAll(tenant => tenant.Removed && tenant.Pending.Count == 0);
+
+        Tenant? next = null;
+        foreach (var tenant in _tenants)
+        {
+            if (tenant.Pending.Count > 0 && (next == null || tenant.VirtualTime < next.VirtualTime))
+                next = tenant;
+        }
+        return next;
+    }
+
+    public sealed class Tenant : ITaskPool<T>, IDisposable
+    {
+        private readonly FairSharePool<T> _pool;
+
+        internal Tenant(FairSharePool<T> pool, int weight)
+        {
+            _pool = pool;
+            Weight = weight;
+        }
+
+        // Guarded by the pool's lock
+        internal Queue<(TaskCompletionSource<Task<T>>, Func<Task<T>>)> Pending { get; } = new();
+        internal double VirtualTime { get; set; }
+        internal bool Removed { get; private set; }
+
+        // Relative share of the pool when tenants compete for it, takes effect from the next start
+        public int Weight
+        {
+            get;
+            set => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+        }
+
+        // A tenant may use the whole pool while nobody else wants it
+        public int PoolSize => _pool.PoolSize;
+
+        public Task<Task<T>> Execute(Func<Task<T>> userTaskCreator) => _pool.Execute(this, userTaskCreator);
+
+        public bool TryExecute(Func<Task<T>> userTaskCreator, [NotNullWhen(true)] out Task<T>? userTask) =>
+            _pool.TryExecute(this, userTaskCreator, out userTask);
+
+        // Work already waiting still runs
+        public void Dispose()
+        {
+            lock (_pool._lock)
+                Removed = true;
+        }
+    }
+}
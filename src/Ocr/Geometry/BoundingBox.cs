@@ -15,4 +15,20 @@ public record BoundingBox
 
     [JsonPropertyName("rectangle")]
     public required AxisAlignedRectangle AxisAlignedRectangle { get; init; }
+
+    // Scale about the origin, e.g. to map detections from a downscaled image onto the original. A rotated rectangle
+    // doesn't stay one under unequal scales, so both rectangles are refit to the scaled polygon, as detection fits them
+    public BoundingBox Scale(double scaleX, double scaleY)
+    {
+        var polygon = Polygon.Scale(scaleX, scaleY);
+
+        // Positive scales keep a polygon that had a rotated rectangle from degenerating
+        var rotatedRectangle = polygon.ToConvexHull()!.ToRotatedRectangle()!;
+        return new BoundingBox
+        {
+            Polygon = polygon,
+            RotatedRectangle = rotatedRectangle,
+            AxisAlignedRectangle = rotatedRectangle.ToAxisAlignedRectangle()
+        };
+    }
 }
@@ -78,14 +78,16 @@ public record Polygon
         };
     }
 
-    public Polygon Scale(double scale)
+    public Polygon Scale(double scale) => Scale(scale, scale);
+
+    public Polygon Scale(double scaleX, double scaleY)
     {
         return new Polygon(Points.Select(ScalePoint).ToList());
 
         PointF ScalePoint(PointF p) => new()
         {
-            X = p.X * scale,
-            Y = p.Y * scale
+            X = p.X * scaleX,
+            Y = p.Y * scaleY
         };
     }
 
@@ -0,0 +1,218 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Buffers;
+using System.Numerics;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+
+namespace SpeedReader.Ocr.Geometry;
+
+public partial record RotatedRectangle
+{
+    // Source coordinates are 24.8 fixed point, as precise as the 8 bit bilinear weights need. Column and row parts are
+    // each clamped to +-MaxFixed before they're added, so images up to MaxWarpDimension can't overflow an int
+    private const int FixedShift = 8;
+    private const int WeightBits = 8;  // Bilinear weights are 0..256
+    private const int MaxFixed = (1 << 30) - 1;
+    private const int MaxWarpDimension = 1 << (30 - FixedShift);
+    private const int MaxSupersampling = 4;
+
+    // Equivalent to Crop, followed by a ResizeMode.Pad (top-left) resize to width x height, followed by
+    // ToNormalizedChwTensor, but samples the source image once per output pixel and writes straight into result.
+    // When the crop is scaled down, each output pixel averages a grid of samples so long lines don't alias
+    public void WarpToNormalizedChwTensor(Image<Rgb24> image, int width, int height,
+        ReadOnlySpan<float> means, ReadOnlySpan<float> stds, float[] result)
+    {
+        if (means.Length != 3 || stds.Length != 3)
+            throw new ArgumentException("means and stds must have length 3 (R, G, B)");
+        var planeSize = width * height;
+        if (result.Length != 3 * planeSize)
+            throw new ArgumentException($"Expected result length {3 * planeSize}, got {result.Length}", nameof(result));
+        if (image.Width > MaxWarpDimension || image.Height > MaxWarpDimension)
+            throw new ArgumentException($"Images over {MaxWarpDimension} pixels on a side are not supported", nameof(image));
+
+        var cropWidth = (int)Math.Ceiling(Width);
+        var cropHeight = (int)Math.Ceiling(Height);
+
+        // Same rounding as ImageSharp's ResizeMode.Pad
+        var widthRatio = width / (float)cropWidth;
+        var heightRatio = height / (float)cropHeight;
+        var (fittedWidth, fittedHeight) = heightRatio < widthRatio
+            ? ((int)MathF.Round(cropWidth * heightRatio), height)
+            : (width, (int)MathF.Round(cropHeight * widthRatio));
+        fittedWidth = Math.Max(fittedWidth, 1);
+        fittedHeight = Math.Max(fittedHeight, 1);
+
+        var samplesX = Math.Clamp((int)Math.Ceiling((double)cropWidth / fittedWidth), 1, MaxSupersampling);
+        var samplesY = Math.Clamp((int)Math.Ceiling((double)cropHeight / fittedHeight), 1, MaxSupersampling);
+
+        // (v - mean) / std == v * (1 / std) + (-mean / std). The sample average and fixed point scale fold into the
+        // multiplier
+        var toByteScale = 1f / (samplesX * samplesY * (1 << (2 * WeightBits)));
+        var (rScale, gScale, bScale) = (1 / stds[0], 1 / stds[1], 1 / stds[2]);
+        var (rBias, gBias, bBias) = (-means[0] * rScale, -means[1] * gScale, -means[2] * bScale);
+
+        // Padding is black, so everything starts out as a normalized zero
+        result.AsSpan(0 * planeSize, planeSize).Fill(rBias);
+        result.AsSpan(1 * planeSize, planeSize).Fill(gBias);
+        result.AsSpan(2 * planeSize, planeSize).Fill(bBias);
+
+        var corners = Corners().Points;
+        var topLeft = corners[0];
+        var uVector = (X: corners[1].X - topLeft.X, Y: corners[1].Y - topLeft.Y);
+        var vVector = (X: corners[3].X - topLeft.X, Y: corners[3].Y - topLeft.Y);
+
+        // Source position is topLeft + u * uVector + v * vVector, where (u, v) follow Crop's convention of mapping the
+        // first and last crop pixel to the rectangle edges. Precompute the column (u) part per sample column, the row
+        // (v) part is added per output row
+        var columnCount = samplesX * fittedWidth;
+        var columnX = ArrayPool<int>.Shared.Rent(columnCount);
+        var columnY = ArrayPool<int>.Shared.Rent(columnCount);
+        var sumR = ArrayPool<int>.Shared.Rent(fittedWidth);
+        var sumG = ArrayPool<int>.Shared.Rent(fittedWidth);
+        var sumB = ArrayPool<int>.Shared.Rent(fittedWidth);
+        var sampleX = ArrayPool<int>.Shared.Rent(fittedWidth);
+        var sampleY = ArrayPool<int>.Shared.Rent(fittedWidth);
+        try
+        {
+            for (var s = 0; s < samplesX; s++)
+            {
+                for (var x = 0; x < fittedWidth; x++)
+                {
+                    var u = CropFraction(x, s, samplesX, cropWidth, fittedWidth);
+                    columnX[s * fittedWidth + x] = ToFixed(topLeft.X + u * uVector.X);
+                    columnY[s * fittedWidth + x] = ToFixed(topLeft.Y + u * uVector.Y);
+                }
+            }
+
+            var maxX = (image.Width - 1) << FixedShift;
+            var maxY = (image.Height - 1) << FixedShift;
+
+            image.ProcessPixelRows(accessor =>
+            {
+                for (var y = 0; y < fittedHeight; y++)
+                {
+                    Array.Clear(sumR, 0, fittedWidth);
+                    Array.Clear(sumG, 0, fittedWidth);
+                    Array.Clear(sumB, 0, fittedWidth);
+
+                    for (var sy = 0; sy < samplesY; sy++)
+                    {
+                        var v = CropFraction(y, sy, samplesY, cropHeight, fittedHeight);
+                        var rowX = ToFixed(v * vVector.X);
+                        var rowY = ToFixed(v * vVector.Y);
+
+                        for (var sx = 0; sx < samplesX; sx++)
+                        {
+                            SourceCoordinates(columnX.AsSpan(sx * fittedWidth, fittedWidth), rowX, maxX, sampleX.AsSpan(0, fittedWidth));
+                            SourceCoordinates(columnY.AsSpan(sx * fittedWidth, fittedWidth), rowY, maxY, sampleY.AsSpan(0, fittedWidth));
+                            AccumulateBilinear(accessor, sampleX, sampleY, fittedWidth, sumR, sumG, sumB);
+                        }
+                    }
+
+                    WriteNormalizedRow(sumR, toByteScale * rScale, rBias, result.AsSpan(0 * planeSize + y * width, fittedWidth));
+                    WriteNormalizedRow(sumG, toByteScale * gScale, gBias, result.AsSpan(1 * planeSize + y * width, fittedWidth));
+                    WriteNormalizedRow(sumB, toByteScale * bScale, bBias, result.AsSpan(2 * planeSize + y * width, fittedWidth));
+                }
+            });
+        }
+        finally
+        {
+            ArrayPool<int>.Shared.Return(columnX);
+            ArrayPool<int>.Shared.Return(columnY);
+            ArrayPool<int>.Shared.Return(sumR);
+            ArrayPool<int>.Shared.Return(sumG);
+            ArrayPool<int>.Shared.Return(sumB);
+            ArrayPool<int>.Shared.Return(sampleX);
+            ArrayPool<int>.Shared.Return(sampleY);
+        }
+
+        return;
+
+        static int ToFixed(double value) => (int)Math.Clamp(Math.Round(value * (1 << FixedShift)), -MaxFixed, MaxFixed);
+
+        // Position of sample s of output pixel i along one axis as a fraction of the crop, in [0, 1]. Matches the
+        // resize's pixel-center mapping from fitted back to crop pixels, then Crop's mapping from crop pixels to [0, 1]
+        static double CropFraction(int i, int s, int samples, int cropSize, int fittedSize)
+        {
+            if (cropSize <= 1)
+                return 0;
+            var position = i + (s + 0.5) / samples;  // In output pixels
+            var cropPixel = Math.Clamp(position * cropSize / fittedSize - 0.5, 0, cropSize - 1);
+            return cropPixel / (cropSize - 1);
+        }
+    }
+
+    // sample[i] = clamp(column[i] + row, 0, max), vectorized
+    private static void SourceCoordinates(ReadOnlySpan<int> column, int row, int max, Span<int> sample)
+    {
+        var i = 0;
+        if (Vector.IsHardwareAccelerated)
+        {
+            var rowVec = new Vector<int>(row);
+            var maxVec = new Vector<int>(max);
+            for (; i <= column.Length - Vector<int>.Count; i += Vector<int>.Count)
+            {
+                var coordinate = new Vector<int>(column.Slice(i)) + rowVec;
+                Vector.Min(Vector.Max(coordinate, Vector<int>.Zero), maxVec).CopyTo(sample.Slice(i));
+            }
+        }
+
+        for (; i < column.Length; i++)
+            sample[i] = Math.Clamp(column[i] + row, 0, max);
+    }
+
+    // Adds the fixed point bilinear sample at each (sampleX[i], sampleY[i]) to the sums, scaled by 2^(2 * WeightBits)
+    private static void AccumulateBilinear(PixelAccessor<Rgb24> accessor, int[] sampleX, int[] sampleY, int count,
+        int[] sumR, int[] sumG, int[] sumB)
+    {
+        const int one = 1 << WeightBits;
+        const int fractionMask = one - 1;
+        const int fractionShift = FixedShift - WeightBits;
+        var lastX = accessor.Width - 1;
+        var lastY = accessor.Height - 1;
+
+        for (var i = 0; i < count; i++)
+        {
+            var x0 = sampleX[i] >> FixedShift;
+            var y0 = sampleY[i] >> FixedShift;
+            var fx = (sampleX[i] >> fractionShift) & fractionMask;
+            var fy = (sampleY[i] >> fractionShift) & fractionMask;
+            var x1 = Math.Min(x0 + 1, lastX);
+            var y1 = Math.Min(y0 + 1, lastY);
+
+            var row0 = accessor.GetRowSpan(y0);
+            var row1 = accessor.GetRowSpan(y1);
+            var p00 = row0[x0];
+            var p10 = row0[x1];
+            var p01 = row1[x0];
+            var p11 = row1[x1];
+
+            var wx0 = one - fx;
+            var wy0 = one - fy;
+            sumR[i] += (p00.R * wx0 + p10.R * fx) * wy0 + (p01.R * wx0 + p11.R * fx) * fy;
+            sumG[i] += (p00.G * wx0 + p10.G * fx) * wy0 + (p01.G * wx0 + p11.G * fx) * fy;
+            sumB[i] += (p00.B * wx0 + p10.B * fx) * wy0 + (p01.B * wx0 + p11.B * fx) * fy;
+        }
+    }
+
+    private static void WriteNormalizedRow(int[] sums, float scale, float bias, Span<float> output)
+    {
+        var count = output.Length;
+        var i = 0;
+        if (Vector.IsHardwareAccelerated)
+        {
+            var scaleVec = new Vector<float>(scale);
+            var biasVec = new Vector<float>(bias);
+            for (; i <= count - Vector<int>.Count; i += Vector<int>.Count)
+            {
+                var sum = Vector.ConvertToSingle(new Vector<int>(sums, i));
+                (sum * scaleVec + biasVec).CopyTo(output.Slice(i));
+            }
+        }
+
+        for (; i < count; i++)
+            output[i] = sums[i] * scale + bias;
+    }
+}
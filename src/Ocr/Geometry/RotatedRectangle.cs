@@ -8,7 +8,7 @@ using SixLabors.ImageSharp.PixelFormats;
 
 namespace SpeedReader.Ocr.Geometry;
 
-public record RotatedRectangle
+public partial record RotatedRectangle
 {
     [JsonPropertyName("x")]
     public required double X { get; init; }  // Top left x
@@ -0,0 +1,76 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.Formats;
+using SixLabors.ImageSharp.PixelFormats;
+using SpeedReader.Ocr.SmartMetrics;
+
+namespace SpeedReader.Ocr;
+
+// Decode stage for encoded images, with its own parallelism limit so a burst of large uploads can't take every thread
+public class ImageDecoder
+{
+    private readonly SemaphoreSlim _slots;
+    private readonly int? _maxDetectionDimension;
+    private readonly DecoderOptions _fullSize;
+    private readonly StageTimings _stageTimings;
+
+    public ImageDecoder(DecodeOptions options, StageTimings? stageTimings = null)
+    {
+        _slots = new SemaphoreSlim(options.MaxParallelism);
+        _maxDetectionDimension = options.MaxDetectionDimension;
+        _fullSize = new DecoderOptions { Configuration = ContiguousConfiguration() };
+        _stageTimings = stageTimings ?? StageTimings.Disabled;
+    }
+
+    // Null if detection should see the image at full size. Otherwise the reduced size to decode for detection
+    public Size? DetectionSize(ReadOnlyMemory<byte> encodedImage)
+    {
+        if (_maxDetectionDimension is not { } maxDimension)
+            return null;
+
+        var info = Image.Identify(encodedImage.Span);  // Header only
+        var longSide = Math.Max(info.Width, info.Height);
+        if (longSide <= maxDimension)
+            return null;
+
+        var scale = (double)maxDimension / longSide;
+        return new Size(
+            Math.Max(1, (int)Math.Round(info.Width * scale)),
+            Math.Max(1, (int)Math.Round(info.Height * scale)));
+    }
+
+    // With a target size, JPEG decodes straight to a reduced resolution with DCT scaling; other formats decode and
+    // then resize. Waiting for a slot isn't part of the decode timing
+    public async Task<Image<Rgb24>> Decode(ReadOnlyMemory<byte> encodedImage, Size? targetSize = null)
+    {
+        var options = targetSize is { } size
+            ? new DecoderOptions { Configuration = _fullSize.Configuration, TargetSize = size }
+            : _fullSize;
+
+        await _slots.WaitAsync();
+        try
+        {
+            return await Task.Run(() =>
+            {
+                var start = _stageTimings.Start();
+                var image = Image.Load<Rgb24>(options, encodedImage.Span);
+                _stageTimings.Record(PipelineStage.Decode, start);
+                return image;
+            });
+        }
+        finally
+        {
+            _slots.Release();
+        }
+    }
+
+    // Same decoder configuration as the server: one buffer per image rather than pooled chunks
+    private static Configuration ContiguousConfiguration()
+    {
+        var config = Configuration.Default.Clone();
+        config.PreferContiguousImageBuffers = true;
+        return config;
+    }
+}
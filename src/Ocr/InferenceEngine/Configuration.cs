@@ -38,6 +38,14 @@ public record OnnxInferenceKernelOptions
     public int NumIntraOpThreads { get; }
     public int NumInterOpThreads { get; }
     public bool EnableProfiling { get; }
+
+    // Directory to cache the optimized model in. The first session on a host optimizes the model and writes it here,
+    // later sessions memory-map it and skip graph optimization. Null disables the cache
+    public string? ModelCacheDirectory { get; init; }
+
+    // SVTR only. The native run reduces each step's logits to (index, prob) of the max before returning, so the
+    // output is [n, w/8, 2] instead of [n, w/8, vocab_size] and CTC decoding is left with collapse and lookup
+    public bool FusedArgmax { get; init; } = true;
 }
 
 
@@ -49,11 +57,128 @@ public record CpuEngineConfig
 {
     public required OnnxInferenceKernelOptions Kernel { get; init; }
     public int MaxParallelism { get; init; } = 4;
+
+    // Concurrent requests with the same input shape are coalesced into batches of up to MaxBatchSize. A batch that
+    // isn't full is held for at most MaxBatchWaitMicroseconds waiting for more requests. MaxBatchSize = 1 disables
+    // batching
+    public int MaxBatchSize
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 1;
+
+    public int MaxBatchWaitMicroseconds
+    {
+        get;
+        init => field = value >= 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 500;
+
+    // Logical CPU ids to run on. Empty lists are filled in from the CPU topology discovered at startup
     public List<int> ReservedPCores { get; init; } = [];
     public List<int> UnreservedPCores { get; init; } = [];
     public List<int> ECores { get; init; } = [];
 }
 
+// DBNet and SVTR share one thread pool. Every IntervalMilliseconds the rebalancer compares how long requests for each
+// model waited for a runner and moves a P-core to the starved model. A move needs the starved model's smoothed wait
+// to be at least WaitThresholdMilliseconds and Hysteresis times the other model's, then no further moves are
+// considered for CooldownIntervals
+public record RebalancingOptions
+{
+    public bool Enabled { get; init; } = true;
+
+    public int IntervalMilliseconds
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 250;
+
+    public double WaitThresholdMilliseconds
+    {
+        get;
+        init => field = value >= 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 20;
+
+    public double Hysteresis
+    {
+        get;
+        init => field = value >= 1 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 2;
+
+    public int CooldownIntervals
+    {
+        get;
+        init => field = value >= 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 4;
+
+    // Weight of the newest sample in the exponential moving averages of queue depth and wait
+    public double Smoothing
+    {
+        get;
+        init => field = value is > 0 and <= 1 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 0.5;
+
+    // DBNet only runs on its own P-cores, so it always keeps at least this many
+    public int MinDbNetWorkers
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 1;
+}
+
+#endregion
+
+#region Remote Engine
+
+// Runs a model on other SpeedReader servers, each answering on InferenceWire.Path. Every request goes to the worker
+// with the least load per unit of capacity, counting both the requests this engine has in flight there and the queue
+// depth the worker reported with its last response
+public record RemoteEngineConfig
+{
+    // Items per request a worker accepts, workers answer larger batches with an error
+    public const int MaxWorkerBatchSize = 8;
+
+    // Base addresses, e.g. http://worker-1:5000
+    public required IReadOnlyList<Uri> Workers
+    {
+        get;
+        init => field = value.Count > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    }
+
+    // Concurrent requests with the same input shape are coalesced into one call of up to MaxBatchSize items, held for
+    // at most MaxBatchWaitMicroseconds waiting for more. The worker splits the batch again and batches with its own
+    // traffic, so this only amortizes the round trip. At most MaxWorkerBatchSize
+    public int MaxBatchSize
+    {
+        get;
+        init => field = value is > 0 and <= MaxWorkerBatchSize
+            ? value
+            : throw new ArgumentOutOfRangeException(nameof(value));
+    } = MaxWorkerBatchSize;
+
+    public int MaxBatchWaitMicroseconds
+    {
+        get;
+        init => field = value >= 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 500;
+
+    // A worker that hasn't answered a request within this long counts as unreachable, and the request moves on to the
+    // next worker. Covers the wait in the worker's queue, so leave room for a busy one
+    public int RequestTimeoutMilliseconds
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 30_000;
+
+    // Items a worker is assumed to run at once until it reports its own capacity. The pipeline sizes itself from the
+    // sum over workers when it's built
+    public int WorkerCapacity
+    {
+        get;
+        init => field = value > 0 ? value : throw new ArgumentOutOfRangeException(nameof(value));
+    } = 8;
+}
+
 #endregion
 
 #region GPU Engine
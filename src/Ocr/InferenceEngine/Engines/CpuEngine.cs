@@ -1,8 +1,8 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
-using System.Diagnostics.Metrics;
 using Microsoft.Extensions.DependencyInjection;
+using SpeedReader.Ocr.SmartMetrics;
 
 namespace SpeedReader.Ocr.InferenceEngine.Engines;
 
@@ -11,41 +11,70 @@ public class CpuEngine : IInferenceEngine
     private readonly IInferenceKernel _inferenceKernel;
     private readonly OcrThreadPool _threadPool;
     private readonly Model _model;
+    private readonly InferenceBatcher? _batcher;
+    private readonly TensorPool _tensorPool;
+    private readonly StageTimings _stageTimings;
+    private readonly int _maxBatchSize;
 
     public static CpuEngine Factory(IServiceProvider serviceProvider, object? key)
     {
         var config = serviceProvider.GetRequiredKeyedService<CpuEngineConfig>(key);
         var kernel = serviceProvider.GetRequiredKeyedService<IInferenceKernel>(key);
-        var meterFactory = serviceProvider.GetService<IMeterFactory>();
-        return new CpuEngine(kernel, (Model)key!, meterFactory);
+        var stageTimings = serviceProvider.GetService<StageTimings>();
+        var tensorPool = serviceProvider.GetService<TensorPool>();
+        var threadPool = serviceProvider.GetRequiredService<OcrThreadPool>();
+        return new CpuEngine(config, kernel, (Model)key!, stageTimings, tensorPool, threadPool);
     }
 
-    private CpuEngine(IInferenceKernel inferenceKernel, Model model, IMeterFactory? meterFactory)
+    private CpuEngine(CpuEngineConfig config, IInferenceKernel inferenceKernel, Model model, StageTimings? stageTimings,
+        TensorPool? tensorPool, OcrThreadPool threadPool)
     {
-        var topology = new Topology
-        {
-            PCores = [0, 2, 4, 6, 8, 10, 12, 14],
-            ECores = [16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27]
-        };
         _inferenceKernel = inferenceKernel;
-        _threadPool = new OcrThreadPool(topology, topology.PCores.Length);
+        _threadPool = threadPool;
         _model = model;
+        _maxBatchSize = config.MaxBatchSize;
+        _tensorPool = tensorPool ?? TensorPool.Shared;
+        _stageTimings = stageTimings ?? StageTimings.Disabled;
+        if (config.MaxBatchSize > 1)
+            _batcher = new InferenceBatcher(RunBatch, config.MaxBatchSize, config.MaxBatchWaitMicroseconds, _threadPool.Capacity(model), _tensorPool);
     }
 
-    public int CurrentMaxCapacity() => 8;
+    // Each runner thread can hold a full batch
+    public int CurrentMaxCapacity() => _threadPool.Capacity(_model) * _maxBatchSize;
+
+    public async Task<(float[] OutputData, int[] OutputShape)> Run(float[] inputData, int[] inputShape)
+    {
+        if (_batcher != null)
+            return await _batcher.Run(inputData, inputShape);
+
+        var (resultData, batchedResultShape) = await RunBatch(inputData, [1, .. inputShape]);  // Add batch dimension
+        return (resultData, batchedResultShape[1..]);  // Remove batch dimension
+    }
 
-    public Task<(float[] OutputData, int[] OutputShape)> Run(float[] inputData, int[] inputShape) =>
+    // Output is rented from the tensor pool
+    private Task<(float[] OutputData, int[] OutputShape)> RunBatch(float[] batchedInputData, int[] batchedInputShape) =>
         _threadPool.Run(() =>
         {
-            var batchedInputShape = new[] { 1 }.Concat(inputShape).ToArray(); // Add batch dimension
-            var (resultData, batchedResultShape) = _inferenceKernel.Execute(inputData, batchedInputShape);
-            var resultShape = batchedResultShape[1..]; // Remove batch dimension
-            return (resultData, resultShape);
+            var outputShape = _inferenceKernel.OutputShape(batchedInputShape);
+            var outputData = _tensorPool.Rent(outputShape);
+            try
+            {
+                var start = _stageTimings.Start();
+                _inferenceKernel.Execute(batchedInputData, batchedInputShape, outputData);
+                _stageTimings.Record(PipelineStage.Inference, start, _model);
+            }
+            catch
+            {
+                _tensorPool.Return(outputData);
+                throw;
+            }
+            return (outputData, outputShape);
         }, _model);
 
     public async ValueTask DisposeAsync()
     {
-        _threadPool.Dispose();
+        if (_batcher != null)
+            await _batcher.DisposeAsync();
 
         GC.SuppressFinalize(this);
     }
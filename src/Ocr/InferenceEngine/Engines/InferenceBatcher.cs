@@ -0,0 +1,241 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Diagnostics;
+using System.Threading.Channels;
+
+namespace SpeedReader.Ocr.InferenceEngine.Engines;
+
+// Coalesces concurrent single-item requests into one batched kernel call. Only requests with identical shapes are
+// batched together; a request with a different shape closes the current batch and starts the next one. Batch buffers
+// and per-request outputs are rented from the tensor pool
+public class InferenceBatcher : IAsyncDisposable
+{
+    private readonly Func<float[], int[], Task<(float[] OutputData, int[] OutputShape)>> _runBatch;
+    private readonly TensorPool _tensorPool;
+    private readonly Channel<PendingRequest> _pending = Channel.CreateUnbounded<PendingRequest>(
+        new UnboundedChannelOptions { SingleReader = true });
+    private readonly SemaphoreSlim _inFlightBatches;
+    private readonly Lock _resizeLock = new();
+    private int _maxInFlightBatches;
+    private int _excessInFlightBatches;  // Running past a lowered max, their slots are dropped instead of released
+    private bool _disposing;
+    private readonly int _maxBatchSize;
+    private readonly long _maxWaitTicks;
+    private readonly Task _collector;
+
+    // runBatch receives inputs with a leading batch dimension and must return outputs batched the same way
+    public InferenceBatcher(Func<float[], int[], Task<(float[] OutputData, int[] OutputShape)>> runBatch,
+        int maxBatchSize, int maxBatchWaitMicroseconds, int maxInFlightBatches, TensorPool? tensorPool = null)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(maxBatchSize, 1, nameof(maxBatchSize));
+        ArgumentOutOfRangeException.ThrowIfLessThan(maxBatchWaitMicroseconds, 0, nameof(maxBatchWaitMicroseconds));
+        ArgumentOutOfRangeException.ThrowIfLessThan(maxInFlightBatches, 1, nameof(maxInFlightBatches));
+
+        _runBatch = runBatch;
+        _tensorPool = tensorPool ?? TensorPool.Shared;
+        _maxBatchSize = maxBatchSize;
+        _maxWaitTicks = maxBatchWaitMicroseconds * Stopwatch.Frequency / 1_000_000;
+        _maxInFlightBatches = maxInFlightBatches;
+        _inFlightBatches = new SemaphoreSlim(maxInFlightBatches);
+        _collector = Task.Run(Collect);
+    }
+
+    // Batches running at once. Raising it frees slots right away, lowering it takes effect as running batches finish
+    public int MaxInFlightBatches
+    {
+        get => Volatile.Read(ref _maxInFlightBatches);
+        set
+        {
+            ArgumentOutOfRangeException.ThrowIfLessThan(value, 1, nameof(value));
+            lock (_resizeLock)
+            {
+                if (_disposing || value == _maxInFlightBatches)
+                    return;
+
+                var change = value - _maxInFlightBatches;
+                Volatile.Write(ref _maxInFlightBatches, value);
+                if (change > 0)
+                {
+                    var cancelled = Math.Min(change, _excessInFlightBatches);
+                    _excessInFlightBatches -= cancelled;
+                    if (change > cancelled)
+                        _inFlightBatches.Release(change - cancelled);
+                }
+                else
+                {
+                    // Free slots go first, any left over are dropped as running batches finish
+                    while (change < 0 && _inFlightBatches.Wait(0))
+                        change++;
+                    _excessInFlightBatches += -change;
+                }
+            }
+        }
+    }
+
+    public Task<(float[] OutputData, int[] OutputShape)> Run(float[] inputData, int[] inputShape)
+    {
+        var request = new PendingRequest(inputData, inputShape);
+        if (!_pending.Writer.TryWrite(request))
+            throw new ObjectDisposedException(nameof(InferenceBatcher));
+        return request.Completion.Task;
+    }
+
+    private async Task Collect()
+    {
+        var reader = _pending.Reader;
+        PendingRequest? carry = null;
+
+        while (true)
+        {
+            // Wait for a free batch slot before forming the next batch. While every slot is busy, requests pile up
+            // in the channel, so batches grow with load instead of being dispatched one item at a time
+            await _inFlightBatches.WaitAsync();
+
+            var first = carry;
+            carry = null;
+            if (first == null)
+            {
+                if (!await reader.WaitToReadAsync() || !reader.TryRead(out first))
+                {
+                    ReleaseSlot();
+                    return;
+                }
+            }
+
+            var batch = new List<PendingRequest>(_maxBatchSize) { first };
+            var deadline = Stopwatch.GetTimestamp() + _maxWaitTicks;
+            CancellationTokenSource? wait = null;
+
+            try
+            {
+                while (batch.Count < _maxBatchSize)
+                {
+                    if (reader.TryRead(out var next))
+                    {
+                        if (!next.InputShape.AsSpan().SequenceEqual(first.InputShape))
+                        {
+                            carry = next;
+                            break;
+                        }
+                        batch.Add(next);
+                        continue;
+                    }
+
+                    // One timer per batch, armed the first time the channel runs dry. Timers tick in whole
+                    // milliseconds, so sub-millisecond waits round up to one rather than spinning a core
+                    if (wait == null)
+                    {
+                        var remaining = deadline - Stopwatch.GetTimestamp();
+                        if (remaining <= 0)
+                            break;
+                        var milliseconds = Math.Max(1, (remaining * 1000 + Stopwatch.Frequency - 1) / Stopwatch.Frequency);
+                        wait = new CancellationTokenSource(TimeSpan.FromMilliseconds(milliseconds));
+                    }
+
+                    try
+                    {
+                        if (!await reader.WaitToReadAsync(wait.Token))
+                            break;
+                    }
+                    catch (OperationCanceledException)
+                    {
+                        break;
+                    }
+                }
+            }
+            finally
+            {
+                wait?.Dispose();
+            }
+
+            _ = Dispatch(batch);
+        }
+    }
+
+    private async Task Dispatch(List<PendingRequest> batch)
+    {
+        try
+        {
+            var itemShape = batch[0].InputShape;
+            var itemLength = batch[0].InputData.Length;
+            var batchedInput = _tensorPool.Rent(itemLength * batch.Count);
+            for (var i = 0; i < batch.Count; i++)
+                batch[i].InputData.CopyTo(batchedInput, i * itemLength);
+
+            try
+            {
+                var (batchedOutput, batchedOutputShape) = await _runBatch(batchedInput, [batch.Count, .. itemShape]);
+
+                var outputShape = batchedOutputShape[1..];  // Remove batch dimension
+                var outputLength = batchedOutput.Length / batch.Count;
+                for (var i = 0; i < batch.Count; i++)
+                {
+                    var output = _tensorPool.Rent(outputLength);
+                    batchedOutput.AsSpan(i * outputLength, outputLength).CopyTo(output);
+                    batch[i].Completion.TrySetResult((output, outputShape));
+                }
+
+                if (!ReferenceEquals(batchedOutput, batchedInput))
+                    _tensorPool.Return(batchedOutput);
+            }
+            finally
+            {
+                _tensorPool.Return(batchedInput);
+            }
+        }
+        catch (Exception ex)
+        {
+            foreach (var request in batch)
+                request.Completion.TrySetException(ex);
+        }
+        finally
+        {
+            ReleaseSlot();
+        }
+    }
+
+    private void ReleaseSlot()
+    {
+        lock (_resizeLock)
+        {
+            if (_excessInFlightBatches > 0)
+                _excessInFlightBatches--;
+            else
+                _inFlightBatches.Release();
+        }
+    }
+
+    public async ValueTask DisposeAsync()
+    {
+        _pending.Writer.TryComplete();
+        await _collector;
+
+        // Drain batches that are still running. Every slot comes back once they have, excess ones are dropped
+        int maxInFlightBatches;
+        lock (_resizeLock)
+        {
+            _disposing = true;
+            maxInFlightBatches = _maxInFlightBatches;
+        }
+        for (var i = 0; i < maxInFlightBatches; i++)
+            await _inFlightBatches.WaitAsync();
+        _inFlightBatches.Dispose();
+
+        GC.SuppressFinalize(this);
+    }
+
+    private class PendingRequest
+    {
+        public PendingRequest(float[] inputData, int[] inputShape)
+        {
+            InputData = inputData;
+            InputShape = inputShape;
+        }
+
+        public float[] InputData { get; }
+        public int[] InputShape { get; }
+        public TaskCompletionSource<(float[] OutputData, int[] OutputShape)> Completion { get; } =
+            new(TaskCreationOptions.RunContinuationsAsynchronously);
+    }
+}
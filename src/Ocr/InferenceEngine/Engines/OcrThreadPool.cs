@@ -3,7 +3,10 @@
 
 using System.Collections.Concurrent;
 using System.Diagnostics;
+using System.Diagnostics.Metrics;
+using Microsoft.Extensions.DependencyInjection;
 using SpeedReader.Native.Threading;
+using SpeedReader.Ocr.SmartMetrics;
 
 namespace SpeedReader.Ocr.InferenceEngine.Engines;
 
@@ -11,16 +14,91 @@ public class Topology
 {
     public required int[] PCores { get; init; }
     public required int[] ECores { get; init; }
+
+    // Cores listed in the config are used as given, minus any the process can't run on; lists left empty are filled
+    // from the discovered topology. Either way there is at most one runner per CPU the cgroup quota allows, P-cores
+    // first
+    public static Topology Resolve(CpuEngineConfig config, CpuTopology discovered) => Resolve([config], discovered);
+
+    // Engines sharing a pool merge their core lists
+    public static Topology Resolve(IReadOnlyCollection<CpuEngineConfig> configs, CpuTopology discovered)
+    {
+        var usable = discovered.Cpus.Select(cpu => cpu.Id).ToHashSet();
+
+        var configuredPCores = configs.SelectMany(config => config.ReservedPCores.Concat(config.UnreservedPCores));
+        var pCores = configuredPCores.Distinct().Where(usable.Contains).ToArray();
+        if (pCores.Length == 0)
+            pCores = discovered.PerformanceCores;
+
+        var configuredECores = configs.SelectMany(config => config.ECores).ToList();
+        var eCores = configuredECores.Count > 0
+            ? configuredECores.Distinct().Where(usable.Contains).Except(pCores).ToArray()
+            : discovered.EfficiencyCores.Except(pCores).ToArray();
+
+        // Machines without performance cores still need somewhere to run DBNet
+        if (pCores.Length == 0)
+            (pCores, eCores) = (eCores, []);
+
+        var limit = discovered.MaxConcurrency;
+        pCores = pCores[..Math.Min(pCores.Length, limit)];
+        eCores = eCores[..Math.Min(eCores.Length, limit - pCores.Length)];
+
+        return new Topology { PCores = pCores, ECores = eCores };
+    }
 }
 
 public class OcrThreadPool : IDisposable
 {
-    private readonly VIPQueue<AffinitizedRunner> _dbnetPowerWorkers = new(3);
-    private readonly VIPQueue<AffinitizedRunner> _svtrPowerWorkers = new(3);
-    private readonly VIPQueue<AffinitizedRunner> _svtrEffWorkers = new(3);  // All users of this queue have vip == 0
-    private readonly List<AffinitizedRunner> _allRunners = [];
+    // Runners are grouped into affinity classes. Each runner has its own lock-free job queues and steals from the
+    // rest of its class when they run dry. DBNet jobs stay on DBNet P-cores; SVTR jobs run anywhere, preferring (in
+    // order) an E-core, a non-DBNet P-core, then a DBNet P-core that has no DBNet work
+    private readonly Lock _rebalanceLock = new();
+    private AffinitizedRunner[] _dbnetPowerRunners;  // Copy-on-write, swapped under _rebalanceLock
+    private AffinitizedRunner[] _svtrPowerRunners;
+    private readonly AffinitizedRunner[] _effRunners;
+    private readonly AffinitizedRunner[] _allRunners;
+    private readonly int _pCoreCount;
+    private readonly int _eCoreCount;
+    private readonly QueueTracker _dbnetQueue;
+    private readonly QueueTracker _svtrQueue;
+    private readonly WorkerRebalancer? _rebalancer;
+    private uint _nextDbNetRunner;
+    private uint _nextSvtrRunner;
+    private int _disposed;
 
-    public OcrThreadPool(Topology topology, int startingDbNetWorkers)
+    public static OcrThreadPool Factory(IServiceProvider serviceProvider)
+    {
+        var detection = serviceProvider.GetKeyedService<CpuEngineConfig>(Model.DbNet);
+        var recognition = serviceProvider.GetKeyedService<CpuEngineConfig>(Model.Svtr);
+        var cpuTopology = serviceProvider.GetService<CpuTopology>() ?? CpuTopology.Current;
+        var rebalancing = serviceProvider.GetService<RebalancingOptions>();
+        var meterFactory = serviceProvider.GetService<IMeterFactory>();
+        var stageTimings = serviceProvider.GetService<StageTimings>();
+
+        CpuEngineConfig[] configs = [.. new[] { detection, recognition }.OfType<CpuEngineConfig>()];
+        var topology = Topology.Resolve(configs, cpuTopology);
+
+        // Split P-cores evenly when both models are served and let the rebalancer adjust from there
+        var startingDbNetWorkers = (detection, recognition) switch
+        {
+            (null, _) => 0,
+            (_, null) => topology.PCores.Length,
+            _ => (topology.PCores.Length + 1) / 2
+        };
+        var rebalance = detection != null && recognition != null ? rebalancing : null;
+
+        return new OcrThreadPool(topology, startingDbNetWorkers, rebalance, meterFactory, stageTimings);
+    }
+
+    public OcrThreadPool(Topology topology, int startingDbNetWorkers, RebalancingOptions? rebalancing = null,
+        IMeterFactory? meterFactory = null, StageTimings? stageTimings = null)
+        : this(topology, startingDbNetWorkers, rebalancing, meterFactory, stageTimings, startRunners: true)
+    {
+    }
+
+    // Without started runners, tests place jobs with Enqueue and drive FindJob by hand with RunNext
+    internal OcrThreadPool(Topology topology, int startingDbNetWorkers, RebalancingOptions? rebalancing,
+        IMeterFactory? meterFactory, StageTimings? stageTimings, bool startRunners)
     {
         ArgumentOutOfRangeException.ThrowIfLessThan(startingDbNetWorkers, 0, nameof(startingDbNetWorkers));
         if (startingDbNetWorkers > topology.PCores.Length)
@@ -29,52 +107,112 @@ public class OcrThreadPool : IDisposable
                 $"Requested {startingDbNetWorkers} workers, {topology.PCores.Length} available");
         }
 
-        foreach (var core in topology.PCores[..startingDbNetWorkers])
-        {
-            var runner = new AffinitizedRunner(core);
-            _allRunners.Add(runner);
-            _dbnetPowerWorkers.Enqueue(runner);
-        }
+        _pCoreCount = topology.PCores.Length;
+        _eCoreCount = topology.ECores.Length;
+        _dbnetQueue = new QueueTracker(stageTimings ?? StageTimings.Disabled, Model.DbNet);
+        _svtrQueue = new QueueTracker(stageTimings ?? StageTimings.Disabled, Model.Svtr);
 
-        foreach (var core in topology.PCores[startingDbNetWorkers..])
+        _dbnetPowerRunners = [.. topology.PCores[..startingDbNetWorkers].Select(core => new AffinitizedRunner(this, core, RunnerClass.DbNetPower))];
+        _svtrPowerRunners = [.. topology.PCores[startingDbNetWorkers..].Select(core => new AffinitizedRunner(this, core, RunnerClass.SvtrPower))];
+        _effRunners = [.. topology.ECores.Select(core => new AffinitizedRunner(this, core, RunnerClass.Efficiency))];
+        _allRunners = [.. _dbnetPowerRunners, .. _svtrPowerRunners, .. _effRunners];
+        if (startRunners)
         {
-            var runner = new AffinitizedRunner(core);
-            _allRunners.Add(runner);
-            _svtrPowerWorkers.Enqueue(runner);
+            foreach (var runner in _allRunners)
+                runner.Start();
         }
 
-        foreach (var core in topology.ECores)
+        if (rebalancing is { Enabled: true })
+            _rebalancer = new WorkerRebalancer(this, rebalancing, meterFactory);
+
+        if (meterFactory != null)
         {
-            var runner = new AffinitizedRunner(core);
-            _allRunners.Add(runner);
-            _svtrEffWorkers.Enqueue(runner);
+            var meter = meterFactory.Create(WorkerRebalancer.MeterName);
+            meter.CreateObservableGauge($"{WorkerRebalancer.MeterName}.runner_utilization", SampleUtilization, "1",
+                "Fraction of the time since the last sample each runner spent executing jobs");
         }
     }
 
-    public async Task<T> RunDbNet<T>(Func<T> func)
+    // Number of runners that can execute the model at once. DBNet only runs on P-cores, SVTR runs anywhere
+    public int Capacity(Model model) => model switch
+    {
+        Model.DbNet => _pCoreCount,
+        Model.Svtr => _pCoreCount + _eCoreCount,
+        _ => throw new ArgumentException($"Unknown model {model}")
+    };
+
+    // Current split of P-cores between the models. SVTR also borrows idle DBNet P-cores
+    public int DbNetPowerWorkers => Volatile.Read(ref _dbnetPowerRunners).Length;
+    public int SvtrPowerWorkers => _pCoreCount - DbNetPowerWorkers;
+
+    // Depth is the number of jobs waiting for a runner right now, wait is averaged over jobs that started since the
+    // last sample
+    public (QueueSample DbNet, QueueSample Svtr) SampleQueues() => (_dbnetQueue.Sample(), _svtrQueue.Sample());
+
+    // Jobs waiting for a runner right now. Unlike SampleQueues, doesn't reset the rebalancer's wait averages
+    public int QueueDepth(Model model) => model switch
+    {
+        Model.DbNet => _dbnetQueue.Depth,
+        Model.Svtr => _svtrQueue.Depth,
+        _ => throw new ArgumentException($"Unknown model {model}")
+    };
+
+    public Task<T> RunDbNet<T>(Func<T> func)
     {
-        var thread = await _dbnetPowerWorkers.DequeueAsync(1);
-        try
+        ThrowIfDisposed();
+        var runners = Volatile.Read(ref _dbnetPowerRunners);
+        if (runners.Length == 0)
+            throw new InvalidOperationException("No P-cores are assigned to DBNet");
+        var job = new Job<T>(func, _dbnetQueue);
+
+        // Hand the job straight to an idle DBNet runner, else queue it round-robin and make sure someone steals it
+        if (TryClaimIdle(runners) is { } idle)
         {
-            return await thread.Run(func);
+            idle.DbNetJobs.Enqueue(job);
+            idle.Wake();
         }
-        finally
+        else
         {
-            _dbnetPowerWorkers.Enqueue(thread);
+            var index = Interlocked.Increment(ref _nextDbNetRunner) % (uint)runners.Length;
+            runners[index].DbNetJobs.Enqueue(job);
+            TryClaimIdle(runners)?.Wake();
         }
+
+        return job.Task;
     }
 
-    public async Task<T> RunSvtr<T>(Func<T> func)
+    public Task<T> RunSvtr<T>(Func<T> func)
     {
-        var (thread, threadQueue) = await GetSvtrThread();
-        try
+        ThrowIfDisposed();
+        var job = new Job<T>(func, _svtrQueue);
+        var dbnetRunners = Volatile.Read(ref _dbnetPowerRunners);
+        var svtrRunners = Volatile.Read(ref _svtrPowerRunners);
+
+        if ((TryClaimIdle(_effRunners) ?? TryClaimIdle(svtrRunners) ?? TryClaimIdle(dbnetRunners)) is { } idle)
         {
-            return await thread.Run(func);
+            idle.SvtrJobs.Enqueue(job);
+            idle.Wake();
         }
-        finally
+        else
         {
-            threadQueue.Enqueue(thread);
+            // Queue on SVTR's own cores when there are any, every runner steals SVTR work once it's out of its own
+            AffinitizedRunner target;
+            var index = Interlocked.Increment(ref _nextSvtrRunner);
+            var homeCount = _effRunners.Length + svtrRunners.Length;
+            if (homeCount == 0)
+            {
+                target = dbnetRunners[index % (uint)dbnetRunners.Length];
+            }
+            else
+            {
+                var i = (int)(index % (uint)homeCount);
+                target = i < _effRunners.Length ? _effRunners[i] : svtrRunners[i - _effRunners.Length];
+            }
+            target.SvtrJobs.Enqueue(job);
+            (TryClaimIdle(_effRunners) ?? TryClaimIdle(svtrRunners) ?? TryClaimIdle(dbnetRunners))?.Wake();
         }
+
+        return job.Task;
     }
 
     public Task<T> Run<T>(Func<T> func, Model model) => model switch
@@ -84,138 +222,302 @@ public class OcrThreadPool : IDisposable
         _ => throw new ArgumentException($"Unknown model {model}")
     };
 
-    public async Task RebalanceDbNet2Svtr()
-    {
-        var dbnetThread = await _dbnetPowerWorkers.DequeueAsync(2);
-        _svtrPowerWorkers.Enqueue(dbnetThread);
-    }
+    // Moves one P-core between the DBNet and SVTR classes. The runner finishes any DBNet jobs already queued on it,
+    // so DBNet work never lands on an E-core. Returns false if there was no runner to move
+    public bool RebalanceDbNet2Svtr() => MoveRunner(ref _dbnetPowerRunners, ref _svtrPowerRunners, RunnerClass.SvtrPower);
+
+    public bool RebalanceSvtr2DbNet() => MoveRunner(ref _svtrPowerRunners, ref _dbnetPowerRunners, RunnerClass.DbNetPower);
 
-    public async Task RebalanceSvtr2DbNet()
+    private bool MoveRunner(ref AffinitizedRunner[] from, ref AffinitizedRunner[] to, RunnerClass newClass)
     {
-        var svtrThread = await _svtrPowerWorkers.DequeueAsync(2);
-        _dbnetPowerWorkers.Enqueue(svtrThread);
+        lock (_rebalanceLock)
+        {
+            if (from.Length == 0)
+                return false;
+            var runner = from[^1];
+            runner.Class = newClass;
+            Volatile.Write(ref to, [.. to, runner]);
+            Volatile.Write(ref from, from[..^1]);
+            return true;
+        }
     }
 
-    // Best-effort returns (in preference order) E-core, non-DbNet P-core, DbNet P-core
-    private async Task<(AffinitizedRunner, VIPQueue<AffinitizedRunner>)> GetSvtrThread()
+    private static AffinitizedRunner? TryClaimIdle(AffinitizedRunner[] runners)
     {
-        // queues[i], cancellations[i], dequeueTasks[i]
-        VIPQueue<AffinitizedRunner>[] queues = [_svtrEffWorkers, _svtrPowerWorkers, _dbnetPowerWorkers];  // Order matters!
-        var cancellations = new CancellationTokenSource[queues.Length];
-        var dequeueTasks = new Task<AffinitizedRunner>[queues.Length];
-        for (var i = 0; i < queues.Length; i++)
+        foreach (var runner in runners)
         {
-            cancellations[i] = new CancellationTokenSource();
-            dequeueTasks[i] = queues[i].DequeueAsync(0, cancellations[i].Token);
+            if (runner.TryClaim())
+                return runner;
         }
+        return null;
+    }
+
+    // Runners are tagged with the class they're in now, so a rebalanced core moves to another series
+    private IEnumerable<Measurement<double>> SampleUtilization() => _allRunners.Select(runner =>
+        new Measurement<double>(runner.SampleUtilization(), new("core", runner.Core), new("class", runner.Class switch
+        {
+            RunnerClass.DbNetPower => "dbnet_power",
+            RunnerClass.SvtrPower => "svtr_power",
+            _ => "efficiency"
+        })));
+
+    // Test hooks. Runners are indexed DBNet P-cores first, then SVTR P-cores, then E-cores, as at construction
+    internal Action? OnIdlePublished { get; set; }  // Runs on the runner thread between publishing idle and the recheck
+
+    internal Task<T> Enqueue<T>(int runner, Model model, Func<T> func)
+    {
+        var job = new Job<T>(func, model == Model.DbNet ? _dbnetQueue : _svtrQueue);
+        (model == Model.DbNet ? _allRunners[runner].DbNetJobs : _allRunners[runner].SvtrJobs).Enqueue(job);
+        return job.Task;
+    }
+
+    internal bool RunNext(int runner)
+    {
+        if (FindJob(_allRunners[runner]) is not { } job)
+            return false;
+        job.Execute();
+        return true;
+    }
+
+    private void ThrowIfDisposed() => ObjectDisposedException.ThrowIf(Volatile.Read(ref _disposed) != 0, this);
+
+    // Called by runner threads: own queues first, then steal. Jobs on a runner's own DBNet queue run first even
+    // after it moved class, nobody else would pick them up
+    private IRunnerJob? FindJob(AffinitizedRunner runner)
+    {
+        if (runner.DbNetJobs.TryDequeue(out var job))
+            return job;
+        if (runner.Class == RunnerClass.DbNetPower && Steal(Volatile.Read(ref _dbnetPowerRunners), runner, dbnet: true) is { } stolen)
+            return stolen;
+        if (runner.SvtrJobs.TryDequeue(out job))
+            return job;
 
-        // Wait for any (at least one) dequeue task to complete
-        await Task.WhenAny(dequeueTasks);
+        // Steal within the class first to stay cache-warm, then from the other classes
+        AffinitizedRunner[] own = runner.Class switch
+        {
+            RunnerClass.DbNetPower => Volatile.Read(ref _dbnetPowerRunners),
+            RunnerClass.SvtrPower => Volatile.Read(ref _svtrPowerRunners),
+            _ => _effRunners
+        };
+        return Steal(own, runner, dbnet: false)
+            ?? (runner.Class != RunnerClass.Efficiency ? Steal(_effRunners, runner, dbnet: false) : null)
+            ?? (runner.Class != RunnerClass.SvtrPower ? Steal(Volatile.Read(ref _svtrPowerRunners), runner, dbnet: false) : null)
+            ?? (runner.Class != RunnerClass.DbNetPower ? Steal(Volatile.Read(ref _dbnetPowerRunners), runner, dbnet: false) : null);
+    }
 
-        // chosenThread and chosenThreadQueue are mutated by Step
-        AffinitizedRunner? chosenThread = null;
-        VIPQueue<AffinitizedRunner>? chosenThreadQueue = null;
+    // Starts at the thief's own position so thieves don't all pile onto the first victim
+    private static IRunnerJob? Steal(AffinitizedRunner[] victims, AffinitizedRunner thief, bool dbnet)
+    {
+        for (var i = 0; i < victims.Length; i++)
+        {
+            var victim = victims[(thief.Core + i) % victims.Length];
+            if (victim == thief)
+                continue;
+            var queue = dbnet ? victim.DbNetJobs : victim.SvtrJobs;
+            if (queue.TryDequeue(out var job))
+                return job;
+        }
+        return null;
+    }
 
-        // Pick the first completed dequeue task we find; cancel all others, if they've already completed just put them back
-        for (var i = 0; i < queues.Length; i++)
-            await Step(i);
+    private enum RunnerClass
+    {
+        DbNetPower,
+        SvtrPower,
+        Efficiency
+    }
 
-        Debug.Assert(chosenThread != null && chosenThreadQueue != null);
+    private interface IRunnerJob
+    {
+        void Execute();
+    }
 
-        foreach (var cts in cancellations)
-            cts.Dispose();
+    // The job is its own completion source, one allocation per job
+    private sealed class Job<T> : TaskCompletionSource<T>, IRunnerJob
+    {
+        private readonly Func<T> _func;
+        private readonly QueueTracker _queue;
+        private readonly long _enqueued;
 
-        return (chosenThread, chosenThreadQueue);
+        public Job(Func<T> func, QueueTracker queue) : base(TaskCreationOptions.RunContinuationsAsynchronously)
+        {
+            _func = func;
+            _queue = queue;
+            _enqueued = queue.Enter();
+        }
 
-        async ValueTask Step(int i)
+        public void Execute()
         {
-            var dequeueTask = dequeueTasks[i];
-            var cancellation = cancellations[i];
-            var queue = queues[i];
-            if (chosenThread == null)
+            _queue.Exit(_enqueued);
+            try
             {
-                // If dequeue task is completed and we haven't found a thread yet, assign to output vars
-                Debug.Assert(chosenThreadQueue == null);
-                (chosenThread, chosenThreadQueue) = (dequeueTask.Result, queue);
+                SetResult(_func());
             }
-            else
+            catch (Exception ex)
             {
-                // ReSharper disable once MethodHasAsyncOverload
-                cancellation.Cancel();  // No-op if dequeue task already completed
-                try
-                {
-                    var t = await dequeueTask;
-                    queue.Enqueue(t);  // If dequeue succeeded, put the thread back
-                }
-                catch (OperationCanceledException) { }  // If dequeue was canceled, do nothing
+                SetException(ex);
             }
         }
     }
 
-    private sealed class AffinitizedRunner : IDisposable
+    // Each wait also goes into the queue wait stage histogram
+    private sealed class QueueTracker(StageTimings stageTimings, Model model)
+    {
+        private int _depth;
+        private long _waitTicks;
+        private int _waitCount;
+
+        public int Depth => Volatile.Read(ref _depth);
+
+        public long Enter()
+        {
+            Interlocked.Increment(ref _depth);
+            return Stopwatch.GetTimestamp();
+        }
+
+        public void Exit(long enqueued)
+        {
+            var now = Stopwatch.GetTimestamp();
+            stageTimings.Record(PipelineStage.QueueWait, Stopwatch.GetElapsedTime(enqueued, now), model);
+            Interlocked.Add(ref _waitTicks, now - enqueued);
+            Interlocked.Increment(ref _waitCount);
+            Interlocked.Decrement(ref _depth);
+        }
+
+        // A wait recorded between the two exchanges lands in the next sample's count or ticks, close enough
+        public QueueSample Sample()
+        {
+            var count = Interlocked.Exchange(ref _waitCount, 0);
+            var ticks = Interlocked.Exchange(ref _waitTicks, 0);
+            var wait = count == 0 ? 0 : ticks * 1000.0 / Stopwatch.Frequency / count;
+            return new QueueSample(Volatile.Read(ref _depth), wait);
+        }
+    }
+
+    private sealed class AffinitizedRunner
     {
-        private readonly BlockingCollection<Action> _jobQueue = new();
-        private readonly int _core;
+        private const int SpinIterations = 50;  // Before parking, so back-to-back jobs don't pay for a kernel wakeup
+
+        private readonly OcrThreadPool _pool;
         private readonly Thread _thread;
-        private int _disposed;
+        private readonly ManualResetEventSlim _signal = new(false, spinCount: 0);
+        private int _idle;
+
+        // Busy time, in Stopwatch ticks, of jobs that have finished, and the start of the running one (0 when idle).
+        // Sampling state is only touched by the gauge callback
+        private long _busyTicks;
+        private long _jobStarted;
+        private long _lastSample;
+        private long _lastSampleBusyTicks;
 
-        public AffinitizedRunner(int core)
+        public AffinitizedRunner(OcrThreadPool pool, int core, RunnerClass runnerClass)
         {
             ArgumentOutOfRangeException.ThrowIfLessThan(core, 0, nameof(core));
-            _core = core;
+            _pool = pool;
+            Core = core;
+            Class = runnerClass;
             _thread = new Thread(ThreadProc) { IsBackground = true };
-            _thread.Start();
         }
 
-        public async Task<T> Run<T>(Func<T> func)
+        public int Core { get; }
+        public RunnerClass Class { get; set; }  // Changed by rebalancing, read racily by the runner itself
+        public ConcurrentQueue<IRunnerJob> DbNetJobs { get; } = new();
+        public ConcurrentQueue<IRunnerJob> SvtrJobs { get; } = new();
+
+        public void Start() => _thread.Start();
+
+        // Submitters claim a parked runner before handing it work, so each wakeup is used by exactly one submitter
+        public bool TryClaim() => Volatile.Read(ref _idle) == 1 && Interlocked.CompareExchange(ref _idle, 0, 1) == 1;
+
+        public void Wake() => _signal.Set();
+
+        // The running job's time so far counts too, so a long inference shows as busy instead of idle followed by a
+        // spike. A job that finishes between the two reads is picked up by the next sample
+        public double SampleUtilization()
         {
-            var tcs = new TaskCompletionSource<T>(TaskCreationOptions.RunContinuationsAsynchronously);
-            try
-            {
-                _jobQueue.Add(ExecuteAsync);
-            }
-            catch (InvalidOperationException)
-            {
-                throw new ObjectDisposedException(GetType().FullName);
-            }
+            var now = Stopwatch.GetTimestamp();
+            var started = Volatile.Read(ref _jobStarted);
+            var busy = Volatile.Read(ref _busyTicks) + (started != 0 ? now - started : 0);
+            var utilization = _lastSample == 0 ? 0 : (double)(busy - _lastSampleBusyTicks) / (now - _lastSample);
+            (_lastSample, _lastSampleBusyTicks) = (now, busy);
+            return Math.Clamp(utilization, 0, 1);
+        }
 
-            return await tcs.Task;
+        private void Execute(IRunnerJob job)
+        {
+            var start = Stopwatch.GetTimestamp();
+            Volatile.Write(ref _jobStarted, start);
+            job.Execute();
+            Volatile.Write(ref _jobStarted, 0);
+            Interlocked.Add(ref _busyTicks, Stopwatch.GetTimestamp() - start);
+        }
+
+        private void ThreadProc()
+        {
+            Affinitizer.PinToCore(Core);
 
-            void ExecuteAsync()
+            while (true)
             {
-                try
+                if (TryFind() is { } job)
+                {
+                    Execute(job);
+                    continue;
+                }
+
+                // Publish that we're idle, then look once more: a submitter either sees the flag or we see its job
+                Interlocked.Exchange(ref _idle, 1);
+                _pool.OnIdlePublished?.Invoke();
+                if (_pool.FindJob(this) is { } late)
                 {
-                    var result = func();
-                    tcs.SetResult(result);
+                    Interlocked.Exchange(ref _idle, 0);  // If a submitter claimed us meanwhile, its Wake just spins us once more
+                    Execute(late);
+                    continue;
                 }
-                catch (Exception ex)
+
+                if (Volatile.Read(ref _pool._disposed) != 0)
                 {
-                    tcs.SetException(ex);
+                    // A submitter that claimed us before we cleared the flag is about to hand us a job
+                    if (Interlocked.Exchange(ref _idle, 0) == 1)
+                        return;
+                    _signal.Wait();
+                    _signal.Reset();
+                    continue;
                 }
+
+                _signal.Wait();
+                _signal.Reset();
+                Interlocked.Exchange(ref _idle, 0);
             }
         }
 
-        private void ThreadProc()
+        private IRunnerJob? TryFind()
         {
-            Affinitizer.PinToCore(_core);
-
-            foreach (var action in _jobQueue.GetConsumingEnumerable())
-                action();
+            for (var i = 0; i < SpinIterations; i++)
+            {
+                if (_pool.FindJob(this) is { } job)
+                    return job;
+                Thread.SpinWait(20);
+            }
+            return null;
         }
 
-        public void Dispose()
+        public void Stop()
         {
-            if (Interlocked.Exchange(ref _disposed, 1) == 1)
-                return;
-            _jobQueue.CompleteAdding();
-            _thread.Join();
-            _jobQueue.Dispose();
+            _signal.Set();
+            if (_thread.IsAlive)
+                _thread.Join();
+            _signal.Dispose();
         }
     }
 
     public void Dispose()
     {
+        if (Interlocked.Exchange(ref _disposed, 1) == 1)
+            return;
+        _rebalancer?.Dispose();
+
+        // Runners drain the jobs already queued, then exit instead of parking
         foreach (var runner in _allRunners)
-            runner.Dispose();
+            runner.Stop();
     }
 }
@@ -0,0 +1,158 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Net.Http.Headers;
+using Microsoft.Extensions.DependencyInjection;
+using SpeedReader.Ocr.SmartMetrics;
+
+namespace SpeedReader.Ocr.InferenceEngine.Engines;
+
+// Shards a model's requests across the servers in RemoteEngineConfig.Workers, so one pipeline can use a cluster's
+// cores. Tiles and crops are sent as InferenceWire frames, outputs come back the same way
+public class RemoteEngine : IInferenceEngine
+{
+    private readonly Worker[] _workers;
+    private readonly Model _model;
+    private readonly InferenceBatcher? _batcher;
+    private readonly TensorPool _tensorPool;
+    private readonly StageTimings _stageTimings;
+    private readonly HttpMessageHandler _handler;
+    private readonly bool _ownsHandler;
+    private uint _nextWorker;
+
+    public static RemoteEngine Factory(IServiceProvider serviceProvider, object? key)
+    {
+        var config = serviceProvider.GetRequiredKeyedService<RemoteEngineConfig>(key);
+        var tensorPool = serviceProvider.GetService<TensorPool>();
+        var stageTimings = serviceProvider.GetService<StageTimings>();
+        return new RemoteEngine(config, (Model)key!, tensorPool, stageTimings);
+    }
+
+    // By default all workers share one connection pool. Pass a handler to send requests somewhere else, e.g. in tests
+    public RemoteEngine(RemoteEngineConfig config, Model model, TensorPool? tensorPool = null,
+        StageTimings? stageTimings = null, HttpMessageHandler? handler = null)
+    {
+        _model = model;
+        _tensorPool = tensorPool ?? TensorPool.Shared;
+        _stageTimings = stageTimings ?? StageTimings.Disabled;
+        _ownsHandler = handler == null;
+        _handler = handler ?? new SocketsHttpHandler();
+        var timeout = TimeSpan.FromMilliseconds(config.RequestTimeoutMilliseconds);
+        _workers = [.. config.Workers.Select(address => new Worker(
+            new HttpClient(_handler, disposeHandler: false) { BaseAddress = address, Timeout = timeout },
+            config.WorkerCapacity))];
+
+        // Up to a worker's capacity in batches can be in flight to it, so round trips overlap with its inference. Kept
+        // in step with the capacities workers report
+        if (config.MaxBatchSize > 1)
+            _batcher = new InferenceBatcher(RunBatch, config.MaxBatchSize, config.MaxBatchWaitMicroseconds, CurrentMaxCapacity(), _tensorPool);
+    }
+
+    // Summed over workers, as last reported
+    public int CurrentMaxCapacity() => _workers.Sum(worker => worker.Capacity);
+
+    public async Task<(float[] OutputData, int[] OutputShape)> Run(float[] inputData, int[] inputShape)
+    {
+        if (_batcher != null)
+            return await _batcher.Run(inputData, inputShape);
+
+        var (resultData, batchedResultShape) = await RunBatch(inputData, [1, .. inputShape]);  // Add batch dimension
+        return (resultData, batchedResultShape[1..]);  // Remove batch dimension
+    }
+
+    // Output is rented from the tensor pool. Workers that can't be reached or don't answer in time are skipped in
+    // favour of the next least loaded one; a worker that ran the batch and failed fails it
+    private async Task<(float[] OutputData, int[] OutputShape)> RunBatch(float[] batchedInputData,
+        int[] batchedInputShape)
+    {
+        var frame = InferenceWire.EncodeRequest(_model, batchedInputData, batchedInputShape);
+        var items = batchedInputShape[0];
+
+        Exception? lastFailure = null;
+        foreach (var worker in ByLoad())
+        {
+            try
+            {
+                var start = _stageTimings.Start();
+                var result = await worker.Run(frame, items, _tensorPool);
+                _stageTimings.Record(PipelineStage.Inference, start, _model);
+                if (_batcher != null)
+                    _batcher.MaxInFlightBatches = CurrentMaxCapacity();
+                return result;
+            }
+            catch (Exception ex) when (IsUnreachable(ex))
+            {
+                lastFailure = ex;
+            }
+        }
+
+        throw new HttpRequestException($"No worker could run {_model}", lastFailure);
+    }
+
+    // HttpClient reports its timeout as a TaskCanceledException wrapping a TimeoutException
+    private static bool IsUnreachable(Exception ex) =>
+        ex is HttpRequestException or IOException or TaskCanceledException { InnerException: TimeoutException };
+
+    // Least loaded first. Equal loads are taken in turn, so idle workers share the first requests
+    private Worker[] ByLoad()
+    {
+        var first = (int)(Interlocked.Increment(ref _nextWorker) % (uint)_workers.Length);
+        return [.. _workers[first..].Concat(_workers[..first]).OrderBy(worker => worker.Load)];  // OrderBy is stable
+    }
+
+    public async ValueTask DisposeAsync()
+    {
+        if (_batcher != null)
+            await _batcher.DisposeAsync();
+
+        foreach (var worker in _workers)
+            worker.Dispose();
+        if (_ownsHandler)
+            _handler.Dispose();
+
+        GC.SuppressFinalize(this);
+    }
+
+    private sealed class Worker(HttpClient client, int assumedCapacity) : IDisposable
+    {
+        private int _inFlight;  // Items sent by this engine that haven't come back
+        private int _queueDepth;  // As of the last response
+        private int _capacity = assumedCapacity;
+
+        public int Capacity => Volatile.Read(ref _capacity);
+
+        // Items in flight overlap with the worker's queue once they arrive, but they count for the time on the wire
+        public double Load => (Volatile.Read(ref _inFlight) + Volatile.Read(ref _queueDepth)) / (double)Capacity;
+
+        public async Task<(float[] OutputData, int[] OutputShape)> Run(byte[] frame, int items, TensorPool tensorPool)
+        {
+            Interlocked.Add(ref _inFlight, items);
+            try
+            {
+                using var content = new ByteArrayContent(frame);
+                content.Headers.ContentType = new MediaTypeHeaderValue(InferenceWire.MediaType);
+                using var response = await client.PostAsync(InferenceWire.Path, content);
+
+                // Anything but a frame is a server without the endpoint, or something in the way
+                if (response.Content.Headers.ContentType?.MediaType != InferenceWire.MediaType)
+                {
+                    response.EnsureSuccessStatusCode();
+                    throw new HttpRequestException($"{client.BaseAddress} did not answer with an inference frame");
+                }
+
+                var body = await response.Content.ReadAsByteArrayAsync();
+                var (data, shape, load) = InferenceWire.DecodeResponse(body, tensorPool);
+                Volatile.Write(ref _queueDepth, load.QueueDepth);
+                if (load.Capacity > 0)
+                    Volatile.Write(ref _capacity, load.Capacity);
+                return (data, shape);
+            }
+            finally
+            {
+                Interlocked.Add(ref _inFlight, -items);
+            }
+        }
+
+        public void Dispose() => client.Dispose();
+    }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Diagnostics.Metrics;
+
+namespace SpeedReader.Ocr.InferenceEngine.Engines;
+
+public readonly record struct QueueSample(double Depth, double WaitMilliseconds);
+
+public enum RebalanceDecision
+{
+    Hold,
+    DbNetToSvtr,
+    SvtrToDbNet
+}
+
+// Feedback loop that moves P-cores between DBNet and SVTR as the traffic mix shifts. Text-dense pages back up SVTR,
+// sparse photos back up DBNet
+public sealed class WorkerRebalancer : IDisposable
+{
+    public const string MeterName = "speedreader.inference.cpu";
+
+    private readonly OcrThreadPool _pool;
+    private readonly RebalancingOptions _options;
+    private readonly Counter<long>? _rebalances;
+    private readonly CancellationTokenSource _cts = new();
+    private readonly Task _loop;
+
+    // Smoothed samples, also read by the observable gauges. A torn read only skews one measurement
+    private QueueSample _dbnet;
+    private QueueSample _svtr;
+
+    public WorkerRebalancer(OcrThreadPool pool, RebalancingOptions options, IMeterFactory? meterFactory)
+    {
+        _pool = pool;
+        _options = options;
+
+        if (meterFactory != null)
+        {
+            var meter = meterFactory.Create(MeterName);
+            _rebalances = meter.CreateCounter<long>($"{MeterName}.rebalances", "{move}",
+                "P-cores moved between models by the rebalancer");
+            meter.CreateObservableGauge($"{MeterName}.power_workers", () => new[]
+            {
+                new Measurement<int>(_pool.DbNetPowerWorkers, Tag(Model.DbNet)),
+                new Measurement<int>(_pool.SvtrPowerWorkers, Tag(Model.Svtr))
+            }, "{runner}", "P-core runners assigned to each model");
+            meter.CreateObservableGauge($"{MeterName}.queue_depth", () => new[]
+            {
+                new Measurement<double>(_dbnet.Depth, Tag(Model.DbNet)),
+                new Measurement<double>(_svtr.Depth, Tag(Model.Svtr))
+            }, "{request}", "Smoothed number of requests waiting for a runner");
+            meter.CreateObservableGauge($"{MeterName}.queue_wait", () => new[]
+            {
+                new Measurement<double>(_dbnet.WaitMilliseconds, Tag(Model.DbNet)),
+                new Measurement<double>(_svtr.WaitMilliseconds, Tag(Model.Svtr))
+            }, "ms", "Smoothed time requests waited for a runner");
+        }
+
+        _loop = Task.Run(() => Loop(_cts.Token));
+    }
+
+    private async Task Loop(CancellationToken ct)
+    {
+        using var timer = new PeriodicTimer(TimeSpan.FromMilliseconds(_options.IntervalMilliseconds));
+        var cooldown = 0;
+        try
+        {
+            while (await timer.WaitForNextTickAsync(ct))
+            {
+                var (dbnet, svtr) = _pool.SampleQueues();
+                _dbnet = Smooth(_dbnet, dbnet, _options.Smoothing);
+                _svtr = Smooth(_svtr, svtr, _options.Smoothing);
+
+                if (cooldown > 0)
+                {
+                    cooldown--;
+                    continue;
+                }
+
+                var decision = Decide(_dbnet, _svtr, _pool.DbNetPowerWorkers, _pool.SvtrPowerWorkers, _options);
+                var moved = decision switch
+                {
+                    RebalanceDecision.DbNetToSvtr => _pool.RebalanceDbNet2Svtr(),
+                    RebalanceDecision.SvtrToDbNet => _pool.RebalanceSvtr2DbNet(),
+                    _ => false
+                };
+                if (!moved)
+                    continue;
+
+                _rebalances?.Add(1, new KeyValuePair<string, object?>("direction",
+                    decision == RebalanceDecision.DbNetToSvtr ? "dbnet_to_svtr" : "svtr_to_dbnet"));
+                cooldown = _options.CooldownIntervals;
+            }
+        }
+        catch (OperationCanceledException) when (ct.IsCancellationRequested) { }
+    }
+
+    // A model is starved when requests are queued for it and they wait long past the threshold. P-cores only move
+    // towards a starved model from one that is clearly less loaded, and DBNet never drops below its minimum
+    internal static RebalanceDecision Decide(QueueSample dbnet, QueueSample svtr, int dbnetWorkers, int svtrWorkers,
+        RebalancingOptions options)
+    {
+        if (Starved(dbnet, svtr) && svtrWorkers > 0)
+            return RebalanceDecision.SvtrToDbNet;
+        if (Starved(svtr, dbnet) && dbnetWorkers > options.MinDbNetWorkers)
+            return RebalanceDecision.DbNetToSvtr;
+        return RebalanceDecision.Hold;
+
+        bool Starved(QueueSample starved, QueueSample donor) =>
+            starved.Depth >= 1
+            && starved.Depth > donor.Depth
+            && starved.WaitMilliseconds >= options.WaitThresholdMilliseconds
+            && starved.WaitMilliseconds >= donor.WaitMilliseconds * options.Hysteresis;
+    }
+
+    private static QueueSample Smooth(QueueSample average, QueueSample sample, double alpha) => new(
+        average.Depth + alpha * (sample.Depth - average.Depth),
+        average.WaitMilliseconds + alpha * (sample.WaitMilliseconds - average.WaitMilliseconds));
+
+    private static KeyValuePair<string, object?> Tag(Model model) =>
+        new("model", model == Model.DbNet ? "dbnet" : "svtr");
+
+    public void Dispose()
+    {
+        if (_cts.IsCancellationRequested)
+            return;
+        _cts.Cancel();
+        _loop.Wait();
+        _cts.Dispose();
+    }
+}
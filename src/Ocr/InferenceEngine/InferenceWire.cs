@@ -0,0 +1,166 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Buffers.Binary;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace SpeedReader.Ocr.InferenceEngine;
+
+// What a worker reports with every response: jobs waiting for one of its runners, and how many items it can run at
+// once, both for the model that was asked for
+public readonly record struct WorkerLoad(int QueueDepth, int Capacity);
+
+// Raised on the coordinator when a worker ran the request and failed, as opposed to not being reachable
+public class RemoteInferenceException(string message) : Exception(message);
+
+// Binary frames for RemoteEngine and the server's /api/infer endpoint, little-endian throughout. Tensors are sent as
+// raw floats, so a frame is the tensor plus a few bytes of shape. Floats are copied as is, which assumes both ends are
+// little-endian, as x64 and arm64 are
+//
+//   Request:  version u8, model u8, rank u8, rank x i32 dims, floats
+//   Response: version u8, status u8 (0), queue depth i32, capacity i32, rank u8, rank x i32 dims, floats
+//   Error:    version u8, status u8 (1), UTF-8 message
+public static class InferenceWire
+{
+    public const string Path = "/api/infer";
+    public const string MediaType = "application/x-speedreader-tensor";
+
+    private const byte Version = 1;
+    private const byte StatusOk = 0;
+    private const byte StatusError = 1;
+    private const int MaxRank = 8;
+
+    public static byte[] EncodeRequest(Model model, ReadOnlySpan<float> data, ReadOnlySpan<int> shape)
+    {
+        var frame = new byte[2 + ShapeSize(shape) + data.Length * sizeof(float)];
+        frame[0] = Version;
+        frame[1] = (byte)model;
+        var offset = WriteShape(frame, 2, shape, data.Length);
+        MemoryMarshal.AsBytes(data).CopyTo(frame.AsSpan(offset));
+        return frame;
+    }
+
+    // Data is rented from the tensor pool
+    public static (Model Model, float[] Data, int[] Shape) DecodeRequest(ReadOnlySpan<byte> frame,
+        TensorPool tensorPool)
+    {
+        if (frame.Length < 2 || frame[0] != Version)
+            throw new InvalidDataException("Not an inference request");
+        var model = (Model)frame[1];
+        if (!Enum.IsDefined(model))
+            throw new InvalidDataException($"Unknown model {frame[1]}");
+
+        var shape = ReadShape(frame, 2, out var offset);
+        return (model, ReadData(frame[offset..], shape, tensorPool), shape);
+    }
+
+    // Items all have the same shape, the response's shape is [items.Count, .. itemShape]
+    public static byte[] EncodeResponse(IReadOnlyList<float[]> items, ReadOnlySpan<int> itemShape, WorkerLoad load)
+    {
+        var itemLength = items.Count > 0 ? items[0].Length : 0;
+        int[] shape = [items.Count, .. itemShape];
+        var frame = new byte[10 + ShapeSize(shape) + items.Count * itemLength * sizeof(float)];
+        frame[0] = Version;
+        frame[1] = StatusOk;
+        BinaryPrimitives.WriteInt32LittleEndian(frame.AsSpan(2), load.QueueDepth);
+        BinaryPrimitives.WriteInt32LittleEndian(frame.AsSpan(6), load.Capacity);
+        var offset = WriteShape(frame, 10, shape, items.Count * itemLength);
+        foreach (var item in items)
+        {
+            if (item.Length != itemLength)
+                throw new ArgumentException("Items have different lengths", nameof(items));
+            MemoryMarshal.AsBytes(item.AsSpan()).CopyTo(frame.AsSpan(offset));
+            offset += itemLength * sizeof(float);
+        }
+        return frame;
+    }
+
+    public static byte[] EncodeError(string message)
+    {
+        var frame = new byte[2 + Encoding.UTF8.GetByteCount(message)];
+        frame[0] = Version;
+        frame[1] = StatusError;
+        Encoding.UTF8.GetBytes(message, frame.AsSpan(2));
+        return frame;
+    }
+
+    // Data is rented from the tensor pool. Throws RemoteInferenceException if the frame is an error
+    public static (float[] Data, int[] Shape, WorkerLoad Load) DecodeResponse(ReadOnlySpan<byte> frame,
+        TensorPool tensorPool)
+    {
+        if (frame.Length < 2 || frame[0] != Version)
+            throw new InvalidDataException("Not an inference response");
+        if (frame[1] == StatusError)
+            throw new RemoteInferenceException(Encoding.UTF8.GetString(frame[2..]));
+        if (frame[1] != StatusOk || frame.Length < 10)
+            throw new InvalidDataException("Malformed inference response");
+
+        var load = new WorkerLoad(
+            BinaryPrimitives.ReadInt32LittleEndian(frame[2..]),
+            BinaryPrimitives.ReadInt32LittleEndian(frame[6..]));
+        var shape = ReadShape(frame, 10, out var offset);
+        return (ReadData(frame[offset..], shape, tensorPool), shape, load);
+    }
+
+    private static int ShapeSize(ReadOnlySpan<int> shape) => 1 + shape.Length * sizeof(int);
+
+    private static int WriteShape(Span<byte> frame, int offset, ReadOnlySpan<int> shape, int length)
+    {
+        if (shape.Length > MaxRank)
+            throw new ArgumentException($"Rank {shape.Length} is over the max of {MaxRank}", nameof(shape));
+        if (Length(shape) != length)
+            throw new ArgumentException($"Shape [{string.Join(", ", shape.ToArray())}] does not hold {length} elements");
+
+        frame[offset++] = (byte)shape.Length;
+        foreach (var dim in shape)
+        {
+            BinaryPrimitives.WriteInt32LittleEndian(frame[offset..], dim);
+            offset += sizeof(int);
+        }
+        return offset;
+    }
+
+    private static int[] ReadShape(ReadOnlySpan<byte> frame, int offset, out int end)
+    {
+        if (frame.Length <= offset || frame[offset] > MaxRank)
+            throw new InvalidDataException("Missing or oversized shape");
+        var rank = frame[offset++];
+        if (frame.Length < offset + rank * sizeof(int))
+            throw new InvalidDataException("Truncated shape");
+
+        var shape = new int[rank];
+        long length = 1;
+        for (var i = 0; i < rank; i++)
+        {
+            shape[i] = BinaryPrimitives.ReadInt32LittleEndian(frame[offset..]);
+            length *= shape[i];
+            if (shape[i] < 0 || length > int.MaxValue)
+                throw new InvalidDataException($"Dimension {shape[i]} is negative or too large");
+            offset += sizeof(int);
+        }
+        end = offset;
+        return shape;
+    }
+
+    private static float[] ReadData(ReadOnlySpan<byte> bytes, int[] shape, TensorPool tensorPool)
+    {
+        if (bytes.Length != Length(shape) * sizeof(float))
+        {
+            throw new InvalidDataException(
+                $"Shape [{string.Join(", ", shape)}] needs {Length(shape) * sizeof(float)} bytes, got {bytes.Length}");
+        }
+
+        var data = tensorPool.Rent(shape);
+        bytes.CopyTo(MemoryMarshal.AsBytes(data.AsSpan()));
+        return data;
+    }
+
+    private static long Length(ReadOnlySpan<int> shape)
+    {
+        long length = 1;
+        foreach (var dim in shape)
+            length *= dim;
+        return length;
+    }
+}
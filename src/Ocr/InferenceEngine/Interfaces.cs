@@ -5,6 +5,8 @@ namespace SpeedReader.Ocr.InferenceEngine;
 
 public interface IInferenceEngine : IAsyncDisposable
 {
+    // Output data may be rented from a TensorPool; callers should return it once they're done with it. inputData
+    // belongs to the caller and can be reused once the task completes
     Task<(float[] OutputData, int[] OutputShape)> Run(float[] inputData, int[] inputShape);
     int CurrentMaxCapacity();
 }
@@ -12,5 +14,9 @@ public interface IInferenceEngine : IAsyncDisposable
 public interface IInferenceKernel
 {
     (float[] OutputData, int[] OutputShape) Execute(Memory<float> data, int[] shape);
+
+    // Writes results into a caller-owned buffer of exactly OutputShape(shape) elements
+    void Execute(Memory<float> data, int[] shape, Memory<float> output);
+    int[] OutputShape(int[] inputShape);
 }
 
@@ -1,6 +1,7 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
+using System.Security.Cryptography;
 using Microsoft.Extensions.DependencyInjection;
 using SpeedReader.Native.Onnx;
 using SpeedReader.Resources.CharDict;
@@ -13,6 +14,7 @@ public class NativeOnnxInferenceKernel : IInferenceKernel, IDisposable
     private readonly InferenceSession _session;
     private readonly Model _model;
     private readonly int _vocabSize;
+    private readonly bool _fusedArgmax;
 
     public static NativeOnnxInferenceKernel Factory(IServiceProvider serviceProvider, object? key)
     {
@@ -33,32 +35,61 @@ public class NativeOnnxInferenceKernel : IInferenceKernel, IDisposable
             throw new ArgumentException($"EmbeddedCharDict is required for {_model}", nameof(charDict));
 
         _vocabSize = charDict?.Count ?? 0;
+        _fusedArgmax = _model == Model.Svtr && inferenceOptions.FusedArgmax;
 
         var sessionOptions = new SessionOptions()
             .WithIntraOpThreads(inferenceOptions.NumIntraOpThreads)
             .WithInterOpThreads(inferenceOptions.NumInterOpThreads)
-            .WithProfiling(inferenceOptions.EnableProfiling);
+            .WithProfiling(inferenceOptions.EnableProfiling)
+            .WithOptimizedModelPath(OptimizedModelPath(inferenceOptions, weights));
 
         _session = new InferenceSession(weights.Bytes, sessionOptions);
     }
 
+    // Keyed by a hash of the weights so a new model never loads a stale cache
+    private static string? OptimizedModelPath(OnnxInferenceKernelOptions options, EmbeddedWeights weights)
+    {
+        if (options.ModelCacheDirectory is not { } directory)
+            return null;
+
+        try
+        {
+            Directory.CreateDirectory(directory);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            return null;  // Same as an unwritable cache file, run without it
+        }
+
+        var hash = Convert.ToHexStringLower(SHA256.HashData(weights.Bytes), 0, 8);
+        return Path.Combine(directory, $"{options.Model}_{options.Quantization}_{hash}.ort".ToLowerInvariant());
+    }
+
     public virtual (float[] OutputData, int[] OutputShape) Execute(Memory<float> data, int[] shape)
     {
-        var input = OrtValue.Create(data, shape);
-        var outputShape = CalculateOutputShape(shape);
+        var outputShape = OutputShape(shape);
         var outputData = new float[outputShape.Aggregate(1, (a, b) => a * b)];
-        var output = OrtValue.Create(outputData, outputShape);
-        _session.Run(input, output);
+        Execute(data, shape, outputData);
         return (outputData, outputShape);
     }
 
-    private int[] CalculateOutputShape(int[] inputShape) =>
+    public virtual void Execute(Memory<float> data, int[] shape, Memory<float> output)
+    {
+        var input = OrtValue.Create(data, shape);
+        var outputValue = OrtValue.Create(output, OutputShape(shape));
+        if (_fusedArgmax)
+            _session.RunArgmax(input, outputValue);
+        else
+            _session.Run(input, outputValue);
+    }
+
+    public int[] OutputShape(int[] inputShape) =>
         (_model, inputShape) switch
         {
             // DBNet: [n, 3, h, w] -> [n, h, w]
             (Model.DbNet, [var n, _, var h, var w]) => [n, h, w],
-            // SVTR: [n, 3, 48, w] -> [n, w/8, vocab_size]
-            (Model.Svtr, [var n, _, _, var w]) => [n, w / 8, _vocabSize],
+            // SVTR: [n, 3, 48, w] -> [n, w/8, 2] (index, prob) pairs, or [n, w/8, vocab_size] without FusedArgmax
+            (Model.Svtr, [var n, _, _, var w]) => [n, w / 8, _fusedArgmax ? 2 : _vocabSize],
             _ => throw new ArgumentException($"Unexpected input shape for model {_model}: [{string.Join(", ", inputShape)}]")
         };
 
@@ -3,7 +3,9 @@
 
 using Microsoft.Extensions.DependencyInjection;
 using Microsoft.Extensions.DependencyInjection.Extensions;
+using SpeedReader.Native.Threading;
 using SpeedReader.Ocr.InferenceEngine.Engines;
+using SpeedReader.Ocr.SmartMetrics;
 using SpeedReader.Resources;
 using SpeedReader.Resources.Weights;
 
@@ -17,6 +19,11 @@ public static class Factories
     {
         var key = config.Kernel.Model;
 
+        services.TryAddSingleton(_ => new TensorPool());
+        services.TryAddSingleton(_ => CpuTopology.Discover());
+        services.TryAddSingleton(_ => new RebalancingOptions());
+        services.TryAddSingleton(StageTimings.Factory);
+        services.TryAddSingleton(OcrThreadPool.Factory);  // Shared by both models so P-cores can move between them
         services.TryAddKeyedSingleton(key, GetModelWeights(config.Kernel.Model, config.Kernel.Quantization));
 
         services.AddKeyedSingleton(key, config.Kernel);
@@ -28,7 +35,22 @@ public static class Factories
         return services;
     }
 
-    private static EmbeddedWeights GetModelWeights(Model model, Quantization quantization)
+    // Runs the model on config.Workers instead of in this process
+    public static IServiceCollection AddInferenceEngine(
+        this IServiceCollection services,
+        RemoteEngineConfig config,
+        Model model)
+    {
+        services.TryAddSingleton(_ => new TensorPool());
+        services.TryAddSingleton(StageTimings.Factory);
+
+        services.AddKeyedSingleton(model, config);
+        services.AddKeyedSingleton<IInferenceEngine>(model, RemoteEngine.Factory);
+
+        return services;
+    }
+
+    public static EmbeddedWeights GetModelWeights(Model model, Quantization quantization)
     {
         try
         {
@@ -36,6 +58,8 @@ public static class Factories
             {
                 (Model.DbNet, Quantization.Int8) => EmbeddedWeights.Dbnet_Int8,
                 (Model.Svtr, Quantization.Fp32) => EmbeddedWeights.Svtr_Fp32,
+                // ONNX Runtime's CPU execution provider has no bf16 MatMul or Conv kernels, so a bf16 graph can't be loaded
+                (_, Quantization.Bf16) => throw new UnsupportedModelException($"{model} quantized to {quantization} is not supported on CPU"),
                 _ => throw new UnsupportedModelException($"{model} quantized to {quantization} is not supported")
             };
         }
@@ -0,0 +1,150 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Collections.Concurrent;
+
+namespace SpeedReader.Ocr.InferenceEngine;
+
+// Pool of float buffers keyed by exact element count. Unlike ArrayPool, rented buffers have exactly the requested
+// length, so they can be handed straight to code that relies on Length (OrtValue, CTC decoding, etc.)
+//
+// Contents of a rented buffer are undefined. Returning is optional, a buffer that is never returned is simply
+// collected, but a steady-state pipeline that returns its buffers allocates close to nothing
+//
+// Some lengths depend on the image (detection composites and bands), so the pool holds at most maxPooledBytes in
+// total. A return that doesn't fit evicts buffers from the lengths that were rented least recently, and is dropped if
+// every other length is in more recent use than its own
+public sealed class TensorPool
+{
+    public static TensorPool Shared { get; } = new();
+
+    private readonly ConcurrentDictionary<int, Bucket> _buckets = new();
+    private readonly int _maxBuffersPerLength;
+    private readonly long _maxPooledBytes;
+    private long _pooledBytes;
+    private long _clock;
+
+    public TensorPool(int maxBuffersPerLength = 32, long maxPooledBytes = 256L << 20)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(maxBuffersPerLength, 0, nameof(maxBuffersPerLength));
+        ArgumentOutOfRangeException.ThrowIfNegative(maxPooledBytes, nameof(maxPooledBytes));
+        _maxBuffersPerLength = maxBuffersPerLength;
+        _maxPooledBytes = maxPooledBytes;
+    }
+
+    public long PooledBytes => Interlocked.Read(ref _pooledBytes);
+
+    public float[] Rent(int length)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(length, nameof(length));
+        if (length == 0)
+            return [];
+
+        var bucket = _buckets.GetOrAdd(length, static _ => new Bucket());
+        bucket.LastRented = Interlocked.Increment(ref _clock);
+        if (bucket.TryTake(out var buffer))
+        {
+            Interlocked.Add(ref _pooledBytes, -Bytes(length));
+            return buffer;
+        }
+
+        return GC.AllocateUninitializedArray<float>(length);
+    }
+
+    public float[] Rent(ReadOnlySpan<int> shape)
+    {
+        var length = 1;
+        foreach (var dim in shape)
+            length = checked(length * dim);
+        return Rent(length);
+    }
+
+    // Caller must not touch the buffer after returning it
+    public void Return(float[] buffer)
+    {
+        ArgumentNullException.ThrowIfNull(buffer);
+        if (buffer.Length == 0)
+            return;
+
+        var bytes = Bytes(buffer.Length);
+        if (bytes > _maxPooledBytes)
+            return;
+
+        var bucket = _buckets.GetOrAdd(buffer.Length, static _ => new Bucket());
+        if (Interlocked.Add(ref _pooledBytes, bytes) > _maxPooledBytes && !Evict(bucket))
+        {
+            Interlocked.Add(ref _pooledBytes, -bytes);
+            return;
+        }
+
+        if (!bucket.TryAdd(buffer, _maxBuffersPerLength))
+            Interlocked.Add(ref _pooledBytes, -bytes);
+    }
+
+    public void Return(IEnumerable<float[]> buffers)
+    {
+        foreach (var buffer in buffers)
+            Return(buffer);
+    }
+
+    // Frees buffers from lengths rented less recently than the one being returned to until the pool is back under
+    // budget. Returns false if it can't get there
+    private bool Evict(Bucket returningTo)
+    {
+        while (Interlocked.Read(ref _pooledBytes) > _maxPooledBytes)
+        {
+            var (victimLength, victim) = (0, (Bucket?)null);
+            foreach (var (length, bucket) in _buckets)
+            {
+                if (bucket != returningTo && bucket.Count > 0 && bucket.LastRented < returningTo.LastRented &&
+                    (victim == null || bucket.LastRented < victim.LastRented))
+                {
+                    (victimLength, victim) = (length, bucket);
+                }
+            }
+
+            if (victim == null)
+                return false;
+            if (victim.TryTake(out _))
+                Interlocked.Add(ref _pooledBytes, -Bytes(victimLength));
+        }
+        return true;
+    }
+
+    private static long Bytes(int length) => (long)length * sizeof(float);
+
+    private sealed class Bucket
+    {
+        private readonly ConcurrentQueue<float[]> _buffers = new();
+        private int _count;
+        private long _lastRented;
+
+        public long LastRented
+        {
+            get => Volatile.Read(ref _lastRented);
+            set => Volatile.Write(ref _lastRented, value);
+        }
+
+        public int Count => Volatile.Read(ref _count);
+
+        public bool TryTake(out float[] buffer)
+        {
+            if (!_buffers.TryDequeue(out buffer!))
+                return false;
+            Interlocked.Decrement(ref _count);
+            return true;
+        }
+
+        public bool TryAdd(float[] buffer, int maxCount)
+        {
+            // Drop the buffer if the bucket is full, the GC will collect it
+            if (Interlocked.Increment(ref _count) > maxCount)
+            {
+                Interlocked.Decrement(ref _count);
+                return false;
+            }
+            _buffers.Enqueue(buffer);
+            return true;
+        }
+    }
+}
@@ -2,9 +2,12 @@
 // Licensed under the Apache License, Version 2.0
 
 using System.Diagnostics;
+using System.Diagnostics.CodeAnalysis;
 using System.Threading.Channels;
 using SixLabors.ImageSharp;
 using SixLabors.ImageSharp.PixelFormats;
+using SpeedReader.Ocr.Geometry;
+using SpeedReader.Ocr.SmartMetrics;
 using SpeedReader.Ocr.Visualization;
 
 namespace SpeedReader.Ocr;
@@ -13,85 +16,289 @@ public class OcrPipeline
 {
     private readonly TextDetector _detector;
     private readonly TextRecognizer _recognizer;
-    private readonly TaskPool<OcrPipelineResult> _taskPool;
+    private readonly ITaskPool<OcrPipelineResult> _taskPool;
+    private readonly bool _visualize;
+    private readonly ImageDecoder _decoder;
 
-    public OcrPipeline(TextDetector detector, TextRecognizer recognizer)
+    public OcrPipeline(TextDetector detector, TextRecognizer recognizer, bool visualize = false, ImageDecoder? decoder = null)
+        : this(detector, recognizer, new TaskPool<OcrPipelineResult>(DefaultPoolSize(detector, recognizer)), visualize,
+            decoder)
+    {
+    }
+
+    // For pipelines that share their engines, and so their capacity, with other pipelines
+    public OcrPipeline(TextDetector detector, TextRecognizer recognizer, ITaskPool<OcrPipelineResult> taskPool,
+        bool visualize = false, ImageDecoder? decoder = null)
     {
         _detector = detector;
         _recognizer = recognizer;
-        _taskPool = new TaskPool<OcrPipelineResult>();
-        RightsizePool();
+        _visualize = visualize;
+        _decoder = decoder ?? new ImageDecoder(new DecodeOptions());
+        _taskPool = taskPool;
+    }
+
+    // Repeat images are answered from here without entering the pool. Encoded images are keyed by their bytes, decoded
+    // images by their pixels; images read from paths aren't cached. Ignored when visualizing
+    public ResultCache? ResultCache { get; set; }
+
+    // Times how long images wait to be admitted to the pool. The stages themselves are timed where they run
+    public StageTimings StageTimings { get; init; } = StageTimings.Disabled;
+
+    // Enough images in flight to keep both engines busy
+    public static int DefaultPoolSize(TextDetector detector, TextRecognizer recognizer) =>
+        (int)Math.Ceiling((detector.InferenceEngineCapacity() + recognizer.InferenceEngineCapacity()) * 1.5);
+
+    public IAsyncEnumerable<Result<OcrPipelineResult>> ReadMany(IAsyncEnumerable<string> paths,
+        ReadManyOptions? options = null) =>
+        ReadMany(paths.Select(path => (Func<Task<Task<OcrPipelineResult>>>)(() => ReadOne(path))),
+            options ?? new ReadManyOptions());
+
+    public Task<Task<OcrPipelineResult>> ReadOne(string path) => ReadOne(Image.LoadAsync<Rgb24>(path));
+
+    public IAsyncEnumerable<Result<OcrPipelineResult>> ReadMany(IAsyncEnumerable<Image<Rgb24>> images,
+        ReadManyOptions? options = null) =>
+        ReadMany(images.Select(image => (Func<Task<Task<OcrPipelineResult>>>)(() => ReadOne(image))),
+            options ?? new ReadManyOptions());
+
+    public Task<Task<OcrPipelineResult>> ReadOne(Image<Rgb24> image)
+    {
+        if (ActiveCache is not { } cache)
+            return ReadOne(Task.FromResult(image));
+
+        var key = cache.Key(image);
+        if (cache.TryGet(key, out var cached))
+        {
+            image.Dispose();  // Callers hand over the image, and the result they get back doesn't carry it
+            return Task.FromResult(Task.FromResult(cached));
+        }
+        return Admit(() => AddToCache(cache, key, Process(Task.FromResult(image))));
     }
 
-    private void RightsizePool()
+    // Encoded images (PNG, JPEG, etc.) are decoded inside the pool by the decode stage, off the caller's thread
+    public IAsyncEnumerable<Result<OcrPipelineResult>> ReadMany(IAsyncEnumerable<ReadOnlyMemory<byte>> encodedImages,
+        ReadManyOptions? options = null) =>
+        ReadMany(encodedImages.Select(encoded => (Func<Task<Task<OcrPipelineResult>>>)(() => ReadOne(encoded))),
+            options ?? new ReadManyOptions());
+
+    public Task<Task<OcrPipelineResult>> ReadOne(ReadOnlyMemory<byte> encodedImage)
     {
-        var targetSize = (_detector.InferenceEngineCapacity() + _recognizer.InferenceEngineCapacity()) * 1.5;
-        _taskPool.SetPoolSize((int)Math.Ceiling(targetSize));
+        if (ActiveCache is not { } cache)
+            return Admit(() => Process(encodedImage));
+
+        var key = cache.Key(encodedImage.Span);
+        return cache.TryGet(key, out var cached)
+            ? Task.FromResult(Task.FromResult(cached))
+            : Admit(() => AddToCache(cache, key, Process(encodedImage)));
     }
 
-    public IAsyncEnumerable<Result<OcrPipelineResult>> ReadMany(IAsyncEnumerable<string> paths) =>
-        ReadMany(paths.Select(path => Image.LoadAsync<Rgb24>(path)));
+    // Non-blocking ReadOne. Returns false without queueing anything if the pipeline is at capacity. Cache hits never
+    // need capacity
+    public bool TryReadOne(ReadOnlyMemory<byte> encodedImage, [NotNullWhen(true)] out Task<OcrPipelineResult>? result)
+    {
+        if (ActiveCache is not { } cache)
+            return _taskPool.TryExecute(() => Process(encodedImage), out result);
 
-    public Task<Task<OcrPipelineResult>> ReadOne(string path) => ReadOne(Image.LoadAsync<Rgb24>(path));
+        var key = cache.Key(encodedImage.Span);
+        if (cache.TryGet(key, out var cached))
+        {
+            result = Task.FromResult(cached);
+            return true;
+        }
+        return _taskPool.TryExecute(() => AddToCache(cache, key, Process(encodedImage)), out result);
+    }
+
+    private ResultCache? ActiveCache => _visualize ? null : ResultCache;
+
+    // TryExecute never waits, so only Execute is timed. The task creator runs on admission
+    private Task<Task<OcrPipelineResult>> Admit(Func<Task<OcrPipelineResult>> process)
+    {
+        var enqueued = StageTimings.Start();
+        if (enqueued == 0)
+            return _taskPool.Execute(process);
 
-    public IAsyncEnumerable<Result<OcrPipelineResult>> ReadMany(IAsyncEnumerable<Image<Rgb24>> images) =>
-        ReadMany(images.Select(Task.FromResult));
+        return _taskPool.Execute(() =>
+        {
+            StageTimings.Record(PipelineStage.Admission, enqueued);
+            return process();
+        });
+    }
 
-    public Task<Task<OcrPipelineResult>> ReadOne(Image<Rgb24> image) => ReadOne(Task.FromResult(image));
+    private static async Task<OcrPipelineResult> AddToCache(ResultCache cache, ResultCacheKey key,
+        Task<OcrPipelineResult> processing)
+    {
+        var result = await processing;
+        cache.Add(key, result);
+        return result;
+    }
 
-    private async IAsyncEnumerable<Result<OcrPipelineResult>> ReadMany(IAsyncEnumerable<Task<Image<Rgb24>>> images)
+    // Each item admits one image, into the pool or straight from the cache, and returns its result task
+    private async IAsyncEnumerable<Result<OcrPipelineResult>> ReadMany(
+        IAsyncEnumerable<Func<Task<Task<OcrPipelineResult>>>> admissions, ReadManyOptions options)
     {
-        var processingTasks = Channel.CreateUnbounded<Task<OcrPipelineResult>>();
+        // The producer takes a slot before starting each image, the consumer gives it back once it's done with the
+        // result. That caps decoded images and unconsumed results together, not just what's running in the pool
+        var window = new SemaphoreSlim(options.MaxPending ?? 2 * _taskPool.PoolSize);
+        var stop = new CancellationTokenSource();
+        var stopToken = stop.Token;
+
+        var processingTasks = Channel.CreateUnbounded<Task<OcrPipelineResult>>();  // Bounded by the window
+        var outstanding = 1;  // The producer plus every started task not yet written to processingTasks
 
         var processingTaskStarter = Task.Run(async () =>
         {
             try
             {
-                await foreach (var image in images)
+                await foreach (var admit in admissions.WithCancellation(stopToken))
                 {
-                    await processingTasks.Writer.WriteAsync(await ReadOne(image));
+                    await window.WaitAsync(stopToken);
+                    var task = await admit();
+                    Interlocked.Increment(ref outstanding);
+                    if (options.Ordered)
+                        Emit(task);
+                    else
+                        _ = task.ContinueWith(Emit, CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously,
+                            TaskScheduler.Default);
                 }
             }
+            catch (OperationCanceledException) when (stopToken.IsCancellationRequested)
+            {
+                // Consumer stopped early
+            }
             catch (Exception ex)
             {
-                await processingTasks.Writer.WriteAsync(Task.FromException<OcrPipelineResult>(ex));
+                Interlocked.Increment(ref outstanding);
+                Emit(Task.FromException<OcrPipelineResult>(ex));
             }
             finally
             {
-                processingTasks.Writer.Complete();
+                if (Interlocked.Decrement(ref outstanding) == 0)
+                    processingTasks.Writer.Complete();
             }
         });
 
-        await foreach (var task in processingTasks.Reader.ReadAllAsync())
+        try
         {
-            Result<OcrPipelineResult> result;
-            try
+            await foreach (var task in processingTasks.Reader.ReadAllAsync())
             {
-                result = new Result<OcrPipelineResult>(await task);
-            }
-            catch (Exception ex)
-            {
-                result = new Result<OcrPipelineResult>(ex);
+                Result<OcrPipelineResult> result;
+                try
+                {
+                    result = new Result<OcrPipelineResult>(await task);
+                }
+                catch (Exception ex)
+                {
+                    result = new Result<OcrPipelineResult>(ex);
+                }
+
+                yield return result;
+                window.Release();
             }
 
-            yield return result;
+            await processingTaskStarter;
+        }
+        finally
+        {
+            stop.Cancel();  // Unblocks the producer if the consumer broke out early
         }
 
-        await processingTaskStarter;
+        void Emit(Task<OcrPipelineResult> task)
+        {
+            processingTasks.Writer.TryWrite(task);
+            if (Interlocked.Decrement(ref outstanding) == 0)
+                processingTasks.Writer.Complete();
+        }
     }
 
-    private Task<Task<OcrPipelineResult>> ReadOne(Task<Image<Rgb24>> imageTask)
+    private Task<Task<OcrPipelineResult>> ReadOne(Task<Image<Rgb24>> imageTask) => Admit(() => Process(imageTask));
+
+    private async Task<OcrPipelineResult> Process(ReadOnlyMemory<byte> encodedImage)
     {
-        return _taskPool.Execute(Execute);
+        var detectionSize = _visualize ? null : _decoder.DetectionSize(encodedImage);
+        if (detectionSize == null)
+            return await Process(_decoder.Decode(encodedImage));
 
-        async Task<OcrPipelineResult> Execute()
+        // Detect on a reduced decode. The full image is only decoded once there's text to crop, and its decode overlaps
+        // with the rest of detection
+        var detectionImage = await _decoder.Decode(encodedImage, detectionSize);
+        var fullImage = new Lazy<Task<Image<Rgb24>>>(() => _decoder.Decode(encodedImage));
+        try
         {
-            var vizBuilder = new VizBuilder();
-            var image = await imageTask;
-            var detections = await _detector.Detect(image, vizBuilder);
-            var recognitions = await _recognizer.Recognize(detections, image, vizBuilder);
-            Debug.Assert(detections.Count == recognitions.Count);
-            return new OcrPipelineResult(image, detections, recognitions.ToList(), vizBuilder);
+            return await Process(detectionImage, fullImage);
         }
+        catch
+        {
+            if (fullImage.IsValueCreated)
+                await DisposeWhenDecoded(fullImage.Value);
+            throw;
+        }
+        finally
+        {
+            detectionImage.Dispose();  // The result holds the full image, if any, never the reduced one
+        }
+    }
+
+    private async Task<OcrPipelineResult> Process(Task<Image<Rgb24>> imageTask)
+    {
+        var image = await imageTask;
+        try
+        {
+            return await Process(image, null);
+        }
+        catch
+        {
+            image.Dispose();
+            throw;
+        }
+    }
+
+    // A failed decode has nothing to dispose
+    private static async Task DisposeWhenDecoded(Task<Image<Rgb24>> imageTask)
+    {
+        await imageTask.ConfigureAwait(ConfigureAwaitOptions.SuppressThrowing);
+        if (imageTask.IsCompletedSuccessfully)
+            imageTask.Result.Dispose();
+    }
+
+    // fullImage, if any, is what detections are mapped onto and cropped from. Until it's needed, the detection image
+    // stands in for it
+    private async Task<OcrPipelineResult> Process(Image<Rgb24> detectionImage, Lazy<Task<Image<Rgb24>>>? fullImage)
+    {
+        var vizBuilder = _visualize ? new VizBuilder() : VizBuilder.Disabled;
+        var image = detectionImage;
+
+        // Start recognizing each band of detections while the rest of the image is still in detection
+        var detections = new List<BoundingBox>();
+        var recognitionTasks = new List<Task<List<(string Text, double Confidence)>>>();
+        try
+        {
+            await foreach (var batch in _detector.DetectIncrementally(detectionImage, vizBuilder))
+            {
+                var regions = batch;
+                if (fullImage != null)
+                {
+                    // Each axis is rounded separately when the detection size is picked, so each gets its own scale
+                    image = await fullImage.Value;
+                    var scaleX = (double)image.Width / detectionImage.Width;
+                    var scaleY = (double)image.Height / detectionImage.Height;
+                    regions = batch.Select(region => region.Scale(scaleX, scaleY)).ToList();
+                }
+
+                detections.AddRange(regions);
+                recognitionTasks.Add(_recognizer.Recognize(regions, image, vizBuilder));
+            }
+        }
+        catch
+        {
+            // Recognitions already started still read the image, so let them finish before the caller disposes it
+            await ((Task)Task.WhenAll(recognitionTasks)).ConfigureAwait(ConfigureAwaitOptions.SuppressThrowing);
+            throw;
+        }
+
+        var recognitions = (await Task.WhenAll(recognitionTasks)).SelectMany(batch => batch).ToList();
+        Debug.Assert(detections.Count == recognitions.Count);
+
+        // Without text the full image is never decoded, and the result gets no image rather than the reduced one
+        var resultImage = fullImage is { IsValueCreated: false } ? null : image;
+        return new OcrPipelineResult(resultImage, detections, recognitions, vizBuilder);
     }
 }
@@ -10,14 +10,16 @@ namespace SpeedReader.Ocr;
 
 public record OcrPipelineResult
 {
-    public readonly Image<Rgb24> Image;
+    // Null for results served from a ResultCache, which never decode the image, and when detection ran on a reduced
+    // decode and found no text
+    public readonly Image<Rgb24>? Image;
     public readonly List<(BoundingBox BBox, string Text, double Confidence)> Results;
     public readonly VizBuilder VizBuilder;
 
     public List<BoundingBox> Detections;
     public List<(string Text, double Confidence)> Recognitions;
 
-    public OcrPipelineResult(Image<Rgb24> image, List<BoundingBox> detections, List<(string Text, double Confidence)> recognitions, VizBuilder vizBuilder)
+    public OcrPipelineResult(Image<Rgb24>? image, List<BoundingBox> detections, List<(string Text, double Confidence)> recognitions, VizBuilder vizBuilder)
     {
         Image = image;
         Detections = detections;
@@ -0,0 +1,359 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Collections.Concurrent;
+using System.Diagnostics.CodeAnalysis;
+using System.Diagnostics.Metrics;
+using System.Globalization;
+using System.Runtime.InteropServices;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading.Channels;
+using SixLabors.ImageSharp;
+using SixLabors.ImageSharp.PixelFormats;
+using SpeedReader.Ocr.Geometry;
+using SpeedReader.Ocr.SmartMetrics;
+using SpeedReader.Ocr.Visualization;
+
+namespace SpeedReader.Ocr;
+
+public readonly record struct ResultCacheKey(UInt128 High, UInt128 Low)
+{
+    public override string ToString() => $"{High:x32}{Low:x32}";
+}
+
+// Results of images seen before, so a repeat skips decode, detection and recognition. Keys are SHA-256 rather than a
+// faster non-cryptographic hash because every client of a pipeline shares its cache, and a crafted collision would
+// hand one client another's text. SHA-256 still runs at GB/s with SHA-NI, far ahead of decoding the same bytes. Keys
+// also cover the pipeline's fingerprint, so results from other models or options are misses, and age out of the disk
+// tier like any other entry
+public sealed class ResultCache
+{
+    public const string MeterName = "speedreader.ocr.cache";
+
+    private const uint DiskFormatMagic = 0x31435253;  // "SRC1"
+    private const int MaxPendingDiskWrites = 256;
+
+    private readonly Lock _lock = new();
+    private readonly Dictionary<ResultCacheKey, LinkedListNode<Entry>> _entries = [];
+    private readonly LinkedList<Entry> _lru = [];  // Most recently used first
+    private readonly int _maxEntries;
+    private readonly string? _diskDirectory;
+    private readonly byte[] _fingerprint;
+
+    // Disk writes go through one writer, so a burst of misses can't pile up threads or files. The writer alone owns
+    // the disk order after construction. When it falls behind, new writes are dropped, the entries stay in memory.
+    // Lookups check _onDisk first, so a miss never touches the file system
+    private readonly Channel<Entry>? _pendingWrites;
+    private readonly int _maxDiskEntries;
+    private readonly Queue<ResultCacheKey> _diskOrder = new();  // Oldest written first
+    private readonly ConcurrentDictionary<ResultCacheKey, byte> _onDisk = new();
+
+    private readonly ThroughputGauge? _hits;
+    private readonly ThroughputGauge? _misses;
+    private readonly AvgGauge? _hitRate;
+
+    private sealed record Entry(ResultCacheKey Key, List<BoundingBox> Detections,
+        List<(string Text, double Confidence)> Recognitions);
+
+    // fingerprint identifies what produced the results, see Fingerprint
+    public ResultCache(ResultCacheOptions options, string fingerprint, IMeterFactory? meterFactory = null)
+    {
+        _fingerprint = SHA256.HashData(Encoding.UTF8.GetBytes(fingerprint));
+        _maxEntries = options.MaxEntries;
+        _diskDirectory = options.DiskDirectory;
+        _maxDiskEntries = options.MaxDiskEntries;
+        if (_diskDirectory != null)
+        {
+            Directory.CreateDirectory(_diskDirectory);
+            IndexDisk();
+            _pendingWrites = Channel.CreateBounded<Entry>(new BoundedChannelOptions(MaxPendingDiskWrites)
+            {
+                SingleReader = true,
+                FullMode = BoundedChannelFullMode.DropWrite
+            });
+            _ = Task.Run(WriteLoop);
+        }
+
+        if (meterFactory != null)
+        {
+            var meter = meterFactory.Create(MeterName);
+            _hits = meter.CreateThroughputGauge($"{MeterName}.hits", "{image}/s",
+                "Images served from the result cache");
+            _misses = meter.CreateThroughputGauge($"{MeterName}.misses", "{image}/s", "Images not in the result cache");
+            _hitRate = meter.CreateAvgGauge($"{MeterName}.hit_rate", "1", "Fraction of lookups served from the cache");
+        }
+    }
+
+    // Everything that shapes a pipeline's results: detection and recognition options, the detection size hint, and the
+    // models with a hash of their weights. A remote pipeline can't see its workers' models, only which workers it uses
+    public static string Fingerprint(OcrPipelineOptions options)
+    {
+        var recognition = options.RecognitionOptions;
+        var fingerprint = new StringBuilder()
+            .Append($"{options.DetectionOptions};")
+            .Append($"Recognition [{string.Join(", ", recognition.RecognitionInputWidths)}] x ")
+            .Append($"{recognition.RecognitionInputHeight};")
+            .Append($"MaxDetectionDimension {options.Decode.MaxDetectionDimension};");
+        if (options.RemoteEngine is { } remoteEngine)
+        {
+            fingerprint.Append($"Workers [{string.Join(", ", remoteEngine.Workers)}];");
+        }
+        else
+        {
+            foreach (var kernel in new[] { options.DetectionEngine.Kernel, options.RecognitionEngine.Kernel })
+            {
+                var weights = InferenceEngine.ServiceCollectionExtensions.GetModelWeights(kernel.Model,
+                    kernel.Quantization);
+                var weightsHash = Convert.ToHexStringLower(SHA256.HashData(weights.Bytes));
+                fingerprint.Append($"{kernel.Model} {kernel.Quantization} {weightsHash};");
+            }
+        }
+        return fingerprint.ToString();
+    }
+
+    public ResultCacheKey Key(ReadOnlySpan<byte> encodedImage)
+    {
+        using var hash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+        hash.AppendData(_fingerprint);
+        hash.AppendData([0]);  // Separates encoded keys from pixel keys
+        hash.AppendData(encodedImage);
+        return Finish(hash);
+    }
+
+    // Hashes the pixels, so this still costs a pass over the image but saves detection and recognition
+    public ResultCacheKey Key(Image<Rgb24> image)
+    {
+        using var hash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+        hash.AppendData(_fingerprint);
+        Span<int> header = [1, image.Width, image.Height];
+        hash.AppendData(MemoryMarshal.AsBytes(header));
+        image.ProcessPixelRows(accessor =>
+        {
+            for (var y = 0; y < accessor.Height; y++)
+                hash.AppendData(MemoryMarshal.AsBytes(accessor.GetRowSpan(y)));
+        });
+        return Finish(hash);
+    }
+
+    public bool TryGet(ResultCacheKey key, [NotNullWhen(true)] out OcrPipelineResult? result)
+    {
+        Entry? entry;
+        lock (_lock)
+        {
+            if (_entries.TryGetValue(key, out var node))
+            {
+                _lru.Remove(node);
+                _lru.AddFirst(node);
+            }
+            entry = node?.Value;
+        }
+
+        if (entry == null && TryRead(key, out entry))
+            Insert(entry);  // Promote to memory
+
+        _hitRate?.Record(entry != null ? 1 : 0);
+        if (entry == null)
+        {
+            _misses?.Record();
+            result = null;
+            return false;
+        }
+
+        _hits?.Record();
+        // Callers own the lists they get, so every hit gets its own. There's no image: nothing was decoded
+        result = new OcrPipelineResult(null, [.. entry.Detections], [.. entry.Recognitions], VizBuilder.Disabled);
+        return true;
+    }
+
+    public void Add(ResultCacheKey key, OcrPipelineResult result)
+    {
+        var entry = new Entry(key, [.. result.Detections], [.. result.Recognitions]);
+        Insert(entry);
+        _pendingWrites?.Writer.TryWrite(entry);  // Off the result's completion path
+    }
+
+    private void Insert(Entry entry)
+    {
+        lock (_lock)
+        {
+            if (_entries.Remove(entry.Key, out var existing))
+                _lru.Remove(existing);
+
+            _entries[entry.Key] = _lru.AddFirst(entry);
+            while (_entries.Count > _maxEntries)
+            {
+                _entries.Remove(_lru.Last!.Value.Key);
+                _lru.RemoveLast();
+            }
+        }
+    }
+
+    private static ResultCacheKey Finish(IncrementalHash hash)
+    {
+        Span<byte> digest = stackalloc byte[32];
+        hash.GetHashAndReset(digest);
+        return new ResultCacheKey(MemoryMarshal.Read<UInt128>(digest), MemoryMarshal.Read<UInt128>(digest[16..]));
+    }
+
+    private string EntryPath(ResultCacheKey key) => Path.Combine(_diskDirectory!, $"{key}.bin");
+
+    // Entries left by earlier runs, oldest first, so they're evicted before anything this run writes
+    private void IndexDisk()
+    {
+        var files = new DirectoryInfo(_diskDirectory!).GetFiles("*.bin").OrderBy(file => file.LastWriteTimeUtc);
+        foreach (var file in files)
+        {
+            if (TryParseKey(Path.GetFileNameWithoutExtension(file.Name), out var key) && _onDisk.TryAdd(key, 0))
+                _diskOrder.Enqueue(key);
+        }
+        EvictDisk();
+    }
+
+    private static bool TryParseKey(string name, out ResultCacheKey key)
+    {
+        key = default;
+        if (name.Length != 64
+            || !UInt128.TryParse(name.AsSpan(0, 32), NumberStyles.AllowHexSpecifier, null, out var high)
+            || !UInt128.TryParse(name.AsSpan(32), NumberStyles.AllowHexSpecifier, null, out var low))
+        {
+            return false;
+        }
+        key = new ResultCacheKey(high, low);
+        return true;
+    }
+
+    private async Task WriteLoop()
+    {
+        await foreach (var entry in _pendingWrites!.Reader.ReadAllAsync())
+        {
+            if (_onDisk.ContainsKey(entry.Key) || !Write(entry))
+                continue;
+            _onDisk[entry.Key] = 0;
+            _diskOrder.Enqueue(entry.Key);
+            EvictDisk();
+        }
+    }
+
+    private void EvictDisk()
+    {
+        while (_diskOrder.Count > _maxDiskEntries)
+        {
+            var oldest = _diskOrder.Dequeue();
+            _onDisk.TryRemove(oldest, out _);
+            TryDelete(EntryPath(oldest));
+        }
+    }
+
+    private static void TryDelete(string path)
+    {
+        try
+        {
+            File.Delete(path);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+        }
+    }
+
+    // A missing, truncated, or corrupt file is just a miss. Only keys in the disk index are read, a file evicted in
+    // between is the one miss that throws
+    private bool TryRead(ResultCacheKey key, [NotNullWhen(true)] out Entry? entry)
+    {
+        entry = null;
+        if (_diskDirectory == null || !_onDisk.ContainsKey(key))
+            return false;
+
+        try
+        {
+            using var reader = new BinaryReader(File.OpenRead(EntryPath(key)));
+            if (reader.ReadUInt32() != DiskFormatMagic)
+                return false;
+
+            var count = reader.ReadInt32();
+            var detections = new List<BoundingBox>();
+            var recognitions = new List<(string Text, double Confidence)>();
+            for (var i = 0; i < count; i++)
+            {
+                var pointCount = reader.ReadInt32();
+                var points = new List<PointF>();
+                for (var j = 0; j < pointCount; j++)
+                    points.Add((reader.ReadDouble(), reader.ReadDouble()));
+
+                detections.Add(new BoundingBox
+                {
+                    Polygon = new Polygon(points),
+                    RotatedRectangle = new RotatedRectangle
+                    {
+                        X = reader.ReadDouble(),
+                        Y = reader.ReadDouble(),
+                        Width = reader.ReadDouble(),
+                        Height = reader.ReadDouble(),
+                        Angle = reader.ReadDouble()
+                    },
+                    AxisAlignedRectangle = new AxisAlignedRectangle
+                    {
+                        X = reader.ReadDouble(),
+                        Y = reader.ReadDouble(),
+                        Width = reader.ReadDouble(),
+                        Height = reader.ReadDouble()
+                    }
+                });
+                recognitions.Add((reader.ReadString(), reader.ReadDouble()));
+            }
+
+            entry = new Entry(key, detections, recognitions);
+            return true;
+        }
+        catch (Exception ex)
+            when (ex is IOException or UnauthorizedAccessException or FormatException or ArgumentException)
+        {
+            return false;
+        }
+    }
+
+    // Written to a temp file and renamed into place, so concurrent readers never see half an entry. False if it failed
+    private bool Write(Entry entry)
+    {
+        var path = EntryPath(entry.Key);
+        var tempPath = $"{path}.tmp.{Environment.ProcessId}.{Environment.CurrentManagedThreadId}";
+        try
+        {
+            using (var writer = new BinaryWriter(File.Create(tempPath)))
+            {
+                writer.Write(DiskFormatMagic);
+                writer.Write(entry.Detections.Count);
+                for (var i = 0; i < entry.Detections.Count; i++)
+                {
+                    var (polygon, rotated, rectangle) = (entry.Detections[i].Polygon,
+                        entry.Detections[i].RotatedRectangle, entry.Detections[i].AxisAlignedRectangle);
+                    writer.Write(polygon.Points.Count);
+                    foreach (var (x, y) in polygon.Points)
+                    {
+                        writer.Write(x);
+                        writer.Write(y);
+                    }
+                    writer.Write(rotated.X);
+                    writer.Write(rotated.Y);
+                    writer.Write(rotated.Width);
+                    writer.Write(rotated.Height);
+                    writer.Write(rotated.Angle);
+                    writer.Write(rectangle.X);
+                    writer.Write(rectangle.Y);
+                    writer.Write(rectangle.Width);
+                    writer.Write(rectangle.Height);
+                    writer.Write(entry.Recognitions[i].Text);
+                    writer.Write(entry.Recognitions[i].Confidence);
+                }
+            }
+            File.Move(tempPath, path, overwrite: true);
+            return true;
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            // Best-effort; the entry is still in memory
+            TryDelete(tempPath);
+            return false;
+        }
+    }
+}
@@ -1,8 +1,10 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
+using System.Diagnostics.Metrics;
 using Microsoft.Extensions.DependencyInjection;
 using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.SmartMetrics;
 using SpeedReader.Resources.CharDict;
 
 namespace SpeedReader.Ocr;
@@ -13,8 +15,17 @@ public static class ServiceCollectionExtensions
         this IServiceCollection services,
         OcrPipelineOptions options)
     {
-        services.AddInferenceEngine(options.DetectionEngine);
-        services.AddInferenceEngine(options.RecognitionEngine);
+        services.AddSingleton(options.Rebalancing);
+        if (options.RemoteEngine is { } remoteEngine)
+        {
+            services.AddInferenceEngine(remoteEngine, Model.DbNet);
+            services.AddInferenceEngine(remoteEngine, Model.Svtr);
+        }
+        else
+        {
+            services.AddInferenceEngine(options.DetectionEngine);
+            services.AddInferenceEngine(options.RecognitionEngine);
+        }
 
         services.AddSingleton(options.DetectionOptions);
         services.AddSingleton(options.RecognitionOptions);
@@ -24,7 +35,18 @@ public static class ServiceCollectionExtensions
         services.AddSingleton(sp => TextDetector.Factory(sp, Model.DbNet));
         services.AddSingleton(sp => TextRecognizer.Factory(sp, Model.Svtr));
 
-        services.AddSingleton<OcrPipeline>();
+        services.AddSingleton(sp => new ImageDecoder(options.Decode, sp.GetService<StageTimings>()));
+        services.AddSingleton(sp => new OcrPipeline(
+            sp.GetRequiredService<TextDetector>(),
+            sp.GetRequiredService<TextRecognizer>(),
+            options.Visualize,
+            sp.GetRequiredService<ImageDecoder>())
+        {
+            ResultCache = options.ResultCache is { } cacheOptions
+                ? new ResultCache(cacheOptions, ResultCache.Fingerprint(options), sp.GetService<IMeterFactory>())
+                : null,
+            StageTimings = sp.GetService<StageTimings>() ?? StageTimings.Disabled
+        });
 
         return services;
     }
@@ -0,0 +1,80 @@
+// Copyright (c) 2025 j-r-beckett
+// Licensed under the Apache License, Version 2.0
+
+using System.Diagnostics;
+using System.Diagnostics.Metrics;
+using Microsoft.Extensions.DependencyInjection;
+using SpeedReader.Ocr.InferenceEngine;
+
+namespace SpeedReader.Ocr.SmartMetrics;
+
+public enum PipelineStage
+{
+    Admission,  // Waiting for a slot in the pipeline's task pool
+    Decode,
+    Tile,
+    Preprocess,  // Detection resize and normalize
+    QueueWait,  // Waiting for an inference runner
+    Inference,
+    Postprocess,  // Detection tile merge and boundary tracing
+    Crop,  // Recognition warp and normalize
+    Ctc,
+    Serialize
+}
+
+// One latency histogram for every pipeline stage, tagged by stage and, for stages that run a model, by model. Buckets
+// are spaced by sqrt(2) from 10 us to 40 s, so any percentile read off them is within ~20% wherever it lands: the
+// HDR trade-off at a fixed 45 buckets per series, which the collector's Prometheus exporter can carry as is
+public sealed class StageTimings
+{
+    public const string MeterName = "speedreader.pipeline";
+
+    public static StageTimings Disabled { get; } = new(null);
+
+    private static readonly double[] BucketBoundaries =
+        [.. Enumerable.Range(0, 45).Select(i => 0.01 * Math.Pow(2, i / 2.0))];
+
+    private static readonly string[] StageNames =
+        ["admission", "decode", "tile", "preprocess", "queue_wait", "inference", "postprocess", "crop", "ctc",
+            "serialize"];
+
+    private readonly Histogram<double>? _duration;
+
+    public StageTimings(IMeterFactory? meterFactory)
+    {
+        if (meterFactory == null)
+            return;
+
+        var meter = meterFactory.Create(MeterName);
+        _duration = meter.CreateHistogram<double>($"{MeterName}.stage.duration", "ms",
+            "Time spent in each pipeline stage", tags: null,
+            advice: new InstrumentAdvice<double> { HistogramBucketBoundaries = BucketBoundaries });
+    }
+
+    public static StageTimings Factory(IServiceProvider serviceProvider) =>
+        new(serviceProvider.GetService<IMeterFactory>());
+
+    // False until something listens, so an unexported pipeline never reads the clock for these
+    public bool Enabled => _duration?.Enabled == true;
+
+    // Zero when disabled, which Record ignores
+    public long Start() => Enabled ? Stopwatch.GetTimestamp() : 0;
+
+    public void Record(PipelineStage stage, long start, Model? model = null)
+    {
+        if (start != 0)
+            Record(stage, Stopwatch.GetElapsedTime(start), model);
+    }
+
+    public void Record(PipelineStage stage, TimeSpan elapsed, Model? model = null)
+    {
+        if (_duration == null)
+            return;
+
+        var stageTag = new KeyValuePair<string, object?>("stage", StageNames[(int)stage]);
+        if (model is { } m)
+            _duration.Record(elapsed.TotalMilliseconds, stageTag, new("model", m == Model.DbNet ? "dbnet" : "svtr"));
+        else
+            _duration.Record(elapsed.TotalMilliseconds, stageTag);
+    }
+}
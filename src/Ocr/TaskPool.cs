@@ -1,83 +1,123 @@
 // Copyright (c) 2025 j-r-beckett
 // Licensed under the Apache License, Version 2.0
 
+using System.Collections.Concurrent;
+using System.Diagnostics.CodeAnalysis;
+
 namespace SpeedReader.Ocr;
 
-public class TaskPool<T>
+// Admission control for pipelines. Outer task is for entering the pool, inner task is for executing the task created
+// by userTaskCreator in the pool
+public interface ITaskPool<T>
 {
-    private readonly Queue<(TaskCompletionSource<Task<T>>, Func<Task<T>>)> _pendingWorkQueue = new();
+    int PoolSize { get; }
+    Task<Task<T>> Execute(Func<Task<T>> userTaskCreator);
+    bool TryExecute(Func<Task<T>> userTaskCreator, [NotNullWhen(true)] out Task<T>? userTask);
+}
 
-    private readonly Lock _lock = new();
+public class TaskPool<T> : ITaskPool<T>
+{
+    private readonly ConcurrentQueue<(TaskCompletionSource<Task<T>>, Func<Task<T>>)> _pendingWorkQueue = new();
+    private readonly Action _onUserTaskCompleted;
+    private int _poolSize;
+    private int _poolOccupancy;
 
     public TaskPool(int initialPoolSize = 1)
     {
         ArgumentOutOfRangeException.ThrowIfLessThan(initialPoolSize, 1, nameof(initialPoolSize));
-        PoolSize = initialPoolSize;
+        _poolSize = initialPoolSize;
+        _onUserTaskCompleted = OnUserTaskCompleted;
     }
 
-    public int PoolSize { get; private set; }  // Current max number of concurrently executing tasks
+    public int PoolSize => Volatile.Read(ref _poolSize);  // Current max number of concurrently executing tasks
 
-    public int PoolOccupancy { get; private set; }  // Current number of concurrently executing tasks
+    public int PoolOccupancy => Volatile.Read(ref _poolOccupancy);  // Current number of concurrently executing tasks
 
     // Outer task is for entering the pool, inner task is for executing the task created by userTaskCreator in the pool.
     // `userTaskCreator` should be a synchronous function that returns a Task
-    public async Task<Task<T>> Execute(Func<Task<T>> userTaskCreator)
+    public Task<Task<T>> Execute(Func<Task<T>> userTaskCreator)
     {
-        var tcs = new TaskCompletionSource<Task<T>>();
-
-        lock (_lock)
-        {
-            _pendingWorkQueue.Enqueue((tcs, userTaskCreator));
-            StartNewTasks();
-        }
+        // Start right away if there's room and nobody is queued ahead of us
+        if (_pendingWorkQueue.IsEmpty && TryEnterPool())
+            return Task.FromResult(StartUserTask(userTaskCreator));
 
-        var userTask = await tcs.Task;  // Wait for the user's task to be started
+        var tcs = new TaskCompletionSource<Task<T>>(TaskCreationOptions.RunContinuationsAsynchronously);
+        _pendingWorkQueue.Enqueue((tcs, userTaskCreator));
+        StartNewTasks();  // A slot may have freed up between TryEnterPool and Enqueue
+        return tcs.Task;
+    }
 
-        // This runs after the user's task completes
-#pragma warning disable CS4014  // Because this call is not awaited, execution of the current method continues before the call is completed
-        userTask.ContinueWith(_ =>
+    // Non-blocking Execute: starts the task only if the pool has room right now, never queues
+    public bool TryExecute(Func<Task<T>> userTaskCreator, [NotNullWhen(true)] out Task<T>? userTask)
+    {
+        if (_pendingWorkQueue.IsEmpty && TryEnterPool())
         {
-            lock (_lock)
-            {
-                PoolOccupancy--;
-                StartNewTasks();
-            }
-        });
-#pragma warning restore CS4014
+            userTask = StartUserTask(userTaskCreator);
+            return true;
+        }
 
-        // Return the user's task so they can await it
-        return userTask;
+        userTask = null;
+        return false;
     }
 
     public void SetPoolSize(int newSize)
     {
         ArgumentOutOfRangeException.ThrowIfLessThan(newSize, 1, nameof(newSize));
-        lock (_lock)
+        Volatile.Write(ref _poolSize, newSize);
+        Interlocked.MemoryBarrier();
+        StartNewTasks();  // If pool size decreased this does nothing
+    }
+
+    private bool TryEnterPool()
+    {
+        while (true)
+        {
+            var occupancy = Volatile.Read(ref _poolOccupancy);
+            if (occupancy >= Volatile.Read(ref _poolSize))
+                return false;
+            if (Interlocked.CompareExchange(ref _poolOccupancy, occupancy + 1, occupancy) == occupancy)
+                return true;
+        }
+    }
+
+    private Task<T> StartUserTask(Func<Task<T>> taskCreator)
+    {
+        Task<T> userTask;
+        try
         {
-            PoolSize = newSize;
-            StartNewTasks();  // If pool size decreased this does nothing
+            userTask = taskCreator();
         }
+        catch (Exception ex)
+        {
+            userTask = Task.FromException<T>(new UserTaskCreationException("Error creating user task", ex));
+        }
+
+        // Leave the pool once the user's task completes. The delegate is cached, so this doesn't allocate
+        userTask.ConfigureAwait(false).GetAwaiter().UnsafeOnCompleted(_onUserTaskCompleted);
+        return userTask;
+    }
+
+    private void OnUserTaskCompleted()
+    {
+        Interlocked.Decrement(ref _poolOccupancy);
+        StartNewTasks();
     }
 
     // Called after adding a task to the work queue, after increasing the pool size, and after completing a task.
-    // Basically, we call it every time there's a possibility a new task could start executing.
-    // Not threadsafe, must be called with lock(_lock).
+    // Basically, we call it every time there's a possibility a new task could start executing. Every caller first
+    // publishes its change with a full fence, so at least one of two racing callers sees both the slot and the work
     private void StartNewTasks()
     {
-        while (PoolOccupancy < PoolSize && _pendingWorkQueue.TryDequeue(out var workItem))
+        while (!_pendingWorkQueue.IsEmpty && TryEnterPool())
         {
-            var (tcs, taskCreator) = workItem;
-            Task<T> userTask;
-            try
+            if (!_pendingWorkQueue.TryDequeue(out var workItem))
             {
-                userTask = taskCreator();
+                Interlocked.Decrement(ref _poolOccupancy);  // Someone else took it, give the slot back and look again
+                continue;
             }
-            catch (Exception ex)
-            {
-                userTask = Task.FromException<T>(new UserTaskCreationException("Error creating user task", ex));
-            }
-            tcs.SetResult(userTask);
-            PoolOccupancy++;
+
+            var (tcs, taskCreator) = workItem;
+            tcs.SetResult(StartUserTask(taskCreator));
         }
     }
 }
@@ -7,10 +7,11 @@ using CommunityToolkit.HighPerformance;
 using Microsoft.Extensions.DependencyInjection;
 using SixLabors.ImageSharp;
 using SixLabors.ImageSharp.PixelFormats;
-using SixLabors.ImageSharp.Processing;
+using SpeedReader.Native.DbNet;
 using SpeedReader.Ocr.Algorithms;
 using SpeedReader.Ocr.Geometry;
 using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.SmartMetrics;
 using SpeedReader.Ocr.Visualization;
 
 namespace SpeedReader.Ocr;
@@ -18,8 +19,11 @@ namespace SpeedReader.Ocr;
 public class TextDetector
 {
     private readonly IInferenceEngine _inferenceEngine;
+    private readonly TensorPool _tensorPool;
     private readonly int _tileHeight;
     private readonly int _tileWidth;
+    private readonly DetectionPostprocessing _postprocessing;
+    private readonly StageTimings _stageTimings;
 
     public int InferenceEngineCapacity() => _inferenceEngine.CurrentMaxCapacity();
 
@@ -27,18 +31,28 @@ public class TextDetector
     {
         var options = serviceProvider.GetRequiredService<DetectionOptions>();
         var engine = serviceProvider.GetRequiredKeyedService<IInferenceEngine>(key);
-        return new TextDetector(engine, options);
+        var tensorPool = serviceProvider.GetService<TensorPool>();
+        var stageTimings = serviceProvider.GetService<StageTimings>();
+        return new TextDetector(engine, options, tensorPool, stageTimings);
     }
 
-    public TextDetector(IInferenceEngine inferenceEngine, DetectionOptions options)
+    public TextDetector(IInferenceEngine inferenceEngine, DetectionOptions options, TensorPool? tensorPool = null,
+        StageTimings? stageTimings = null)
     {
         _inferenceEngine = inferenceEngine;
+        _tensorPool = tensorPool ?? TensorPool.Shared;
         _tileWidth = options.TileWidth;
         _tileHeight = options.TileHeight;
+        _postprocessing = options.Postprocessing;
+        _stageTimings = stageTimings ?? StageTimings.Disabled;
     }
 
     private const double OverlapMultiplier = 0.05;
+    private const float BinarizationThreshold = 0.2f;  // Recommended by the DBNet paper
+    private const double SimplifyEpsilon = 4;
+    private const double DilationRatio = 1.5;  // Undoes the contraction DBNet is trained with; model-specific
 
+    // Tile tensors are rented from the tensor pool
     [MethodImpl(MethodImplOptions.NoInlining)]
     public List<(float[] Data, int[] Shape)> Preprocess(Image<Rgb24> image, Tiling tiling, VizBuilder vizBuilder)
     {
@@ -51,26 +65,27 @@ public class TextDetector
         var tiledWidth = bottomRightTile.Right;
         var tiledHeight = bottomRightTile.Bottom;
 
-        // Resize, preserves aspect ratio, pads with black, positions at top-left
-        using var resized = image.Clone(x => x
-            .Resize(new ResizeOptions
-            {
-                Size = new Size(tiledWidth, tiledHeight),
-                Mode = ResizeMode.Pad,
-                Position = AnchorPositionMode.TopLeft
-            }));
+        // Resize preserving aspect ratio, then pad with black at the bottom right. Same rounding as ImageSharp's
+        // ResizeMode.Pad, which the probability map visualization assumes when undoing the padding
+        var widthRatio = tiledWidth / (float)image.Width;
+        var heightRatio = tiledHeight / (float)image.Height;
+        var fittedSize = heightRatio < widthRatio
+            ? new Size((int)MathF.Round(image.Width * heightRatio), tiledHeight)
+            : new Size(tiledWidth, (int)MathF.Round(image.Height * widthRatio));
 
         int[] tensorShape = [3, _tileHeight, _tileWidth];  // CHW
 
-        // Thanks to the resize, we can now cut the image perfectly into tiles
+        // Each tile is resized, cropped and normalized in one pass straight from the original image
         return tileRects.Select(t => (ToTensor(t), inferenceShape: tensorShape)).ToList();
 
         float[] ToTensor(Rectangle tile)
         {
-            // Crop tile rect out of the image, convert it to a tensor (float array), apply ImageNet normalization
+            // Apply ImageNet normalization
             Span<float> means = [123.675f, 116.28f, 103.53f];
             Span<float> stds = [58.395f, 57.12f, 57.375f];
-            return resized.ToNormalizedChwTensor(tile, means, stds);
+            var tensor = _tensorPool.Rent(tensorShape);
+            image.ResizeToNormalizedChwTensor(fittedSize, tile, means, stds, tensor);
+            return tensor;
         }
     }
 
@@ -80,86 +95,281 @@ public class TextDetector
         var tileRects = tiling.Tiles;
         var tiledWidth = tileRects[^1].Right;
         var tiledHeight = tileRects[^1].Bottom;
-        var compositeModelOutput = new float[tiledWidth * tiledHeight];
+        var compositeModelOutput = _tensorPool.Rent(tiledWidth * tiledHeight);
+        Array.Clear(compositeModelOutput);  // Merge below takes the max, so start from zero
 
         Debug.Assert(tileRects.Count == inferenceOutputs.Length);
         foreach (var (tileRect, (modelOutput, shape)) in tileRects.Zip(inferenceOutputs))
+            MergeTile(compositeModelOutput, tiledWidth, tileRect, modelOutput, shape);
+
+        var probabilityMapSpan = compositeModelOutput.AsSpan().AsSpan2D(tiledHeight, tiledWidth);
+        vizBuilder.CreateAndAddProbabilityMap(probabilityMapSpan, originalImage.Width, originalImage.Height);
+
+        var scale = TiledScale(tiledWidth, tiledHeight, originalImage);
+        var boundingBoxes = _postprocessing == DetectionPostprocessing.Native
+            ? FindBoxesNatively(compositeModelOutput, tiledWidth, 0, tiledHeight, 0, tiledHeight, scale, originalImage,
+                out _)
+            : ExtractBoundaries(new ReliefMap(compositeModelOutput, tiledWidth, tiledHeight))
+                .Select(boundary => ToBoundingBox(boundary, scale, originalImage))
+                .OfType<BoundingBox>()  // Filter out nulls
+                .ToList();
+        _tensorPool.Return(compositeModelOutput);
+
+        vizBuilder.AddBoundingBoxes(boundingBoxes);
+
+        return boundingBoxes;
+    }
+
+    private void MergeTile(float[] composite, int tiledWidth, Rectangle tileRect, float[] modelOutput, int[] shape)
+    {
+        Debug.Assert(shape.Length == 2);
+        Debug.Assert(shape[0] == _tileHeight);
+        Debug.Assert(shape[1] == _tileWidth);
+
+        if (_postprocessing == DetectionPostprocessing.Native)
         {
-            Debug.Assert(shape.Length == 2);
-            Debug.Assert(shape[0] == _tileHeight);
-            Debug.Assert(shape[1] == _tileWidth);
+            DbNetPostprocessor.MergeTile(composite, tiledWidth, modelOutput, _tileWidth, _tileHeight, tileRect.Left,
+                tileRect.Top);
+            return;
+        }
 
-            for (int row = 0; row < _tileHeight; row++)
-            {
-                var imageRow = tileRect.Top + row;
+        for (int row = 0; row < _tileHeight; row++)
+        {
+            var imageRow = tileRect.Top + row;
 
-                for (int col = 0; col < _tileWidth; col++)
-                {
-                    var imageCol = tileRect.Left + col;
+            for (int col = 0; col < _tileWidth; col++)
+            {
+                var imageCol = tileRect.Left + col;
 
-                    // Take the max value in overlapping regions
-                    compositeModelOutput[imageRow * tiledWidth + imageCol] =
-                        Math.Max(compositeModelOutput[imageRow * tiledWidth + imageCol], modelOutput[row * _tileWidth + col]);
-                }
+                // Take the max value in overlapping regions
+                composite[imageRow * tiledWidth + imageCol] =
+                    Math.Max(composite[imageRow * tiledWidth + imageCol], modelOutput[row * _tileWidth + col]);
             }
         }
+    }
 
-        var probabilityMapSpan = compositeModelOutput.AsSpan().AsSpan2D(tiledHeight, tiledWidth);
-        vizBuilder.CreateAndAddProbabilityMap(probabilityMapSpan, originalImage.Width, originalImage.Height);
+    private List<Polygon> ExtractBoundaries(ReliefMap reliefMap) =>
+        _postprocessing == DetectionPostprocessing.ConnectedComponents
+            ? reliefMap.LabelConnectedComponents().Select(component => component.Contour).ToList()
+            : reliefMap.TraceAllBoundaries();
 
-        var boundingBoxes = PostprocessComposite(compositeModelOutput, tiledHeight, tiledWidth);
+    // The scale used in HardAspectResize
+    private static double TiledScale(int tiledWidth, int tiledHeight, Image<Rgb24> originalImage)
+    {
+        var scaleX = (double)tiledWidth / originalImage.Width;
+        var scaleY = (double)tiledHeight / originalImage.Height;
+        return Math.Min(scaleX, scaleY);
+    }
 
-        vizBuilder.AddBoundingBoxes(boundingBoxes);
+    private static BoundingBox? ToBoundingBox(Polygon boundary, double scale, Image<Rgb24> originalImage)
+    {
+        var polygon = boundary
+            .Simplify(SimplifyEpsilon)  // Remove redundant points; see https://en.wikipedia.org/wiki/Ramer%E2%80%93Douglas%E2%80%93Peucker_algorithm
+            .Scale(1 / scale)  // Undo scaling; convert from tiled to original coordinates
+            .Dilate(DilationRatio)  // Undo contraction baked into DBNet during training
+            ?.Clamp(originalImage.Height - 1, originalImage.Width - 1);  // Make sure we don't go out of bounds
+
+        var convexHull = polygon?.ToConvexHull();
+        var rotatedRectangle = convexHull?.ToRotatedRectangle();
+        var axisAlignedRectangle = rotatedRectangle?.ToAxisAlignedRectangle();
 
+        if (axisAlignedRectangle == null)
+            return null;
+
+        // If axisAlignedRectangle is non-null then polygon and rotatedRectangle must also be non-null
+        return new BoundingBox
+        {
+            Polygon = polygon!,
+            RotatedRectangle = rotatedRectangle!,
+            AxisAlignedRectangle = axisAlignedRectangle
+        };
+    }
+
+    // All of DetectIncrementally's bands at once
+    public async Task<List<BoundingBox>> Detect(Image<Rgb24> image, VizBuilder vizBuilder)
+    {
+        var boundingBoxes = new List<BoundingBox>();
+        await foreach (var batch in DetectIncrementally(image, vizBuilder))
+            boundingBoxes.AddRange(batch);
         return boundingBoxes;
+    }
+
+    // Rows at the edge of a band that morphological opening can't see both sides of
+    private const int BandMargin = 3;
+
+    // Same detections as Postprocess on the whole composite, but yielded band by band as rows of tiles finish
+    // inference, so recognition can start on the top of the image while the rest is still running. Each tile is merged
+    // into the composite as soon as it completes. Regions are in scan order within a band, bands are top to bottom.
+    // Never yields an empty list. Merging and tracing time is summed over the bands into one postprocess timing
+    //
+    // Override for testing only
+    public virtual async IAsyncEnumerable<List<BoundingBox>> DetectIncrementally(Image<Rgb24> image, VizBuilder vizBuilder)
+    {
+        var start = _stageTimings.Start();
+        var tiling = Tile(image);
+        _stageTimings.Record(PipelineStage.Tile, start);
+        var tileRects = tiling.Tiles;
+        var tiledWidth = tileRects[^1].Right;
+        var tiledHeight = tileRects[^1].Bottom;
+        var scale = TiledScale(tiledWidth, tiledHeight, image);
 
-        List<BoundingBox> PostprocessComposite(float[] modelOutput, int height, int width)
+        start = _stageTimings.Start();
+        var modelInput = Preprocess(image, tiling, vizBuilder);
+        _stageTimings.Record(PipelineStage.Preprocess, start);
+        var inferenceTasks = modelInput.Select(async (tile, i) =>
+        {
+            var output = await _inferenceEngine.Run(tile.Data, tile.Shape);
+            _tensorPool.Return(tile.Data);
+            return (Index: i, Output: output);
+        }).ToList();
+
+        var composite = _tensorPool.Rent(tiledWidth * tiledHeight);
+        Array.Clear(composite);  // Merge takes the max, so start from zero
+        var boundingBoxes = new List<BoundingBox>();
+        var completedPerTileRow = new int[tiling.NumTilesVertical];
+        var finalizedTileRows = 0;
+
+        // Rows above cutoff are done: every region that ends above it has been yielded. Regions that were cut off by
+        // the end of the last band start at or below pendingTop
+        var cutoff = 0;
+        var pendingTop = int.MaxValue;
+        var postprocessing = TimeSpan.Zero;
+        try
         {
-            var boundaries = new ReliefMap(modelOutput, width, height).TraceAllBoundaries();
+            await foreach (var completed in Task.WhenEach(inferenceTasks))
+            {
+                var (index, output) = await completed;
+                start = _stageTimings.Start();
+                var batch = MergeCompleted(index, output);
+                if (start != 0)
+                    postprocessing += Stopwatch.GetElapsedTime(start);
+                if (batch == null)
+                    continue;
+
+                boundingBoxes.AddRange(batch);
+                yield return batch;
+            }
 
-            // Calculate the scale used in HardAspectResize
-            var scaleX = (double)width / originalImage.Width;
-            var scaleY = (double)height / originalImage.Height;
-            var scale = Math.Min(scaleX, scaleY);
+            var probabilityMapSpan = composite.AsSpan().AsSpan2D(tiledHeight, tiledWidth);
+            vizBuilder.CreateAndAddProbabilityMap(probabilityMapSpan, image.Width, image.Height);
+            vizBuilder.AddBoundingBoxes(boundingBoxes);
+            if (_stageTimings.Enabled)
+                _stageTimings.Record(PipelineStage.Postprocess, postprocessing);
+        }
+        finally
+        {
+            _tensorPool.Return(composite);
+        }
 
-            return boundaries
-                .Select(BoundaryToBBox)
-                .OfType<BoundingBox>()  // Filter out nulls
-                .ToList();
+        // Null until the tile finishes a band with regions in it
+        List<BoundingBox>? MergeCompleted(int index, (float[] Data, int[] Shape) output)
+        {
+            MergeTile(composite, tiledWidth, tileRects[index], output.Data, output.Shape);
+            _tensorPool.Return(output.Data);
+            completedPerTileRow[index / tiling.NumTilesHorizontal]++;
 
-            BoundingBox? BoundaryToBBox(Polygon boundary)
+            var previouslyFinalized = finalizedTileRows;
+            while (finalizedTileRows < tiling.NumTilesVertical &&
+                   completedPerTileRow[finalizedTileRows] == tiling.NumTilesHorizontal)
             {
-                var polygon = boundary
-                    .Simplify(4)  // Remove redundant points; see https://en.wikipedia.org/wiki/Ramer%E2%80%93Douglas%E2%80%93Peucker_algorithm
-                    .Scale(1 / scale)  // Undo scaling; convert from tiled to original coordinates
-                    .Dilate(1.5)  // Undo contraction baked into DBNet during training; 1.5 is a model-specific constant
-                    ?.Clamp(originalImage.Height - 1, originalImage.Width - 1);  // Make sure we don't go out of bounds
-
-                var convexHull = polygon?.ToConvexHull();
-                var rotatedRectangle = convexHull?.ToRotatedRectangle();
-                var axisAlignedRectangle = rotatedRectangle?.ToAxisAlignedRectangle();
-
-                if (axisAlignedRectangle == null)
-                    return null;
-
-                // If axisAlignedRectangle is non-null then polygon and rotatedRectangle must also be non-null
-                return new BoundingBox
-                {
-                    Polygon = polygon!,
-                    RotatedRectangle = rotatedRectangle!,
-                    AxisAlignedRectangle = axisAlignedRectangle
-                };
+                finalizedTileRows++;
             }
+            if (finalizedTileRows == previouslyFinalized)
+                return null;
+
+            // Composite rows above the next tile row's top can't change anymore, overlap band included
+            var isLast = finalizedTileRows == tiling.NumTilesVertical;
+            var bandBottom = isLast ? tiledHeight : tileRects[finalizedTileRows * tiling.NumTilesHorizontal].Top;
+            var bandTop = Math.Max(0, Math.Min(cutoff, pendingTop) - BandMargin);
+            var bandCutoff = isLast ? tiledHeight : bandBottom - BandMargin;
+            if (bandCutoff <= cutoff)
+                return null;
+
+            var batch = _postprocessing == DetectionPostprocessing.Native
+                ? FindBoxesNatively(composite, tiledWidth, bandTop, bandBottom, cutoff, bandCutoff, scale, image,
+                    out pendingTop)
+                : ExtractBand(composite, tiledWidth, bandTop, bandBottom, cutoff, bandCutoff, out pendingTop)
+                    .Select(boundary => ToBoundingBox(boundary, scale, image))
+                    .OfType<BoundingBox>()
+                    .ToList();
+            cutoff = bandCutoff;
+            return batch.Count == 0 ? null : batch;
         }
     }
 
-    // Override for testing only
-    public virtual async Task<List<BoundingBox>> Detect(Image<Rgb24> image, VizBuilder vizBuilder)
+    // Boundaries in composite rows [top, bottom) that end in [previousCutoff, cutoff). Ones ending above previousCutoff
+    // were already yielded (or are fragments of those); ones ending at or below cutoff may continue into rows that
+    // aren't final yet, so they are left for the next band, which must start at or above pendingTop
+    private List<Polygon> ExtractBand(float[] composite, int width, int top, int bottom, int previousCutoff, int cutoff,
+        out int pendingTop)
     {
-        var tiling = Tile(image);
-        var modelInput = Preprocess(image, tiling, vizBuilder);
-        var modelOutput = await RunInference(modelInput);
-        return Postprocess(modelOutput, tiling, image, vizBuilder);
+        var height = bottom - top;
+        var band = _tensorPool.Rent(width * height);
+        composite.AsSpan(top * width, width * height).CopyTo(band);
+
+        List<Polygon> boundaries;
+        try
+        {
+            boundaries = ExtractBoundaries(new ReliefMap(band, width, height));
+        }
+        finally
+        {
+            _tensorPool.Return(band);
+        }
+
+        pendingTop = int.MaxValue;
+        var complete = new List<Polygon>(boundaries.Count);
+        foreach (var boundary in boundaries)
+        {
+            var boundaryTop = top + (int)boundary.Points.Min(p => p.Y);
+            var boundaryBottom = top + (int)boundary.Points.Max(p => p.Y);
+            if (boundaryBottom >= cutoff)
+                pendingTop = Math.Min(pendingTop, boundaryTop);
+            else if (boundaryBottom >= previousCutoff)
+                complete.Add(new Polygon(boundary.Points.Select(p => new PointF { X = p.X, Y = p.Y + top }).ToList()));
+        }
+
+        return complete;
+    }
+
+    // ExtractBand and ToBoundingBox in one native call, reading the band in place rather than from a copy
+    private static List<BoundingBox> FindBoxesNatively(float[] composite, int width, int top, int bottom,
+        int previousCutoff, int cutoff, double scale, Image<Rgb24> originalImage, out int pendingTop)
+    {
+        var height = bottom - top;
+        var boxes = DbNetPostprocessor.FindBoxes(composite.AsSpan(top * width, width * height), width, height,
+            new DbNetBoxOptions
+            {
+                Threshold = BinarizationThreshold,
+                SimplifyEpsilon = SimplifyEpsilon,
+                Scale = scale,
+                DilationRatio = DilationRatio,
+                MaxX = originalImage.Width - 1,
+                MaxY = originalImage.Height - 1,
+                RowOffset = top,
+                MinBottom = previousCutoff,
+                MaxBottom = cutoff
+            },
+            out pendingTop);
+
+        return boxes.Select(box =>
+        {
+            var rotatedRectangle = new RotatedRectangle(ToPoints(box.Corners));
+            return new BoundingBox
+            {
+                Polygon = new Polygon(ToPoints(box.Polygon)),
+                RotatedRectangle = rotatedRectangle,
+                AxisAlignedRectangle = rotatedRectangle.ToAxisAlignedRectangle()
+            };
+        }).ToList();
+
+        static List<PointF> ToPoints(double[] coordinates)
+        {
+            var points = new List<PointF>(coordinates.Length / 2);
+            for (var i = 0; i < coordinates.Length; i += 2)
+                points.Add((coordinates[i], coordinates[i + 1]));
+            return points;
+        }
     }
 
     public async Task<(float[], int[])[]> RunInference(List<(float[], int[])> tiles)
@@ -7,10 +7,10 @@ using System.Runtime.CompilerServices;
 using Microsoft.Extensions.DependencyInjection;
 using SixLabors.ImageSharp;
 using SixLabors.ImageSharp.PixelFormats;
-using SixLabors.ImageSharp.Processing;
 using SpeedReader.Ocr.Algorithms;
 using SpeedReader.Ocr.Geometry;
 using SpeedReader.Ocr.InferenceEngine;
+using SpeedReader.Ocr.SmartMetrics;
 using SpeedReader.Ocr.Visualization;
 using SpeedReader.Resources.CharDict;
 
@@ -20,8 +20,10 @@ public class TextRecognizer
 {
     private readonly IInferenceEngine _inferenceEngine;
     private readonly EmbeddedCharDict _embeddedCharDict;
-    private readonly int _inputWidth;
+    private readonly TensorPool _tensorPool;
+    private readonly int[] _inputWidths;
     private readonly int _inputHeight;
+    private readonly StageTimings _stageTimings;
 
     public int InferenceEngineCapacity() => _inferenceEngine.CurrentMaxCapacity();
 
@@ -30,61 +32,76 @@ public class TextRecognizer
         var options = serviceProvider.GetRequiredService<RecognitionOptions>();
         var engine = serviceProvider.GetRequiredKeyedService<IInferenceEngine>(key);
         var dictionary = serviceProvider.GetRequiredService<EmbeddedCharDict>();
-        return new TextRecognizer(engine, dictionary, options);
+        var tensorPool = serviceProvider.GetService<TensorPool>();
+        var stageTimings = serviceProvider.GetService<StageTimings>();
+        return new TextRecognizer(engine, dictionary, options, tensorPool, stageTimings);
     }
 
-    public TextRecognizer(IInferenceEngine inferenceEngine, EmbeddedCharDict embeddedCharDict, RecognitionOptions options)
+    public TextRecognizer(IInferenceEngine inferenceEngine, EmbeddedCharDict embeddedCharDict, RecognitionOptions options,
+        TensorPool? tensorPool = null, StageTimings? stageTimings = null)
     {
         _inferenceEngine = inferenceEngine;
         _embeddedCharDict = embeddedCharDict;
-        _inputWidth = options.RecognitionInputWidth;
+        _tensorPool = tensorPool ?? TensorPool.Shared;
+        _inputWidths = options.RecognitionInputWidths;
         _inputHeight = options.RecognitionInputHeight;
+        _stageTimings = stageTimings ?? StageTimings.Disabled;
     }
 
+    // Region tensors are rented from the tensor pool. Regions of the same width bucket share a shape
     [MethodImpl(MethodImplOptions.NoInlining)]
     public List<(float[], int[])> Preprocess(List<BoundingBox> regions, Image<Rgb24> image)
     {
         var result = new List<(float[], int[])>();
         foreach (var region in regions)
         {
-            var modelInput = PreprocessRegion(region, image, _inputHeight, _inputWidth);
-            result.Add((modelInput, [3, _inputHeight, _inputWidth]));
+            var width = InputWidth(region.RotatedRectangle);
+            var modelInput = _tensorPool.Rent(3 * _inputHeight * width);
+            PreprocessRegion(region, image, _inputHeight, width, modelInput);
+            result.Add((modelInput, [3, _inputHeight, width]));
         }
 
         return result;
 
-        static float[] PreprocessRegion(BoundingBox region, Image<Rgb24> image, int height, int width)
+        static void PreprocessRegion(BoundingBox region, Image<Rgb24> image, int height, int width, float[] modelInput)
         {
-            using var textImg = region.RotatedRectangle.Crop(image);
-            textImg.Mutate(x => x
-                .Resize(new ResizeOptions
-                {
-                    Size = new Size(width, height),
-                    Mode = ResizeMode.Pad,
-                    Position = AnchorPositionMode.TopLeft
-                }));
             // Normalize from [0, 255] to [-1, 1]
             Span<float> means = [127.5f, 127.5f, 127.5f];
             Span<float> stds = [127.5f, 127.5f, 127.5f];
-            return textImg.ToNormalizedChwTensor(new Rectangle(0, 0, width, height), means, stds);
+            // Crop, pad-resize and normalize in one pass, straight from the source image
+            region.RotatedRectangle.WarpToNormalizedChwTensor(image, width, height, means, stds, modelInput);
         }
     }
 
+    // Narrowest bucket that holds the region at the input height without squashing it, else the widest bucket
+    internal int InputWidth(RotatedRectangle region)
+    {
+        var scaledWidth = Math.Ceiling(region.Width) * _inputHeight / Math.Ceiling(region.Height);
+        foreach (var width in _inputWidths)
+        {
+            if (scaledWidth <= width)
+                return width;
+        }
+        return _inputWidths[^1];
+    }
+
     [MethodImpl(MethodImplOptions.NoInlining)]
     public List<(string Text, double Confidence)> Postprocess((float[], int[])[] inferenceOutput)
     {
 #if DEBUG
-        if (inferenceOutput.Length > 0)
+        // Time steps vary with the width bucket, the vocabulary doesn't
+        foreach (var (_, shape) in inferenceOutput)
         {
-            var shape = inferenceOutput[0].Item2;
-            Debug.Assert(inferenceOutput.Select(item => item.Item2).All(item => item.SequenceEqual(shape)));
             Debug.Assert(shape.Length == 2);
-            Debug.Assert(shape[1] == _embeddedCharDict.Count);
+            Debug.Assert(shape[1] == _embeddedCharDict.Count || shape[1] == 2);
         }
 #endif
 
+        // Steps are either full distributions or (index, prob) pairs from a FusedArgmax kernel
         return inferenceOutput
-            .Select(item => item.Item1.GreedyCTCDecode(_embeddedCharDict))
+            .Select(item => item.Item2[1] == 2
+                ? item.Item1.GreedyCTCDecodeArgmax(_embeddedCharDict)
+                : item.Item1.GreedyCTCDecode(_embeddedCharDict))
             .Select(item => (item.Text.Trim(), confidence: item.Confidence))
             .ToList();
     }
@@ -92,30 +109,43 @@ public class TextRecognizer
     // Override for testing only
     public virtual async Task<List<(string Text, double Confidence)>> Recognize(List<BoundingBox> regions, Image<Rgb24> image, VizBuilder vizBuilder)
     {
+        var start = _stageTimings.Start();
         var modelInput = Preprocess(regions, image);
+        _stageTimings.Record(PipelineStage.Crop, start);
+
         var inferenceOutput = await RunInference(modelInput);
+        _tensorPool.Return(modelInput.Select(item => item.Item1));
+
+        start = _stageTimings.Start();
         var results = Postprocess(inferenceOutput);
+        _stageTimings.Record(PipelineStage.Ctc, start);
+        _tensorPool.Return(inferenceOutput.Select(item => item.Item1));
 
         // Add text items to visualization
-        var textItems = new List<(string Text, double Confidence, List<(double X, double Y)> ORectangle)>();
-        for (int i = 0; i < results.Count; i++)
+        if (vizBuilder.Enabled)
         {
-            var (text, confidence) = results[i];
-            var rect = regions[i].RotatedRectangle;
-            var corners = rect.Corners().Points.Select(p => (p.X, p.Y)).ToList();
-            textItems.Add((text, confidence, corners));
+            var textItems = new List<(string Text, double Confidence, List<(double X, double Y)> ORectangle)>();
+            for (int i = 0; i < results.Count; i++)
+            {
+                var (text, confidence) = results[i];
+                var rect = regions[i].RotatedRectangle;
+                var corners = rect.Corners().Points.Select(p => (p.X, p.Y)).ToList();
+                textItems.Add((text, confidence, corners));
+            }
+            vizBuilder.AddTextItems(textItems);
         }
-        vizBuilder.AddTextItems(textItems);
 
         return results;
     }
 
     public virtual async Task<(float[], int[])[]> RunInference(List<(float[], int[])> inputs)
     {
-        List<Task<(float[], int[])>> inferenceTasks = [];
-        foreach (var (data, shape) in inputs)
+        // The batcher only batches consecutive requests of the same shape, so submit bucket by bucket
+        var inferenceTasks = new Task<(float[], int[])>[inputs.Count];
+        foreach (var i in Enumerable.Range(0, inputs.Count).OrderBy(i => inputs[i].Item2[^1]))
         {
-            inferenceTasks.Add(_inferenceEngine.Run(data, shape));
+            var (data, shape) = inputs[i];
+            inferenceTasks[i] = _inferenceEngine.Run(data, shape);
         }
         return await Task.WhenAll(inferenceTasks);
     }
@@ -77,6 +77,16 @@ public class VizBuilder
         public MultipleAddException(string message) : base(message) { }
     }
 
+    // Shared by every request that won't be rendered. Nothing is ever stored, so sharing is safe
+    public static readonly VizBuilder Disabled = new(enabled: false);
+
+    public VizBuilder() : this(enabled: true) { }
+
+    private VizBuilder(bool enabled) => Enabled = enabled;
+
+    // When false every Add is a no-op, so callers can also skip building its arguments
+    public bool Enabled { get; }
+
     private Image? _baseImage;
 
     private Image<L8>? _probabilityMap;
@@ -105,6 +115,9 @@ public class VizBuilder
 
     public VizBuilder AddBaseImage(Image image)
     {
+        if (!Enabled)
+            return this;
+
         if (_baseImage != null)
         {
             throw new MultipleAddException($"{nameof(AddBaseImage)} cannot be called twice");
@@ -119,20 +132,28 @@ public class VizBuilder
     // Supports being called from multiple threads. If any call sets displayByDefault=true, it stays true.
     public VizBuilder AddTextItems(List<(string Text, double Confidence, List<(double X, double Y)> ORectangle)> textItems, bool displayByDefault = false)
     {
-        _textItemsData ??= [];
+        if (!Enabled)
+            return this;
+
+        var textItemsData = LazyInitializer.EnsureInitialized(ref _textItemsData);
         foreach (var item in textItems)
-            _textItemsData.Add(item);
-        _displayTextItemsByDefault |= displayByDefault;
+            textItemsData.Add(item);
+        if (displayByDefault)
+            _displayTextItemsByDefault = true;
 
         return this;
     }
 
-    public VizBuilder AddBoundingBoxes(List<BoundingBox> boundingBoxes) => AddAxisAlignedBBoxes(boundingBoxes.Select(bb => bb.AxisAlignedRectangle).ToList())
+    public VizBuilder AddBoundingBoxes(List<BoundingBox> boundingBoxes) => !Enabled ? this :
+        AddAxisAlignedBBoxes(boundingBoxes.Select(bb => bb.AxisAlignedRectangle).ToList())
             .AddOrientedBBoxes(boundingBoxes.Select(bb => bb.RotatedRectangle).ToList(), true)
             .AddPolygonBBoxes(boundingBoxes.Select(bb => bb.Polygon).ToList());
 
     public VizBuilder AddAxisAlignedBBoxes(List<AxisAlignedRectangle> axisAlignedBBoxes, bool displayByDefault = false)
     {
+        if (!Enabled)
+            return this;
+
         if (_axisAlignedBBoxes != null)
         {
             throw new MultipleAddException($"{nameof(AddAxisAlignedBBoxes)} cannot be called twice");
@@ -146,6 +167,9 @@ public class VizBuilder
 
     public VizBuilder AddOrientedBBoxes(List<RotatedRectangle> orientedBBoxes, bool displayByDefault = false)
     {
+        if (!Enabled)
+            return this;
+
         if (_orientedBBoxes != null)
         {
             throw new MultipleAddException($"{nameof(AddOrientedBBoxes)} cannot be called twice");
@@ -159,6 +183,9 @@ public class VizBuilder
 
     public VizBuilder AddExpectedAxisAlignedBBoxes(List<AxisAlignedRectangle> expectedAxisAlignedBBoxes, bool displayByDefault = false)
     {
+        if (!Enabled)
+            return this;
+
         if (_expectedAxisAlignedBBoxes != null)
         {
             throw new MultipleAddException($"{nameof(AddExpectedAxisAlignedBBoxes)} cannot be called twice");
@@ -172,6 +199,9 @@ public class VizBuilder
 
     public VizBuilder AddExpectedOrientedBBoxes(List<RotatedRectangle> expectedOrientedBBoxes, bool displayByDefault = false)
     {
+        if (!Enabled)
+            return this;
+
         if (_expectedOrientedBBoxes != null)
         {
             throw new MultipleAddException($"{nameof(AddExpectedOrientedBBoxes)} cannot be called twice");
@@ -185,6 +215,9 @@ public class VizBuilder
 
     public VizBuilder AddPolygonBBoxes(List<Polygon> polygonBBoxes, bool displayByDefault = false)
     {
+        if (!Enabled)
+            return this;
+
         if (_polygonBBoxes != null)
         {
             throw new MultipleAddException($"{nameof(AddPolygonBBoxes)} cannot be called twice");
@@ -198,6 +231,9 @@ public class VizBuilder
 
     public VizBuilder AddProbabilityMap(Image<L8> probabilityMap, bool displayByDefault = false)
     {
+        if (!Enabled)
+            return this;
+
         if (_probabilityMap != null)
         {
             throw new MultipleAddException($"{nameof(AddProbabilityMap)} cannot be called twice");
@@ -211,6 +247,9 @@ public class VizBuilder
 
     public VizBuilder CreateAndAddProbabilityMap(Span2D<float> probabilityMapSpan, int originalWidth, int originalHeight, bool displayByDefault = false)
     {
+        if (!Enabled)
+            return this;
+
         if (_probabilityMap != null)
         {
             throw new MultipleAddException($"Probability map already exists");
@@ -249,6 +288,8 @@ public class VizBuilder
 
     public Svg RenderSvg()
     {
+        if (!Enabled)
+            throw new InvalidOperationException("Visualization is disabled, enable it with OcrPipelineOptions.Visualize");
         ArgumentNullException.ThrowIfNull(_baseImage);  // base image is required
 
         var template = _template.Value;